@@ -27,7 +27,25 @@ HEADERS += $$PWD/qqmlsortfilterproxymodel.h \
     $$PWD/proxyroles/singlerole.h \
     $$PWD/proxyroles/regexprole.h \
     $$PWD/sorters/filtersorter.h \
-    $$PWD/proxyroles/filterrole.h
+    $$PWD/proxyroles/filterrole.h \
+    $$PWD/filters/fuzzyfilter.h \
+    $$PWD/sorters/fuzzysorter.h \
+    $$PWD/proxyroles/fuzzyscorerole.h \
+    $$PWD/filters/valuesfilter.h \
+    $$PWD/indexes/hashroleindex.h \
+    $$PWD/indexes/orderedroleindex.h \
+    $$PWD/utils/variantcomparator.h \
+    $$PWD/utils/sortkey.h \
+    $$PWD/utils/statistics.h \
+    $$PWD/utils/tracer.h \
+    $$PWD/utils/workloadrecorder.h \
+    $$PWD/utils/plan.h \
+    $$PWD/utils/filterorder.h \
+    $$PWD/utils/rowcache.h \
+    $$PWD/utils/expressioncontext.h \
+    $$PWD/utils/query.h \
+    $$PWD/filters/queryfilter.h \
+    $$PWD/utils/nativeexpression.h
 
 SOURCES += $$PWD/qqmlsortfilterproxymodel.cpp \
     $$PWD/filters/filter.cpp \
@@ -57,4 +75,22 @@ SOURCES += $$PWD/qqmlsortfilterproxymodel.cpp \
     $$PWD/proxyroles/singlerole.cpp \
     $$PWD/proxyroles/regexprole.cpp \
     $$PWD/sorters/filtersorter.cpp \
-    $$PWD/proxyroles/filterrole.cpp
+    $$PWD/proxyroles/filterrole.cpp \
+    $$PWD/filters/fuzzyfilter.cpp \
+    $$PWD/sorters/fuzzysorter.cpp \
+    $$PWD/proxyroles/fuzzyscorerole.cpp \
+    $$PWD/filters/valuesfilter.cpp \
+    $$PWD/indexes/hashroleindex.cpp \
+    $$PWD/indexes/orderedroleindex.cpp \
+    $$PWD/utils/variantcomparator.cpp \
+    $$PWD/utils/sortkey.cpp \
+    $$PWD/utils/statistics.cpp \
+    $$PWD/utils/tracer.cpp \
+    $$PWD/utils/workloadrecorder.cpp \
+    $$PWD/utils/plan.cpp \
+    $$PWD/utils/filterorder.cpp \
+    $$PWD/utils/rowcache.cpp \
+    $$PWD/utils/expressioncontext.cpp \
+    $$PWD/utils/query.cpp \
+    $$PWD/filters/queryfilter.cpp \
+    $$PWD/utils/nativeexpression.cpp
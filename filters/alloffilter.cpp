@@ -18,11 +18,28 @@ namespace qqsfpm {
 bool AllOfFilter::filterRow(const QModelIndex& sourceIndex, const QQmlSortFilterProxyModel& proxyModel) const
 {
     //return true if all filters return false, or if there is no filter.
-    return std::all_of(m_filters.begin(), m_filters.end(),
+    return m_filterOrder.evaluate(m_filters, false,
         [&sourceIndex, &proxyModel] (Filter* filter) {
             return filter->filterAcceptsRow(sourceIndex, proxyModel);
         }
     );
 }
 
+void AllOfFilter::onFilterAppended(Filter* filter)
+{
+    m_filterOrder.reset();
+    connect(filter, &Filter::invalidated, this, &AllOfFilter::invalidate);
+    connect(filter, &Filter::narrowed, this, &AllOfFilter::narrow);
+    connect(filter, &Filter::widened, this, &AllOfFilter::widen);
+    // an additional filter can only reject more rows
+    narrow();
+}
+
+void AllOfFilter::onFilterRemoved(Filter* filter)
+{
+    Q_UNUSED(filter)
+    m_filterOrder.reset();
+    widen();
+}
+
 }
@@ -13,6 +13,8 @@ public:
 
 protected:
     bool filterRow(const QModelIndex& sourceIndex, const QQmlSortFilterProxyModel& proxyModel) const override;
+    void onFilterAppended(Filter* filter) override;
+    void onFilterRemoved(Filter* filter) override;
 };
 
 }
@@ -39,11 +39,29 @@ namespace qqsfpm {
 bool AnyOfFilter::filterRow(const QModelIndex& sourceIndex, const QQmlSortFilterProxyModel& proxyModel) const
 {
     //return true if any of the enabled filters return true
-    return std::any_of(m_filters.begin(), m_filters.end(),
+    return m_filterOrder.evaluate(m_filters, true,
         [&sourceIndex, &proxyModel] (Filter* filter) {
             return filter->enabled() && filter->filterAcceptsRow(sourceIndex, proxyModel);
         }
     );
 }
 
+void AnyOfFilter::onFilterAppended(Filter* filter)
+{
+    m_filterOrder.reset();
+    connect(filter, &Filter::invalidated, this, &AnyOfFilter::invalidate);
+    connect(filter, &Filter::narrowed, this, &AnyOfFilter::narrow);
+    connect(filter, &Filter::widened, this, &AnyOfFilter::widen);
+    // an additional alternative can only accept more rows
+    widen();
+}
+
+void AnyOfFilter::onFilterRemoved(Filter* filter)
+{
+    Q_UNUSED(filter)
+    m_filterOrder.reset();
+    // one less alternative can only accept less rows
+    narrow();
+}
+
 }
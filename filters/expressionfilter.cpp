@@ -1,5 +1,6 @@
 #include "expressionfilter.h"
 #include "qqmlsortfilterproxymodel.h"
+#include "utils/expressioncontext.h"
 #include <QtQml>
 
 namespace qqsfpm {
@@ -28,6 +29,11 @@ namespace qqsfpm {
     This means that if a property is not accessed because of a conditional, it won't be captured and the expression won't be reevaluted when this property changes.
 
     A workaround to this problem is to access all the properties the expressions depends unconditionally at the beggining of the expression.
+
+    Simple expressions, only made of roles (\c model.age or \c age), literals, external properties (like \c root.minimumAge),
+    comparisons, logical and arithmetic operators, are evaluated natively instead of by the JavaScript engine, which is much faster.
+    Their external properties are evaluated with JavaScript once when they change, and the other expressions are evaluated as described above.
+    The rows whose roles used in the expression hold values that JavaScript converts as objects, like dates, are still evaluated with JavaScript.
 */
 const QQmlScriptString& ExpressionFilter::expression() const
 {
@@ -46,6 +52,64 @@ void ExpressionFilter::setExpression(const QQmlScriptString& scriptString)
     invalidate();
 }
 
+/*!
+    \qmlproperty var ExpressionFilter::prepare
+
+    This property holds a value that the \l expression reads as \c prepared when it tests a row.
+
+    The parts of the condition that are the same for every row, like splitting a search text into words, are better computed
+    in a binding on this property than in the expression, which would compute them again for each row tested.
+    The binding is only evaluated again when the properties it depends on change, and the rows are then filtered again.
+
+    \code
+    ExpressionFilter {
+        prepare: searchField.text.toLowerCase().split(" ")
+        expression: prepared.every(function(word) { return model.name.toLowerCase().indexOf(word) !== -1; })
+    }
+    \endcode
+
+    By default, it is \c undefined.
+*/
+const QJSValue& ExpressionFilter::prepare() const
+{
+    return m_prepare;
+}
+
+void ExpressionFilter::setPrepare(const QJSValue& prepare)
+{
+    if (!ExpressionContext::setPrepare(m_prepare, prepare, m_context))
+        return;
+
+    Q_EMIT prepareChanged();
+    invalidate();
+}
+
+/*!
+    \qmlproperty bool ExpressionFilter::pure
+
+    This property holds whether the expression has no side effect, like modifying a property or counting its evaluations.
+
+    The filters of a \l SortFilterProxyModel, an \l AllOf or an \l AnyOf are evaluated in the order measured to be the fastest,
+    the cheapest and most selective ones first. This doesn't change the rows accepted, but it changes which filters are evaluated for a row.
+    An expression that isn't pure is evaluated at its declared position, for the same rows as without reordering,
+    a pure one can be moved after cheaper filters and isn't evaluated for the rows they reject.
+
+    This property is meant to be set once, when the filter is declared. By default, it is \c false.
+*/
+bool ExpressionFilter::pure() const
+{
+    return m_pure;
+}
+
+void ExpressionFilter::setPure(bool pure)
+{
+    if (m_pure == pure)
+        return;
+
+    m_pure = pure;
+    Q_EMIT pureChanged();
+}
+
 void ExpressionFilter::proxyModelCompleted(const QQmlSortFilterProxyModel& proxyModel)
 {
     updateContext(proxyModel);
@@ -53,36 +117,29 @@ void ExpressionFilter::proxyModelCompleted(const QQmlSortFilterProxyModel& proxy
 
 bool ExpressionFilter::filterRow(const QModelIndex& sourceIndex, const QQmlSortFilterProxyModel& proxyModel) const
 {
+    bool accepted;
+    if (m_nativeExpression.isCompiled() && m_nativeExpression.matches(sourceIndex, proxyModel, accepted))
+        return accepted;
     if (!m_scriptString.isEmpty()) {
-        QVariantMap modelMap;
-        QHash<int, QByteArray> roles = proxyModel.roleNames();
-
-        QQmlContext context(qmlContext(this));
-        auto addToContext = [&] (const QString &name, const QVariant& value) {
-            context.setContextProperty(name, value);
-            modelMap.insert(name, value);
-        };
-
-        for (auto it = roles.cbegin(); it != roles.cend(); ++it)
-            addToContext(it.value(), proxyModel.sourceData(sourceIndex, it.key()));
-        addToContext("index", sourceIndex.row());
+        ExpressionContext* context = proxyModel.expressionContext(qmlContext(this));
+        // the expression is created first, the context binds the roles it names
+        QQmlExpression* expression = context->expression(this, m_scriptString);
+        context->bindRow(sourceIndex, proxyModel);
+        context->setPrepared(m_prepare);
 
-        context.setContextProperty("model", modelMap);
+        QVariant variantResult = expression->evaluate();
 
-        QQmlExpression expression(m_scriptString, &context);
-        QVariant variantResult = expression.evaluate();
-
-        if (expression.hasError()) {
-            qWarning() << expression.error();
+        if (expression->hasError()) {
+            qWarning() << expression->error();
             return true;
         }
         if (variantResult.canConvert<bool>()) {
             return variantResult.toBool();
         } else {
             qWarning("%s:%i:%i : Can't convert result to bool",
-                     expression.sourceFile().toUtf8().data(),
-                     expression.lineNumber(),
-                     expression.columnNumber());
+                     expression->sourceFile().toUtf8().data(),
+                     expression->lineNumber(),
+                     expression->columnNumber());
             return true;
         }
     }
@@ -93,7 +150,6 @@ void ExpressionFilter::updateContext(const QQmlSortFilterProxyModel& proxyModel)
 {
     delete m_context;
     m_context = new QQmlContext(qmlContext(this), this);
-    // what about roles changes ?
     QVariantMap modelMap;
 
     auto addToContext = [&] (const QString &name, const QVariant& value) {
@@ -101,8 +157,12 @@ void ExpressionFilter::updateContext(const QQmlSortFilterProxyModel& proxyModel)
         modelMap.insert(name, value);
     };
 
-    for (const QByteArray& roleName : proxyModel.roleNames().values())
+    QStringList roleNames;
+    for (const QByteArray& roleName : proxyModel.roleNames().values()) {
         addToContext(roleName, QVariant());
+        roleNames.append(QString::fromUtf8(roleName));
+    }
+    m_nativeExpression.setRoleNames(roleNames);
 
     addToContext("index", -1);
 
@@ -115,11 +175,27 @@ void ExpressionFilter::updateExpression()
     if (!m_context)
         return;
 
+    ExpressionContext::bindPrepared(m_context, m_prepare);
     delete m_expression;
     m_expression = new QQmlExpression(m_scriptString, m_context, 0, this);
+    // a native expression tracks the external properties it depends on itself
+    if (m_nativeExpression.compile(m_expression->expression(), this, [this] { invalidate(); }))
+        return;
+
     connect(m_expression, &QQmlExpression::valueChanged, this, &ExpressionFilter::invalidate);
     m_expression->setNotifyOnValueChanged(true);
     m_expression->evaluate();
 }
 
+CostClass ExpressionFilter::costClass() const
+{
+    return m_nativeExpression.isCompiled() ? CostClass::Role : CostClass::Script;
+}
+
+// a native expression has no side effect
+bool ExpressionFilter::isPure() const
+{
+    return m_pure || m_nativeExpression.isCompiled();
+}
+
 }
@@ -3,6 +3,8 @@
 
 #include "filter.h"
 #include <QQmlScriptString>
+#include <QJSValue>
+#include "utils/nativeexpression.h"
 
 class QQmlExpression;
 
@@ -12,13 +14,24 @@ class ExpressionFilter : public Filter
 {
     Q_OBJECT
     Q_PROPERTY(QQmlScriptString expression READ expression WRITE setExpression NOTIFY expressionChanged)
+    Q_PROPERTY(QJSValue prepare READ prepare WRITE setPrepare NOTIFY prepareChanged)
+    Q_PROPERTY(bool pure READ pure WRITE setPure NOTIFY pureChanged)
 
 public:
     using Filter::Filter;
 
+    CostClass costClass() const override;
+    bool isPure() const override;
+
     const QQmlScriptString& expression() const;
     void setExpression(const QQmlScriptString& scriptString);
 
+    const QJSValue& prepare() const;
+    void setPrepare(const QJSValue& prepare);
+
+    bool pure() const;
+    void setPure(bool pure);
+
     void proxyModelCompleted(const QQmlSortFilterProxyModel& proxyModel) override;
 
 protected:
@@ -26,14 +39,19 @@ protected:
 
 Q_SIGNALS:
     void expressionChanged();
+    void prepareChanged();
+    void pureChanged();
 
 private:
     void updateContext(const QQmlSortFilterProxyModel& proxyModel);
     void updateExpression();
 
     QQmlScriptString m_scriptString;
+    QJSValue m_prepare;
     QQmlExpression* m_expression = nullptr;
     QQmlContext* m_context = nullptr;
+    NativeExpression m_nativeExpression;
+    bool m_pure = false;
 };
 
 }
@@ -1,5 +1,8 @@
 #include "filter.h"
 #include "qqmlsortfilterproxymodel.h"
+#include <QVariant>
+#include <QBitArray>
+#include <QElapsedTimer>
 
 namespace qqsfpm {
 
@@ -68,18 +71,160 @@ void Filter::setInverted(bool inverted)
 
 bool Filter::filterAcceptsRow(const QModelIndex &sourceIndex, const QQmlSortFilterProxyModel& proxyModel) const
 {
+    if (Q_UNLIKELY(proxyModel.planAnalysis()))
+        return analyzeRow(sourceIndex, proxyModel);
     return !m_enabled || filterRow(sourceIndex, proxyModel) ^ m_inverted;
 }
 
+/*
+    Returns a value identifying the current configuration of the filter,
+    two filters with the same cache key accept the same rows of a given model.
+    An invalid QVariant is returned when the filter's results can't be identified (see filterState()).
+*/
+QVariant Filter::cacheKey() const
+{
+    QVariant state = filterState();
+    if (!state.isValid())
+        return QVariant();
+    return QVariantList { metaObject()->className(), m_enabled, m_inverted, state };
+}
+
+/*
+    Sets the bits of the top level source rows accepted by the filter in rows, without testing every row.
+    Returns false if the filter can't do that (see filterSourceRows()) or if it accepts every row.
+*/
+bool Filter::acceptedSourceRows(const QQmlSortFilterProxyModel& proxyModel, QBitArray& rows) const
+{
+    if (!m_enabled || !filterSourceRows(proxyModel, rows))
+        return false;
+    if (m_inverted)
+        rows = ~rows;
+    return true;
+}
+
+/*
+    Returns true if shifting the top level source rows from firstShiftedRow onward,
+    by inserting or removing rows, can change which of the other rows the filter accepts.
+*/
+bool Filter::dependsOnRowPositions(int firstShiftedRow) const
+{
+    return m_enabled && filterDependsOnRowPositions(firstShiftedRow);
+}
+
+/*
+    Describes how the filter is evaluated, for SortFilterProxyModel::explain().
+    With an analysis, the description also holds the rows the filter was tested for, those it accepted,
+    and the time and source data() calls it took.
+*/
+QVariantMap Filter::explain(const QQmlSortFilterProxyModel& proxyModel, const PlanAnalysis* analysis) const
+{
+    QVariantMap plan {
+        {QStringLiteral("type"), Plan::qmlTypeName(this)},
+        {QStringLiteral("objectName"), objectName()},
+        {QStringLiteral("enabled"), m_enabled},
+        {QStringLiteral("inverted"), m_inverted},
+        {QStringLiteral("cost"), Plan::costClassName(costClass())},
+        {QStringLiteral("access"), QStringLiteral("rowScan")},
+        {QStringLiteral("cached"), filterState().isValid()}
+    };
+    explainFilter(plan, proxyModel, analysis);
+    if (analysis)
+        analysis->annotate(plan, this, QStringLiteral("rowsIn"), true);
+    return plan;
+}
+
+// the estimated cost of testing a row, most filters compare a role value
+CostClass Filter::costClass() const
+{
+    return CostClass::Role;
+}
+
+/*
+    Returns true if testing a row has no effect besides its result.
+    The containers evaluate their pure filters in the order measured to be the fastest, see FilterOrder.
+*/
+bool Filter::isPure() const
+{
+    return true;
+}
+
+// called when the proxy model is completed, and again when its role names change
 void Filter::proxyModelCompleted(const QQmlSortFilterProxyModel& proxyModel)
 {
     Q_UNUSED(proxyModel)
 }
 
+QVariant Filter::filterState() const
+{
+    return QVariant();
+}
+
+bool Filter::filterSourceRows(const QQmlSortFilterProxyModel& proxyModel, QBitArray& rows) const
+{
+    Q_UNUSED(proxyModel)
+    Q_UNUSED(rows)
+    return false;
+}
+
+bool Filter::filterDependsOnRowPositions(int firstShiftedRow) const
+{
+    Q_UNUSED(firstShiftedRow)
+    return false;
+}
+
+// adds the specifics of a filter to its explain() description, like the role it reads or its child filters
+void Filter::explainFilter(QVariantMap& plan, const QQmlSortFilterProxyModel& proxyModel, const PlanAnalysis* analysis) const
+{
+    Q_UNUSED(plan)
+    Q_UNUSED(proxyModel)
+    Q_UNUSED(analysis)
+}
+
 void Filter::invalidate()
 {
     if (m_enabled)
         Q_EMIT invalidated();
 }
 
+/*
+    To be called instead of invalidate() when the new state of the filter can only reject rows that were accepted before.
+    The proxy model then only needs to test again the rows it currently accepts.
+*/
+void Filter::narrow()
+{
+    if (!m_enabled)
+        return;
+
+    if (m_inverted)
+        Q_EMIT widened();
+    else
+        Q_EMIT narrowed();
+}
+
+/*
+    To be called instead of invalidate() when the new state of the filter can only accept rows that were rejected before.
+    The proxy model then only needs to test again the rows it currently rejects.
+*/
+void Filter::widen()
+{
+    if (!m_enabled)
+        return;
+
+    if (m_inverted)
+        Q_EMIT narrowed();
+    else
+        Q_EMIT widened();
+}
+
+bool Filter::analyzeRow(const QModelIndex& sourceIndex, const QQmlSortFilterProxyModel& proxyModel) const
+{
+    PlanAnalysis* analysis = proxyModel.planAnalysis();
+    const qint64 dataCalls = analysis->dataCalls;
+    QElapsedTimer timer;
+    timer.start();
+    bool accepted = !m_enabled || filterRow(sourceIndex, proxyModel) ^ m_inverted;
+    analysis->record(this, accepted, timer.nsecsElapsed(), analysis->dataCalls - dataCalls);
+    return accepted;
+}
+
 }
@@ -2,6 +2,9 @@
 #define FILTER_H
 
 #include <QObject>
+#include "utils/plan.h"
+
+class QBitArray;
 
 namespace qqsfpm {
 
@@ -24,6 +27,12 @@ public:
     void setInverted(bool inverted);
 
     bool filterAcceptsRow(const QModelIndex &sourceIndex, const QQmlSortFilterProxyModel& proxyModel) const;
+    QVariant cacheKey() const;
+    bool acceptedSourceRows(const QQmlSortFilterProxyModel& proxyModel, QBitArray& rows) const;
+    bool dependsOnRowPositions(int firstShiftedRow) const;
+    QVariantMap explain(const QQmlSortFilterProxyModel& proxyModel, const PlanAnalysis* analysis) const;
+    virtual CostClass costClass() const;
+    virtual bool isPure() const;
 
     virtual void proxyModelCompleted(const QQmlSortFilterProxyModel& proxyModel);
 
@@ -31,12 +40,22 @@ Q_SIGNALS:
     void enabledChanged();
     void invertedChanged();
     void invalidated();
+    void narrowed();
+    void widened();
 
 protected:
     virtual bool filterRow(const QModelIndex &sourceIndex, const QQmlSortFilterProxyModel& proxyModel) const = 0;
+    virtual QVariant filterState() const;
+    virtual bool filterSourceRows(const QQmlSortFilterProxyModel& proxyModel, QBitArray& rows) const;
+    virtual bool filterDependsOnRowPositions(int firstShiftedRow) const;
+    virtual void explainFilter(QVariantMap& plan, const QQmlSortFilterProxyModel& proxyModel, const PlanAnalysis* analysis) const;
     void invalidate();
+    void narrow();
+    void widen();
 
 private:
+    bool analyzeRow(const QModelIndex &sourceIndex, const QQmlSortFilterProxyModel& proxyModel) const;
+
     bool m_enabled = true;
     bool m_inverted = false;
 };
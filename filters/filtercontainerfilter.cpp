@@ -1,4 +1,6 @@
 #include "filtercontainerfilter.h"
+#include <QVariant>
+#include <algorithm>
 
 namespace qqsfpm {
 
@@ -8,21 +10,69 @@ void FilterContainerFilter::proxyModelCompleted(const QQmlSortFilterProxyModel&
         filter->proxyModelCompleted(proxyModel);
 }
 
+QVariant FilterContainerFilter::filterState() const
+{
+    QVariantList state;
+    for (Filter* filter : m_filters) {
+        QVariant key = filter->cacheKey();
+        if (!key.isValid())
+            return QVariant();
+        state.append(key);
+    }
+    return state;
+}
+
+bool FilterContainerFilter::filterDependsOnRowPositions(int firstShiftedRow) const
+{
+    return std::any_of(m_filters.begin(), m_filters.end(),
+        [=] (Filter* filter) {
+            return filter->dependsOnRowPositions(firstShiftedRow);
+        }
+    );
+}
+
 void FilterContainerFilter::onFilterAppended(Filter* filter)
 {
+    m_filterOrder.reset();
     connect(filter, &Filter::invalidated, this, &FilterContainerFilter::invalidate);
+    // both AllOf and AnyOf accept less rows when one of their child filters does, and more when it accepts more
+    connect(filter, &Filter::narrowed, this, &FilterContainerFilter::narrow);
+    connect(filter, &Filter::widened, this, &FilterContainerFilter::widen);
     invalidate();
 }
 
 void FilterContainerFilter::onFilterRemoved(Filter* filter)
 {
     Q_UNUSED(filter)
+    m_filterOrder.reset();
     invalidate();
 }
 
 void qqsfpm::FilterContainerFilter::onFiltersCleared()
 {
+    m_filterOrder.reset();
     invalidate();
 }
 
+// a container costs as much as its most expensive child filter
+CostClass FilterContainerFilter::costClass() const
+{
+    return Plan::filtersCostClass(m_filters);
+}
+
+bool FilterContainerFilter::isPure() const
+{
+    return std::all_of(m_filters.begin(), m_filters.end(),
+        [] (Filter* filter) {
+            return filter->isPure();
+        }
+    );
+}
+
+// the child filters are tested in their evaluation order until one decides the result: a rejecting one for AllOf, an accepting one for AnyOf
+void FilterContainerFilter::explainFilter(QVariantMap& plan, const QQmlSortFilterProxyModel& proxyModel, const PlanAnalysis* analysis) const
+{
+    plan.insert(QStringLiteral("filters"), Plan::explainFilters(m_filters, proxyModel, analysis, m_filterOrder.order(m_filters.size())));
+}
+
 }
@@ -3,6 +3,7 @@
 
 #include "filter.h"
 #include "filtercontainer.h"
+#include "utils/filterorder.h"
 
 namespace qqsfpm {
 
@@ -16,14 +17,22 @@ public:
     using Filter::Filter;
 
     void proxyModelCompleted(const QQmlSortFilterProxyModel& proxyModel) override;
+    CostClass costClass() const override;
+    bool isPure() const override;
 
 Q_SIGNALS:
     void filtersChanged();
 
-private:
+protected:
+    QVariant filterState() const override;
+    bool filterDependsOnRowPositions(int firstShiftedRow) const override;
+    void explainFilter(QVariantMap& plan, const QQmlSortFilterProxyModel& proxyModel, const PlanAnalysis* analysis) const override;
+
     void onFilterAppended(Filter* filter) override;
     void onFilterRemoved(Filter* filter) override;
     void onFiltersCleared() override;
+
+    mutable FilterOrder m_filterOrder;
 };
 
 }
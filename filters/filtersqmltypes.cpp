@@ -1,11 +1,14 @@
 #include "filter.h"
 #include "valuefilter.h"
+#include "valuesfilter.h"
 #include "indexfilter.h"
 #include "regexpfilter.h"
 #include "rangefilter.h"
 #include "expressionfilter.h"
 #include "anyoffilter.h"
 #include "alloffilter.h"
+#include "fuzzyfilter.h"
+#include "queryfilter.h"
 #include <QQmlEngine>
 #include <QCoreApplication>
 
@@ -14,12 +17,15 @@ namespace qqsfpm {
 void registerFiltersTypes() {
     qmlRegisterUncreatableType<Filter>("SortFilterProxyModel", 0, 2, "Filter", "Filter is an abstract class");
     qmlRegisterType<ValueFilter>("SortFilterProxyModel", 0, 2, "ValueFilter");
+    qmlRegisterType<ValuesFilter>("SortFilterProxyModel", 0, 2, "ValuesFilter");
     qmlRegisterType<IndexFilter>("SortFilterProxyModel", 0, 2, "IndexFilter");
     qmlRegisterType<RegExpFilter>("SortFilterProxyModel", 0, 2, "RegExpFilter");
     qmlRegisterType<RangeFilter>("SortFilterProxyModel", 0, 2, "RangeFilter");
     qmlRegisterType<ExpressionFilter>("SortFilterProxyModel", 0, 2, "ExpressionFilter");
     qmlRegisterType<AnyOfFilter>("SortFilterProxyModel", 0, 2, "AnyOf");
     qmlRegisterType<AllOfFilter>("SortFilterProxyModel", 0, 2, "AllOf");
+    qmlRegisterType<FuzzyFilter>("SortFilterProxyModel", 0, 2, "FuzzyFilter");
+    qmlRegisterType<QueryFilter>("SortFilterProxyModel", 0, 2, "QueryFilter");
     qmlRegisterUncreatableType<FilterContainerAttached>("SortFilterProxyModel", 0, 2, "FilterContainer", "FilterContainer can only be used as an attaching type");
 }
 
@@ -0,0 +1,234 @@
+#include "fuzzyfilter.h"
+#include <QVariant>
+
+namespace qqsfpm {
+
+namespace {
+
+const int MatchScore = 16;
+const int BoundaryBonus = 8;
+const int CamelCaseBonus = 7;
+const int ConsecutiveBonus = 4;
+const int FirstCharBonusMultiplier = 2;
+const int GapStartPenalty = 3;
+const int GapExtensionPenalty = 1;
+// the scores are cached by text, the cache is dropped when it grows past this size
+const int MaxCachedScores = 4096;
+
+int boundaryBonus(QChar previous, QChar current)
+{
+    if (previous.isNull())
+        return BoundaryBonus;
+    if (!previous.isLetterOrNumber() && current.isLetterOrNumber())
+        return BoundaryBonus;
+    if (previous.isLower() && current.isUpper())
+        return CamelCaseBonus;
+    if (!previous.isDigit() && current.isDigit())
+        return CamelCaseBonus;
+    return 0;
+}
+
+bool isSubsequence(const QString& subsequence, const QString& string)
+{
+    int index = 0;
+    for (QChar c : string) {
+        if (index == subsequence.size())
+            break;
+        if (c == subsequence.at(index))
+            ++index;
+    }
+    return index == subsequence.size();
+}
+
+}
+
+/*!
+    \qmltype FuzzyFilter
+    \inherits RoleFilter
+    \inqmlmodule SortFilterProxyModel
+    \ingroup Filters
+    \brief Filters rows fuzzily matching a pattern and scores them.
+
+    A FuzzyFilter is a \l RoleFilter that accepts rows containing all the characters of its \l pattern, in order but not necessarily contiguous,
+    like the "fuzzy find" feature of code editors.
+
+    While matching a row, the filter also computes a relevance score for it: consecutive characters,
+    characters at the start of a word or at a camelCase transition raise the score, gaps between matched characters lower it.
+    The score is computed once per row and cached, it can then be exposed with a \l FuzzyScoreRole and used for sorting with a \l FuzzySorter.
+
+    In the following example, the rows with their \c name role fuzzily matching the content of the text field will be accepted and the best matches will be shown first:
+    \code
+    TextField {
+       id: searchField
+    }
+
+    SortFilterProxyModel {
+       sourceModel: fileModel
+       filters: FuzzyFilter {
+           id: fuzzyFilter
+           roleName: "name"
+           pattern: searchField.text
+       }
+       sorters: FuzzySorter { filter: fuzzyFilter }
+       proxyRoles: FuzzyScoreRole { name: "score"; filter: fuzzyFilter }
+    }
+    \endcode
+*/
+
+/*!
+    \qmlproperty string FuzzyFilter::pattern
+
+    The pattern used to filter the contents of the source model.
+    A row is accepted if all the characters of the pattern appear in its \l RoleFilter::roleName data in the same order.
+
+    If the pattern is empty, every row is accepted with a score of \c 0.
+*/
+const QString& FuzzyFilter::pattern() const
+{
+    return m_pattern;
+}
+
+void FuzzyFilter::setPattern(const QString& pattern)
+{
+    if (m_pattern == pattern)
+        return;
+
+    QString previousMatchPattern = m_matchPattern;
+    m_pattern = pattern;
+    updateMatchPattern();
+    Q_EMIT patternChanged();
+    // rows matching the new pattern also match any of its subsequences
+    if (isSubsequence(previousMatchPattern, m_matchPattern))
+        narrow();
+    else
+        invalidate();
+}
+
+/*!
+    \qmlproperty Qt::CaseSensitivity FuzzyFilter::caseSensitivity
+
+    This property holds the caseSensitivity of the filter.
+
+    By default, the matching is case insensitive.
+*/
+Qt::CaseSensitivity FuzzyFilter::caseSensitivity() const
+{
+    return m_caseSensitivity;
+}
+
+void FuzzyFilter::setCaseSensitivity(Qt::CaseSensitivity caseSensitivity)
+{
+    if (m_caseSensitivity == caseSensitivity)
+        return;
+
+    m_caseSensitivity = caseSensitivity;
+    updateMatchPattern();
+    Q_EMIT caseSensitivityChanged();
+    if (caseSensitivity == Qt::CaseSensitive)
+        narrow();
+    else
+        invalidate();
+}
+
+// returns -1 if the row doesn't match, scores of matching rows are cached
+int FuzzyFilter::score(const QModelIndex& sourceIndex, const QQmlSortFilterProxyModel& proxyModel) const
+{
+    if (m_matchPattern.isEmpty())
+        return 0;
+
+    QString text = sourceData(sourceIndex, proxyModel).toString();
+    auto it = m_scores.constFind(text);
+    if (it != m_scores.constEnd())
+        return it.value();
+
+    int score = computeScore(text);
+    if (score >= 0) {
+        if (m_scores.size() >= MaxCachedScores)
+            m_scores.clear();
+        m_scores.insert(text, score);
+    }
+    return score;
+}
+
+bool FuzzyFilter::filterRow(const QModelIndex& sourceIndex, const QQmlSortFilterProxyModel& proxyModel) const
+{
+    return score(sourceIndex, proxyModel) >= 0;
+}
+
+QVariant FuzzyFilter::filterState() const
+{
+    return QVariantList { roleName(), m_pattern, m_caseSensitivity };
+}
+
+void FuzzyFilter::updateMatchPattern()
+{
+    m_matchPattern = m_caseSensitivity == Qt::CaseInsensitive ? m_pattern.toCaseFolded() : m_pattern;
+    m_scores.clear();
+}
+
+int FuzzyFilter::computeScore(const QString& text) const
+{
+    const int patternLength = m_matchPattern.size();
+    const int length = text.size();
+    if (length < patternLength)
+        return -1;
+
+    const QChar* pattern = m_matchPattern.constData();
+    const QChar* data = text.constData();
+    const bool caseInsensitive = m_caseSensitivity == Qt::CaseInsensitive;
+    auto charAt = [=] (int i) {
+        return caseInsensitive ? data[i].toCaseFolded() : data[i];
+    };
+
+    // forward pass: find where the first complete match ends
+    int patternIndex = 0;
+    int end = -1;
+    for (int i = 0; i < length; ++i) {
+        if (charAt(i) == pattern[patternIndex] && ++patternIndex == patternLength) {
+            end = i;
+            break;
+        }
+    }
+    if (end == -1)
+        return -1;
+
+    // backward pass: find the tightest match ending there
+    patternIndex = patternLength - 1;
+    int start = end;
+    for (int i = end; i >= 0; --i) {
+        if (charAt(i) == pattern[patternIndex] && --patternIndex < 0) {
+            start = i;
+            break;
+        }
+    }
+
+    int score = 0;
+    int consecutive = 0;
+    bool inGap = false;
+    patternIndex = 0;
+    for (int i = start; i <= end; ++i) {
+        if (patternIndex < patternLength && charAt(i) == pattern[patternIndex]) {
+            int bonus = boundaryBonus(i > 0 ? data[i - 1] : QChar(), data[i]);
+            if (consecutive > 0)
+                bonus = qMax(bonus, ConsecutiveBonus);
+            if (patternIndex == 0)
+                bonus *= FirstCharBonusMultiplier;
+            score += MatchScore + bonus;
+            ++consecutive;
+            ++patternIndex;
+            inGap = false;
+        } else {
+            score -= inGap ? GapExtensionPenalty : GapStartPenalty;
+            consecutive = 0;
+            inGap = true;
+        }
+    }
+    return qMax(score, 0);
+}
+
+CostClass FuzzyFilter::costClass() const
+{
+    return CostClass::Text;
+}
+
+}
@@ -0,0 +1,48 @@
+#ifndef FUZZYFILTER_H
+#define FUZZYFILTER_H
+
+#include "rolefilter.h"
+#include <QHash>
+
+namespace qqsfpm {
+
+class FuzzyFilter : public RoleFilter
+{
+    Q_OBJECT
+    Q_PROPERTY(QString pattern READ pattern WRITE setPattern NOTIFY patternChanged)
+    Q_PROPERTY(Qt::CaseSensitivity caseSensitivity READ caseSensitivity WRITE setCaseSensitivity NOTIFY caseSensitivityChanged)
+
+public:
+    using RoleFilter::RoleFilter;
+
+    CostClass costClass() const override;
+
+    const QString& pattern() const;
+    void setPattern(const QString& pattern);
+
+    Qt::CaseSensitivity caseSensitivity() const;
+    void setCaseSensitivity(Qt::CaseSensitivity caseSensitivity);
+
+    int score(const QModelIndex& sourceIndex, const QQmlSortFilterProxyModel& proxyModel) const;
+
+protected:
+    bool filterRow(const QModelIndex& sourceIndex, const QQmlSortFilterProxyModel& proxyModel) const override;
+    QVariant filterState() const override;
+
+Q_SIGNALS:
+    void patternChanged();
+    void caseSensitivityChanged();
+
+private:
+    void updateMatchPattern();
+    int computeScore(const QString& text) const;
+
+    QString m_pattern;
+    Qt::CaseSensitivity m_caseSensitivity = Qt::CaseInsensitive;
+    QString m_matchPattern;
+    mutable QHash<QString, int> m_scores;
+};
+
+}
+
+#endif // FUZZYFILTER_H
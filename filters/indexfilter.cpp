@@ -1,8 +1,31 @@
 #include "indexfilter.h"
 #include "qqmlsortfilterproxymodel.h"
+#include <QBitArray>
 
 namespace qqsfpm {
 
+namespace {
+
+// only bounds of the same sign can be compared without knowing the source row count
+bool isNarrowerBound(const QVariant& oldBound, const QVariant& newBound, bool isMinimum)
+{
+    bool newIsValid;
+    int newValue = newBound.toInt(&newIsValid);
+    if (!newIsValid)
+        return false;
+
+    bool oldIsValid;
+    int oldValue = oldBound.toInt(&oldIsValid);
+    if (!oldIsValid)
+        return true;
+
+    if ((oldValue < 0) != (newValue < 0))
+        return false;
+    return isMinimum ? newValue > oldValue : newValue < oldValue;
+}
+
+}
+
 /*!
     \qmltype IndexFilter
     \inherits Filter
@@ -49,9 +72,13 @@ void IndexFilter::setMinimumIndex(const QVariant& minimumIndex)
     if (m_minimumIndex == minimumIndex)
         return;
 
+    bool narrowing = isNarrowerBound(m_minimumIndex, minimumIndex, true);
     m_minimumIndex = minimumIndex;
     Q_EMIT minimumIndexChanged();
-    invalidate();
+    if (narrowing)
+        narrow();
+    else
+        invalidate();
 }
 
 /*!
@@ -80,9 +107,13 @@ void IndexFilter::setMaximumIndex(const QVariant& maximumIndex)
     if (m_maximumIndex == maximumIndex)
         return;
 
+    bool narrowing = isNarrowerBound(m_maximumIndex, maximumIndex, false);
     m_maximumIndex = maximumIndex;
     Q_EMIT maximumIndexChanged();
-    invalidate();
+    if (narrowing)
+        narrow();
+    else
+        invalidate();
 }
 
 bool IndexFilter::filterRow(const QModelIndex& sourceIndex, const QQmlSortFilterProxyModel& proxyModel) const
@@ -109,4 +140,57 @@ bool IndexFilter::filterRow(const QModelIndex& sourceIndex, const QQmlSortFilter
     return true;
 }
 
+QVariant IndexFilter::filterState() const
+{
+    return QVariantList { m_minimumIndex, m_maximumIndex };
+}
+
+// the accepted top level rows are a single slice of the source model, computed once instead of per row
+bool IndexFilter::filterSourceRows(const QQmlSortFilterProxyModel& proxyModel, QBitArray& rows) const
+{
+    const int sourceRowCount = proxyModel.sourceModel()->rowCount();
+    int first, last;
+    sourceRange(sourceRowCount, first, last);
+    rows.fill(false, sourceRowCount);
+    if (first <= last)
+        rows.fill(true, first, last + 1);
+    return true;
+}
+
+bool IndexFilter::filterDependsOnRowPositions(int firstShiftedRow) const
+{
+    bool minimumIsValid;
+    int minimum = m_minimumIndex.toInt(&minimumIsValid);
+    bool maximumIsValid;
+    int maximum = m_maximumIndex.toInt(&maximumIsValid);
+
+    // bounds counted from the end move with every inserted or removed row
+    if ((minimumIsValid && minimum < 0) || (maximumIsValid && maximum < 0))
+        return true;
+    // otherwise only rows shifted across a bound enter or leave the slice
+    return (minimumIsValid && firstShiftedRow < minimum) || (maximumIsValid && firstShiftedRow <= maximum);
+}
+
+// first and last are included, the slice is empty if first > last
+void IndexFilter::sourceRange(int sourceRowCount, int& first, int& last) const
+{
+    first = 0;
+    last = sourceRowCount - 1;
+
+    bool minimumIsValid;
+    int minimum = m_minimumIndex.toInt(&minimumIsValid);
+    if (minimumIsValid)
+        first = qMax(first, minimum < 0 ? sourceRowCount + minimum : minimum);
+
+    bool maximumIsValid;
+    int maximum = m_maximumIndex.toInt(&maximumIsValid);
+    if (maximumIsValid)
+        last = qMin(last, maximum < 0 ? sourceRowCount + maximum : maximum);
+}
+
+CostClass IndexFilter::costClass() const
+{
+    return CostClass::Constant;
+}
+
 }
@@ -14,6 +14,8 @@ class IndexFilter: public Filter {
 public:
     using Filter::Filter;
 
+    CostClass costClass() const override;
+
     const QVariant& minimumIndex() const;
     void setMinimumIndex(const QVariant& minimumIndex);
 
@@ -22,12 +24,17 @@ public:
 
 protected:
     bool filterRow(const QModelIndex& sourceIndex, const QQmlSortFilterProxyModel& proxyModel) const override;
+    QVariant filterState() const override;
+    bool filterSourceRows(const QQmlSortFilterProxyModel& proxyModel, QBitArray& rows) const override;
+    bool filterDependsOnRowPositions(int firstShiftedRow) const override;
 
 Q_SIGNALS:
     void minimumIndexChanged();
     void maximumIndexChanged();
 
 private:
+    void sourceRange(int sourceRowCount, int& first, int& last) const;
+
     QVariant m_minimumIndex;
     QVariant m_maximumIndex;
 };
@@ -0,0 +1,213 @@
+#include "queryfilter.h"
+#include "qqmlsortfilterproxymodel.h"
+#include <QBitArray>
+#include <QQmlProperty>
+#include <QDebug>
+
+namespace qqsfpm {
+
+/*!
+    \qmltype QueryFilter
+    \inherits Filter
+    \inqmlmodule SortFilterProxyModel
+    \ingroup Filters
+    \brief Filters rows with a condition on their roles, evaluated natively.
+
+    A QueryFilter is a \l Filter accepting the rows matching its \l query, a boolean condition on the roles of the rows
+    written in a small expression language. Unlike the expression of an \l ExpressionFilter, the query isn't JavaScript:
+    it is parsed once when it is set and evaluated in C++ for each row, which is much faster.
+
+    The query can use the following:
+    \list
+    \li role names, like \c age, evaluating to the data of the row for that role,
+    \li parameters, like \c $minimumAge, evaluating to the value of the property with the same name declared on the filter,
+    \li numbers, strings between single or double quotes, \c true, \c false, \c null, and lists like \c {["FR", "BE"]},
+    \li the comparisons \c ==, \c !=, \c <, \c <=, \c >, \c >= (\c === and \c !== are accepted as aliases),
+    \li \c {value in list}, true if the list holds the value,
+    \li \c {text contains part}, \c {text startsWith prefix} and \c {text endsWith suffix}, matching strings with the filter's \l caseSensitivity
+        (\c contains also tests if a list holds a value),
+    \li the logical operators \c &&, \c || and \c !,
+    \li the arithmetic operators \c +, \c -, \c *, \c / and \c %, \c + also concatenating strings,
+    \li parentheses.
+    \endlist
+
+    Before the filter tests its rows, the query is checked against the roles of the proxy model and the types of its constants and parameters:
+    unknown roles, or operators applied to values of the wrong types (like ordering booleans or comparing a number with a string), are reported as warnings.
+    An invalid query accepts every row, like an empty one.
+    The types of the data of the roles are only known for each row: a row whose data has the wrong type for an operator isn't accepted,
+    the first one being reported as a warning.
+
+    When a parameter property changes, the rows are filtered again.
+    If the roles compared to a constant or a parameter are listed in the \l {SortFilterProxyModel::indexedRoleNames} {indexedRoleNames}
+    (for \c == and \c in) or the \l {SortFilterProxyModel::orderedIndexedRoleNames} {orderedIndexedRoleNames} (for the other comparisons and \c startsWith)
+    of the proxy model, only the rows found in their indexes are tested.
+
+    In the following example, only the adult contacts living in France or Belgium and whose name contains the text of the text field will be accepted :
+    \code
+    TextField {
+       id: searchField
+    }
+
+    SortFilterProxyModel {
+       sourceModel: contactModel
+       filters: QueryFilter {
+           property string search: searchField.text
+           query: "age >= 18 && country in ['FR', 'BE'] && name contains $search"
+           caseSensitivity: Qt.CaseInsensitive
+       }
+    }
+    \endcode
+*/
+
+/*!
+    \qmlproperty string QueryFilter::query
+
+    This property holds the condition that the rows accepted by the filter match.
+
+    By default, the query is empty and every row is accepted.
+*/
+const QString& QueryFilter::query() const
+{
+    return m_queryString;
+}
+
+void QueryFilter::setQuery(const QString& query)
+{
+    if (m_queryString == query)
+        return;
+
+    m_queryString = query;
+    m_parsed = m_query.parse(query);
+    if (!m_parsed)
+        qWarning().noquote() << "QueryFilter:" << m_query.errorString();
+    bindParameters();
+    m_checked = false;
+    Q_EMIT queryChanged();
+    invalidate();
+}
+
+/*!
+    \qmlproperty Qt::CaseSensitivity QueryFilter::caseSensitivity
+
+    This property holds the case sensitivity of the \c contains, \c startsWith and \c endsWith operators of the query.
+
+    By default, they are case sensitive.
+*/
+Qt::CaseSensitivity QueryFilter::caseSensitivity() const
+{
+    return m_caseSensitivity;
+}
+
+void QueryFilter::setCaseSensitivity(Qt::CaseSensitivity caseSensitivity)
+{
+    if (m_caseSensitivity == caseSensitivity)
+        return;
+
+    m_caseSensitivity = caseSensitivity;
+    m_query.setCaseSensitivity(caseSensitivity);
+    Q_EMIT caseSensitivityChanged();
+    invalidate();
+}
+
+CostClass QueryFilter::costClass() const
+{
+    return m_query.matchesText() ? CostClass::Text : CostClass::Role;
+}
+
+void QueryFilter::proxyModelCompleted(const QQmlSortFilterProxyModel& proxyModel)
+{
+    Q_UNUSED(proxyModel)
+    readParameters();
+    m_checked = false;
+}
+
+bool QueryFilter::filterRow(const QModelIndex& sourceIndex, const QQmlSortFilterProxyModel& proxyModel) const
+{
+    if (Q_UNLIKELY(!m_checked))
+        check(proxyModel);
+    return !m_valid || matches(sourceIndex, proxyModel);
+}
+
+QVariant QueryFilter::filterState() const
+{
+    return QVariantList { m_queryString, m_caseSensitivity, m_query.parameterValues() };
+}
+
+bool QueryFilter::filterSourceRows(const QQmlSortFilterProxyModel& proxyModel, QBitArray& rows) const
+{
+    const QAbstractItemModel& sourceModel = *proxyModel.sourceModel();
+    if (!m_checked)
+        check(proxyModel);
+    if (!m_valid || !m_query.candidateRows(proxyModel, rows))
+        return false;
+
+    for (int row = 0; row < rows.size(); ++row) {
+        if (rows.testBit(row) && !matches(sourceModel.index(row, 0), proxyModel))
+            rows.clearBit(row);
+    }
+    return true;
+}
+
+void QueryFilter::explainFilter(QVariantMap& plan, const QQmlSortFilterProxyModel& proxyModel, const PlanAnalysis* analysis) const
+{
+    Q_UNUSED(proxyModel)
+    Q_UNUSED(analysis)
+    plan.insert(QStringLiteral("query"), m_queryString);
+    plan.insert(QStringLiteral("roleNames"), m_query.roleNames());
+    if (!m_query.errorString().isEmpty())
+        plan.insert(QStringLiteral("error"), m_query.errorString());
+}
+
+void QueryFilter::onParameterChanged()
+{
+    readParameters();
+    m_checked = false;
+    invalidate();
+}
+
+// the parameters of the query are the properties of the filter with the same names, usually declared in QML
+void QueryFilter::bindParameters()
+{
+    QObject::disconnect(this, nullptr, this, SLOT(onParameterChanged()));
+    for (const QString& name : m_query.parameterNames()) {
+        QQmlProperty property(this, name);
+        if (!property.isValid()) {
+            if (m_parsed)
+                qWarning().noquote() << QStringLiteral("QueryFilter: unknown parameter $%1, declare a property named %1 on the filter").arg(name);
+            m_parsed = false;
+            continue;
+        }
+        property.connectNotifySignal(this, SLOT(onParameterChanged()));
+    }
+    readParameters();
+}
+
+void QueryFilter::readParameters()
+{
+    const QStringList& names = m_query.parameterNames();
+    for (int i = 0; i < names.size(); ++i)
+        m_query.setParameterValue(i, QQmlProperty::read(this, names.at(i)));
+}
+
+// an invalid query accepts every row, like an empty one, the types of the roles are checked for each row by matches()
+void QueryFilter::check(const QQmlSortFilterProxyModel& proxyModel) const
+{
+    m_checked = true;
+    m_typeMismatchReported = false;
+    m_valid = m_parsed && m_query.check(QModelIndex(), proxyModel);
+    if (m_parsed && !m_valid)
+        qWarning().noquote() << "QueryFilter:" << m_query.errorString();
+}
+
+bool QueryFilter::matches(const QModelIndex& sourceIndex, const QQmlSortFilterProxyModel& proxyModel) const
+{
+    const bool matches = m_query.matches(sourceIndex, proxyModel);
+    if (Q_UNLIKELY(m_query.hasTypeMismatch()) && !m_typeMismatchReported) {
+        m_typeMismatchReported = true;
+        qWarning().noquote() << QStringLiteral("QueryFilter: the data of row %1 doesn't have the types expected by the query \"%2\", the row isn't accepted")
+                                .arg(sourceIndex.row()).arg(m_queryString);
+    }
+    return matches;
+}
+
+}
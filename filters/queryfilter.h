@@ -0,0 +1,59 @@
+#ifndef QUERYFILTER_H
+#define QUERYFILTER_H
+
+#include "filter.h"
+#include "utils/query.h"
+
+namespace qqsfpm {
+
+class QueryFilter : public Filter
+{
+    Q_OBJECT
+    Q_PROPERTY(QString query READ query WRITE setQuery NOTIFY queryChanged)
+    Q_PROPERTY(Qt::CaseSensitivity caseSensitivity READ caseSensitivity WRITE setCaseSensitivity NOTIFY caseSensitivityChanged)
+
+public:
+    using Filter::Filter;
+
+    CostClass costClass() const override;
+
+    const QString& query() const;
+    void setQuery(const QString& query);
+
+    Qt::CaseSensitivity caseSensitivity() const;
+    void setCaseSensitivity(Qt::CaseSensitivity caseSensitivity);
+
+    void proxyModelCompleted(const QQmlSortFilterProxyModel& proxyModel) override;
+
+protected:
+    bool filterRow(const QModelIndex& sourceIndex, const QQmlSortFilterProxyModel& proxyModel) const override;
+    QVariant filterState() const override;
+    bool filterSourceRows(const QQmlSortFilterProxyModel& proxyModel, QBitArray& rows) const override;
+    void explainFilter(QVariantMap& plan, const QQmlSortFilterProxyModel& proxyModel, const PlanAnalysis* analysis) const override;
+
+Q_SIGNALS:
+    void queryChanged();
+    void caseSensitivityChanged();
+
+private Q_SLOTS:
+    void onParameterChanged();
+
+private:
+    void bindParameters();
+    void readParameters();
+    void check(const QQmlSortFilterProxyModel& proxyModel) const;
+    bool matches(const QModelIndex& sourceIndex, const QQmlSortFilterProxyModel& proxyModel) const;
+
+    QString m_queryString;
+    Qt::CaseSensitivity m_caseSensitivity = Qt::CaseSensitive;
+    bool m_parsed = true;
+    // the query is checked against the role names before the first row is tested after a change
+    mutable Query m_query;
+    mutable bool m_checked = false;
+    mutable bool m_valid = true;
+    mutable bool m_typeMismatchReported = false;
+};
+
+}
+
+#endif // QUERYFILTER_H
@@ -1,4 +1,6 @@
 #include "rangefilter.h"
+#include "qqmlsortfilterproxymodel.h"
+#include <QBitArray>
 
 namespace qqsfpm {
 
@@ -26,6 +28,9 @@ namespace qqsfpm {
        }
     }
     \endcode
+
+    If the filter's \l {RoleFilter::roleName} {roleName} is listed in the \l {SortFilterProxyModel::orderedIndexedRoleNames} {orderedIndexedRoleNames} of the proxy model,
+    the accepted rows are found by binary search in the role's sorted index instead of testing all the rows.
 */
 
 /*!
@@ -45,12 +50,20 @@ QVariant RangeFilter::minimumValue() const
 
 void RangeFilter::setMinimumValue(QVariant minimumValue)
 {
-    if (m_minimumValue == minimumValue)
+    if (m_minimumValue.userType() == minimumValue.userType() && m_minimumValue == minimumValue)
         return;
 
+    // a higher minimum can only reject more rows, bounds whose order is unknown filter all the rows again
+    int comparison = 0;
+    bool narrowing = minimumValue.isValid()
+            && (!m_minimumValue.isValid() || (VariantComparator::strictCompare(m_minimumValue, minimumValue, comparison) && comparison < 0));
     m_minimumValue = minimumValue;
+    invalidateTypedBounds();
     Q_EMIT minimumValueChanged();
-    invalidate();
+    if (narrowing)
+        narrow();
+    else
+        invalidate();
 }
 
 /*!
@@ -74,7 +87,10 @@ void RangeFilter::setMinimumInclusive(bool minimumInclusive)
 
     m_minimumInclusive = minimumInclusive;
     Q_EMIT minimumInclusiveChanged();
-    invalidate();
+    if (!minimumInclusive)
+        narrow();
+    else
+        invalidate();
 }
 
 /*!
@@ -94,12 +110,19 @@ QVariant RangeFilter::maximumValue() const
 
 void RangeFilter::setMaximumValue(QVariant maximumValue)
 {
-    if (m_maximumValue == maximumValue)
+    if (m_maximumValue.userType() == maximumValue.userType() && m_maximumValue == maximumValue)
         return;
 
+    int comparison = 0;
+    bool narrowing = maximumValue.isValid()
+            && (!m_maximumValue.isValid() || (VariantComparator::strictCompare(maximumValue, m_maximumValue, comparison) && comparison < 0));
     m_maximumValue = maximumValue;
+    invalidateTypedBounds();
     Q_EMIT maximumValueChanged();
-    invalidate();
+    if (narrowing)
+        narrow();
+    else
+        invalidate();
 }
 
 /*!
@@ -123,17 +146,58 @@ void RangeFilter::setMaximumInclusive(bool maximumInclusive)
 
     m_maximumInclusive = maximumInclusive;
     Q_EMIT maximumInclusiveChanged();
-    invalidate();
+    if (!maximumInclusive)
+        narrow();
+    else
+        invalidate();
 }
 
 bool RangeFilter::filterRow(const QModelIndex& sourceIndex, const QQmlSortFilterProxyModel& proxyModel) const
 {
     QVariant value = sourceData(sourceIndex, proxyModel);
-    bool lessThanMin = m_minimumValue.isValid() &&
-            (m_minimumInclusive ? value < m_minimumValue : value <= m_minimumValue);
-    bool moreThanMax = m_maximumValue.isValid() &&
-            (m_maximumInclusive ? value > m_maximumValue : value >= m_maximumValue);
+    if (value.userType() != m_boundsType)
+        updateTypedBounds(value.userType());
+
+    bool lessThanMin = false;
+    if (m_minimumValue.isValid()) {
+        int comparison = m_comparator.compareToBound(value, m_typedMinimumValue);
+        lessThanMin = m_minimumInclusive ? comparison < 0 : comparison <= 0;
+    }
+    bool moreThanMax = false;
+    if (m_maximumValue.isValid()) {
+        int comparison = m_comparator.compareToBound(value, m_typedMaximumValue);
+        moreThanMax = m_maximumInclusive ? comparison > 0 : comparison >= 0;
+    }
     return !(lessThanMin || moreThanMax);
 }
 
+// the types of the bounds are part of the state, QVariant compares "1" equal to 1 but the rows are compared to them in their own type
+QVariant RangeFilter::filterState() const
+{
+    return QVariantList { roleName(), m_minimumValue, m_minimumValue.userType(), m_minimumInclusive,
+                          m_maximumValue, m_maximumValue.userType(), m_maximumInclusive };
+}
+
+// the bounds are converted once to the type of the role's data, so that rows can be compared to them without conversions
+void RangeFilter::updateTypedBounds(int type) const
+{
+    m_boundsType = type;
+    m_typedMinimumValue = VariantComparator::convertedValue(m_minimumValue, type);
+    m_typedMaximumValue = VariantComparator::convertedValue(m_maximumValue, type);
+}
+
+void RangeFilter::invalidateTypedBounds()
+{
+    m_boundsType = -1;
+}
+
+bool RangeFilter::filterSourceRows(const QQmlSortFilterProxyModel& proxyModel, QBitArray& rows) const
+{
+    OrderedRoleIndex* index = proxyModel.orderedIndex(roleName());
+    return index && index->rangeSourceRows(*proxyModel.sourceModel(),
+                                           m_minimumValue, m_minimumInclusive,
+                                           m_maximumValue, m_maximumInclusive,
+                                           rows);
+}
+
 }
@@ -3,6 +3,7 @@
 
 #include "rolefilter.h"
 #include <QVariant>
+#include "utils/variantcomparator.h"
 
 namespace qqsfpm {
 
@@ -29,6 +30,8 @@ public:
 
 protected:
     bool filterRow(const QModelIndex& sourceIndex, const QQmlSortFilterProxyModel& proxyModel) const override;
+    QVariant filterState() const override;
+    bool filterSourceRows(const QQmlSortFilterProxyModel& proxyModel, QBitArray& rows) const override;
 
 Q_SIGNALS:
     void minimumValueChanged();
@@ -37,10 +40,18 @@ Q_SIGNALS:
     void maximumInclusiveChanged();
 
 private:
+    void updateTypedBounds(int type) const;
+    void invalidateTypedBounds();
+
     QVariant m_minimumValue;
     bool m_minimumInclusive = true;
     QVariant m_maximumValue;
     bool m_maximumInclusive = true;
+
+    VariantComparator m_comparator;
+    mutable int m_boundsType = -1;
+    mutable QVariant m_typedMinimumValue;
+    mutable QVariant m_typedMaximumValue;
 };
 
 }
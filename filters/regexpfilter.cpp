@@ -1,8 +1,53 @@
 #include "regexpfilter.h"
+#include "qqmlsortfilterproxymodel.h"
 #include <QVariant>
+#include <QBitArray>
 
 namespace qqsfpm {
 
+namespace {
+
+bool isLiteral(const QString& pattern, RegExpFilter::PatternSyntax syntax)
+{
+    switch (syntax) {
+    case RegExpFilter::FixedString:
+        return true;
+    case RegExpFilter::RegExp:
+    case RegExpFilter::RegExp2:
+        return !pattern.contains(QRegExp(QStringLiteral("[\\\\^$.|?*+()\\[\\]{}]")));
+    case RegExpFilter::Wildcard:
+    case RegExpFilter::WildcardUnix:
+        return !pattern.contains(QRegExp(QStringLiteral("[\\\\?*\\[\\]]")));
+    default:
+        return false;
+    }
+}
+
+// returns true if every string matching newPattern also matches oldPattern, like when typing in a search field
+bool isNarrowerPattern(const QString& oldPattern, const QString& newPattern, RegExpFilter::PatternSyntax syntax, Qt::CaseSensitivity caseSensitivity)
+{
+    QString oldBody = oldPattern;
+    QString newBody = newPattern;
+    bool oldAnchored = false;
+    bool newAnchored = false;
+    if (syntax == RegExpFilter::RegExp || syntax == RegExpFilter::RegExp2) {
+        oldAnchored = oldBody.startsWith(QLatin1Char('^'));
+        newAnchored = newBody.startsWith(QLatin1Char('^'));
+        if (oldAnchored)
+            oldBody.remove(0, 1);
+        if (newAnchored)
+            newBody.remove(0, 1);
+    }
+
+    if (!isLiteral(oldBody, syntax) || !isLiteral(newBody, syntax))
+        return false;
+    if (oldAnchored)
+        return newAnchored && newBody.startsWith(oldBody, caseSensitivity);
+    return newBody.contains(oldBody, caseSensitivity);
+}
+
+}
+
 /*!
     \qmltype RegExpFilter
     \inherits RoleFilter
@@ -26,6 +71,9 @@ namespace qqsfpm {
        }
     }
     \endcode
+
+    If the filter's \l {RoleFilter::roleName} {roleName} is listed in the \l {SortFilterProxyModel::orderedIndexedRoleNames} {orderedIndexedRoleNames} of the proxy model,
+    a case sensitive pattern looking for a literal prefix, like in the example above, is answered from the role's sorted index.
 */
 
 /*!
@@ -45,10 +93,15 @@ void RegExpFilter::setPattern(const QString& pattern)
     if (m_pattern == pattern)
         return;
 
+    bool narrowing = isNarrowerPattern(m_pattern, pattern, m_syntax, m_caseSensitivity);
     m_pattern = pattern;
     m_regExp.setPattern(pattern);
+    m_literalPattern = isLiteral(pattern, m_syntax);
     Q_EMIT patternChanged();
-    invalidate();
+    if (narrowing)
+        narrow();
+    else
+        invalidate();
 }
 
 /*!
@@ -79,6 +132,7 @@ void RegExpFilter::setSyntax(RegExpFilter::PatternSyntax syntax)
 
     m_syntax = syntax;
     m_regExp.setPatternSyntax(static_cast<QRegExp::PatternSyntax>(syntax));
+    m_literalPattern = isLiteral(m_pattern, syntax);
     Q_EMIT syntaxChanged();
     invalidate();
 }
@@ -101,13 +155,49 @@ void RegExpFilter::setCaseSensitivity(Qt::CaseSensitivity caseSensitivity)
     m_caseSensitivity = caseSensitivity;
     m_regExp.setCaseSensitivity(caseSensitivity);
     Q_EMIT caseSensitivityChanged();
-    invalidate();
+    if (caseSensitivity == Qt::CaseSensitive)
+        narrow();
+    else
+        invalidate();
 }
 
 bool RegExpFilter::filterRow(const QModelIndex& sourceIndex, const QQmlSortFilterProxyModel& proxyModel) const
 {
     QString string = sourceData(sourceIndex, proxyModel).toString();
+    // a pattern without special characters matches like a substring search, without going through the regexp engine
+    if (m_literalPattern)
+        return string.contains(m_pattern, m_caseSensitivity);
     return m_regExp.indexIn(string) != -1;
 }
 
+QVariant RegExpFilter::filterState() const
+{
+    return QVariantList { roleName(), m_pattern, m_syntax, m_caseSensitivity };
+}
+
+bool RegExpFilter::filterSourceRows(const QQmlSortFilterProxyModel& proxyModel, QBitArray& rows) const
+{
+    // only a case sensitive "^prefix" pattern can be looked up in a sorted index
+    if ((m_syntax != RegExp && m_syntax != RegExp2) || m_caseSensitivity != Qt::CaseSensitive || !m_pattern.startsWith(QLatin1Char('^')))
+        return false;
+
+    QString prefix = m_pattern.mid(1);
+    if (!isLiteral(prefix, m_syntax))
+        return false;
+
+    OrderedRoleIndex* index = proxyModel.orderedIndex(roleName());
+    return index && index->prefixSourceRows(*proxyModel.sourceModel(), prefix, rows);
+}
+
+CostClass RegExpFilter::costClass() const
+{
+    return CostClass::Text;
+}
+
+void RegExpFilter::explainFilter(QVariantMap& plan, const QQmlSortFilterProxyModel& proxyModel, const PlanAnalysis* analysis) const
+{
+    RoleFilter::explainFilter(plan, proxyModel, analysis);
+    plan.insert(QStringLiteral("literal"), m_literalPattern);
+}
+
 }
@@ -23,6 +23,8 @@ public:
 
     using RoleFilter::RoleFilter;
 
+    CostClass costClass() const override;
+
     QString pattern() const;
     void setPattern(const QString& pattern);
 
@@ -34,6 +36,9 @@ public:
 
 protected:
     bool filterRow(const QModelIndex& sourceIndex, const QQmlSortFilterProxyModel& proxyModel) const override;
+    QVariant filterState() const override;
+    bool filterSourceRows(const QQmlSortFilterProxyModel& proxyModel, QBitArray& rows) const override;
+    void explainFilter(QVariantMap& plan, const QQmlSortFilterProxyModel& proxyModel, const PlanAnalysis* analysis) const override;
 
 Q_SIGNALS:
     void patternChanged();
@@ -45,6 +50,7 @@ private:
     Qt::CaseSensitivity m_caseSensitivity = m_regExp.caseSensitivity();
     PatternSyntax m_syntax = static_cast<PatternSyntax>(m_regExp.patternSyntax());
     QString m_pattern = m_regExp.pattern();
+    bool m_literalPattern = true;
 };
 
 }
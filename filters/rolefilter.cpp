@@ -42,4 +42,11 @@ QVariant RoleFilter::sourceData(const QModelIndex &sourceIndex, const QQmlSortFi
     return proxyModel.sourceData(sourceIndex, m_roleName);
 }
 
+void RoleFilter::explainFilter(QVariantMap& plan, const QQmlSortFilterProxyModel& proxyModel, const PlanAnalysis* analysis) const
+{
+    Q_UNUSED(proxyModel)
+    Q_UNUSED(analysis)
+    plan.insert(QStringLiteral("roleName"), m_roleName);
+}
+
 }
@@ -21,6 +21,7 @@ Q_SIGNALS:
 
 protected:
     QVariant sourceData(const QModelIndex &sourceIndex, const QQmlSortFilterProxyModel& proxyModel) const;
+    void explainFilter(QVariantMap& plan, const QQmlSortFilterProxyModel& proxyModel, const PlanAnalysis* analysis) const override;
 
 private:
     QString m_roleName;
@@ -1,4 +1,6 @@
 #include "valuefilter.h"
+#include "qqmlsortfilterproxymodel.h"
+#include <QBitArray>
 
 namespace qqsfpm {
 
@@ -27,6 +29,8 @@ namespace qqsfpm {
     }
     \endcode
 
+    If the filter's \l {RoleFilter::roleName} {roleName} is listed in the \l {SortFilterProxyModel::indexedRoleNames} {indexedRoleNames} of the proxy model,
+    the matching rows are found directly in the role's index instead of being searched among all the rows.
 */
 
 /*!
@@ -44,9 +48,13 @@ void ValueFilter::setValue(const QVariant& value)
     if (m_value == value)
         return;
 
+    bool narrowing = !m_value.isValid();
     m_value = value;
     Q_EMIT valueChanged();
-    invalidate();
+    if (narrowing)
+        narrow();
+    else
+        invalidate();
 }
 
 bool ValueFilter::filterRow(const QModelIndex& sourceIndex, const QQmlSortFilterProxyModel& proxyModel) const
@@ -54,4 +62,24 @@ bool ValueFilter::filterRow(const QModelIndex& sourceIndex, const QQmlSortFilter
     return !m_value.isValid() || m_value == sourceData(sourceIndex, proxyModel);
 }
 
+QVariant ValueFilter::filterState() const
+{
+    return QVariantList { roleName(), m_value };
+}
+
+bool ValueFilter::filterSourceRows(const QQmlSortFilterProxyModel& proxyModel, QBitArray& rows) const
+{
+    HashRoleIndex* index = proxyModel.hashIndex(roleName());
+    const QAbstractItemModel& sourceModel = *proxyModel.sourceModel();
+    if (!index || !m_value.isValid() || !index->canFind(m_value, sourceModel))
+        return false;
+
+    rows.fill(false, sourceModel.rowCount());
+    for (int row : index->sourceRows(HashRoleIndex::key(m_value), sourceModel)) {
+        if (filterRow(sourceModel.index(row, 0), proxyModel))
+            rows.setBit(row);
+    }
+    return true;
+}
+
 }
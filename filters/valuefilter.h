@@ -18,6 +18,8 @@ public:
 
 protected:
     bool filterRow(const QModelIndex &sourceIndex, const QQmlSortFilterProxyModel& proxyModel) const override;
+    QVariant filterState() const override;
+    bool filterSourceRows(const QQmlSortFilterProxyModel& proxyModel, QBitArray& rows) const override;
 
 Q_SIGNALS:
     void valueChanged();
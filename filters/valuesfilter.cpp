@@ -0,0 +1,130 @@
+#include "valuesfilter.h"
+#include "qqmlsortfilterproxymodel.h"
+#include <QBitArray>
+
+namespace qqsfpm {
+
+/*!
+    \qmltype ValuesFilter
+    \inherits RoleFilter
+    \inqmlmodule SortFilterProxyModel
+    \ingroup Filters
+    \brief Filters rows matching one of a list of values.
+
+    A ValuesFilter is a \l RoleFilter that accepts rows whose data is equal to one of the filter's values, compared like \l ValueFilter does.
+    The values are stored in a hash set by a key, the number for numeric values whatever their type and the text for the other values,
+    and the data of a row is only compared to the values having the same key, so the cost of testing a row doesn't depend on the number of values.
+
+    It accepts the same rows as an \l AnyOf filter containing a \l ValueFilter for each value, except when a value is equal to the data
+    with a different key: floating point numbers only equal within the tolerance of the comparison, or a string equal to a number written differently,
+    like \c "1.0" and \c 1.
+
+    If the filter's \l {RoleFilter::roleName} {roleName} is listed in the \l {SortFilterProxyModel::indexedRoleNames} {indexedRoleNames} of the proxy model,
+    the matching rows are found directly in the role's index instead of being searched among all the rows.
+
+    In the following example, only rows with their \c category role set to one of the checked categories will be accepted :
+    \code
+    SortFilterProxyModel {
+       sourceModel: productModel
+       filters: ValuesFilter {
+           roleName: "category"
+           values: categorySelector.checkedCategories
+       }
+    }
+    \endcode
+*/
+
+/*!
+    \qmlproperty list ValuesFilter::values
+
+    This property holds the list of values used to filter the contents of the source model.
+
+    If the list is empty, every row is rejected.
+*/
+const QVariantList& ValuesFilter::values() const
+{
+    return m_values;
+}
+
+void ValuesFilter::setValues(const QVariantList& values)
+{
+    if (m_values == values)
+        return;
+
+    QHash<QString, QVariantList> valuesByKey;
+    valuesByKey.reserve(values.size());
+    for (const QVariant& value : values) {
+        if (value.isValid())
+            valuesByKey[HashRoleIndex::key(value)].append(value);
+    }
+
+    // only the rows affected by the difference between the old and new values need to be tested again
+    bool removedValues = false;
+    for (auto it = m_valuesByKey.cbegin(); it != m_valuesByKey.cend() && !removedValues; ++it) {
+        for (const QVariant& value : it.value())
+            removedValues = removedValues || !containsValue(valuesByKey, value);
+    }
+    bool addedValues = false;
+    for (auto it = valuesByKey.cbegin(); it != valuesByKey.cend() && !addedValues; ++it) {
+        for (const QVariant& value : it.value())
+            addedValues = addedValues || !containsValue(m_valuesByKey, value);
+    }
+
+    m_values = values;
+    m_valuesByKey.swap(valuesByKey);
+    Q_EMIT valuesChanged();
+
+    if (removedValues && addedValues)
+        invalidate();
+    else if (removedValues)
+        narrow();
+    else if (addedValues)
+        widen();
+}
+
+bool ValuesFilter::filterRow(const QModelIndex& sourceIndex, const QQmlSortFilterProxyModel& proxyModel) const
+{
+    QVariant data = sourceData(sourceIndex, proxyModel);
+    return data.isValid() && containsValue(m_valuesByKey, data);
+}
+
+// the types are part of the state since values of different types can compare equal, like "1" and 1
+QVariant ValuesFilter::filterState() const
+{
+    QStringList types;
+    types.reserve(m_values.size());
+    for (const QVariant& value : m_values)
+        types.append(QString::fromLatin1(value.typeName()));
+    return QVariantList { roleName(), m_values, types };
+}
+
+bool ValuesFilter::containsValue(const QHash<QString, QVariantList>& valuesByKey, const QVariant& data) const
+{
+    auto it = valuesByKey.constFind(HashRoleIndex::key(data));
+    if (it == valuesByKey.constEnd())
+        return false;
+    for (const QVariant& value : it.value()) {
+        if (value == data)
+            return true;
+    }
+    return false;
+}
+
+bool ValuesFilter::filterSourceRows(const QQmlSortFilterProxyModel& proxyModel, QBitArray& rows) const
+{
+    HashRoleIndex* index = proxyModel.hashIndex(roleName());
+    if (!index)
+        return false;
+
+    const QAbstractItemModel& sourceModel = *proxyModel.sourceModel();
+    rows.fill(false, sourceModel.rowCount());
+    for (auto it = m_valuesByKey.cbegin(); it != m_valuesByKey.cend(); ++it) {
+        for (int row : index->sourceRows(it.key(), sourceModel)) {
+            if (filterRow(sourceModel.index(row, 0), proxyModel))
+                rows.setBit(row);
+        }
+    }
+    return true;
+}
+
+}
@@ -0,0 +1,38 @@
+#ifndef VALUESFILTER_H
+#define VALUESFILTER_H
+
+#include "rolefilter.h"
+#include <QVariant>
+#include <QHash>
+
+namespace qqsfpm {
+
+class ValuesFilter : public RoleFilter {
+    Q_OBJECT
+    Q_PROPERTY(QVariantList values READ values WRITE setValues NOTIFY valuesChanged)
+
+public:
+    using RoleFilter::RoleFilter;
+
+    const QVariantList& values() const;
+    void setValues(const QVariantList& values);
+
+protected:
+    bool filterRow(const QModelIndex& sourceIndex, const QQmlSortFilterProxyModel& proxyModel) const override;
+    QVariant filterState() const override;
+    bool filterSourceRows(const QQmlSortFilterProxyModel& proxyModel, QBitArray& rows) const override;
+
+Q_SIGNALS:
+    void valuesChanged();
+
+private:
+    bool containsValue(const QHash<QString, QVariantList>& valuesByKey, const QVariant& value) const;
+
+    QVariantList m_values;
+    // the values by their HashRoleIndex key, the data of a row is compared to the values having its key
+    QHash<QString, QVariantList> m_valuesByKey;
+};
+
+}
+
+#endif // VALUESFILTER_H
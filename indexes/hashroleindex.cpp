@@ -0,0 +1,213 @@
+#include "hashroleindex.h"
+#include <QAbstractItemModel>
+#include <algorithm>
+
+namespace qqsfpm {
+
+/*
+    Maps the values of a source model role to the (sorted) source rows holding them.
+    Only the top level rows of the source model are indexed.
+
+    The index is built lazily the first time it is queried, and kept up to date with dataChanged and appended or removed trailing rows.
+    Other structural changes of the source model just invalidate it.
+*/
+HashRoleIndex::HashRoleIndex(int role) :
+    m_role(role)
+{
+}
+
+int HashRoleIndex::role() const
+{
+    return m_role;
+}
+
+/*
+    Values are indexed by a string form equal for the values equal with QVariant comparisons of the same key type:
+    numbers and booleans are compared as numbers, so 1, 1.0 and true have the same key, strings by their text.
+    QVariant comparisons also convert between key types ("1.50" is equal to 1.5), which the keys don't,
+    so values are only looked up when all the indexed values have the same key type (see canFind).
+*/
+QString HashRoleIndex::key(const QVariant& value)
+{
+    if (keyType(value) == QMetaType::Double)
+        return QVariant(value.toDouble()).toString();
+    return value.toString();
+}
+
+// the type by which a value is indexed, QMetaType::UnknownType for invalid values and -1 for the values only found by comparison
+int HashRoleIndex::keyType(const QVariant& value)
+{
+    switch (value.userType()) {
+    case QMetaType::UnknownType:
+        return QMetaType::UnknownType;
+    case QMetaType::Bool:
+    case QMetaType::Int:
+    case QMetaType::UInt:
+    case QMetaType::LongLong:
+    case QMetaType::ULongLong:
+    case QMetaType::Double:
+    case QMetaType::Float:
+    case QMetaType::Short:
+    case QMetaType::UShort:
+    case QMetaType::Long:
+    case QMetaType::ULong:
+    case QMetaType::Char:
+    case QMetaType::SChar:
+    case QMetaType::UChar:
+        return QMetaType::Double;
+    case QMetaType::QString:
+        return QMetaType::QString;
+    default:
+        return -1;
+    }
+}
+
+/*
+    Returns whether the rows with data equal to value are all found with its key,
+    which is only the case when all the indexed values have the key type of value.
+    Invalid data is never equal to a valid value, it doesn't prevent finding values.
+*/
+bool HashRoleIndex::canFind(const QVariant& value, const QAbstractItemModel& sourceModel)
+{
+    if (!m_built)
+        build(sourceModel);
+
+    const int type = keyType(value);
+    if (type == QMetaType::UnknownType || type == -1)
+        return false;
+    for (auto it = m_typeCounts.cbegin(); it != m_typeCounts.cend(); ++it) {
+        if (it.key() != type && it.key() != QMetaType::UnknownType)
+            return false;
+    }
+    return true;
+}
+
+const QVector<int>& HashRoleIndex::sourceRows(const QString& key, const QAbstractItemModel& sourceModel)
+{
+    static const QVector<int> noRows;
+    if (!m_built)
+        build(sourceModel);
+
+    auto it = m_rows.constFind(key);
+    return it != m_rows.constEnd() ? it.value() : noRows;
+}
+
+void HashRoleIndex::invalidate()
+{
+    m_built = false;
+    m_rowKeys.clear();
+    m_rowTypes.clear();
+    m_rows.clear();
+    m_typeCounts.clear();
+}
+
+void HashRoleIndex::updateRows(const QAbstractItemModel& sourceModel, int first, int last)
+{
+    if (!m_built)
+        return;
+
+    for (int row = first; row <= last && row < m_rowKeys.size(); ++row) {
+        QVariant value = rowValue(sourceModel, row);
+        QString key = HashRoleIndex::key(value);
+        int type = keyType(value);
+        if (key == m_rowKeys.at(row) && type == m_rowTypes.at(row))
+            continue;
+        removeRow(row, m_rowKeys.at(row));
+        countType(m_rowTypes.at(row), -1);
+        insertRow(row, key);
+        countType(type, 1);
+        m_rowKeys[row] = key;
+        m_rowTypes[row] = type;
+    }
+}
+
+void HashRoleIndex::insertRows(const QAbstractItemModel& sourceModel, int first, int last)
+{
+    if (!m_built)
+        return;
+
+    // rows inserted before the end would shift all the following rows
+    if (first != m_rowKeys.size()) {
+        invalidate();
+        return;
+    }
+
+    for (int row = first; row <= last; ++row)
+        appendRow(rowValue(sourceModel, row));
+}
+
+void HashRoleIndex::removeRows(int first, int last)
+{
+    if (!m_built)
+        return;
+
+    if (last != m_rowKeys.size() - 1) {
+        invalidate();
+        return;
+    }
+
+    for (int row = last; row >= first; --row) {
+        removeRow(row, m_rowKeys.at(row));
+        countType(m_rowTypes.at(row), -1);
+    }
+    m_rowKeys.resize(first);
+    m_rowTypes.resize(first);
+}
+
+void HashRoleIndex::build(const QAbstractItemModel& sourceModel)
+{
+    const int rowCount = sourceModel.rowCount();
+    invalidate();
+    m_rowKeys.reserve(rowCount);
+    m_rowTypes.reserve(rowCount);
+    for (int row = 0; row < rowCount; ++row)
+        appendRow(rowValue(sourceModel, row));
+    m_built = true;
+}
+
+QVariant HashRoleIndex::rowValue(const QAbstractItemModel& sourceModel, int row) const
+{
+    return sourceModel.data(sourceModel.index(row, 0), m_role);
+}
+
+void HashRoleIndex::appendRow(const QVariant& value)
+{
+    const QString key = HashRoleIndex::key(value);
+    const int type = keyType(value);
+    m_rows[key].append(m_rowKeys.size());
+    m_rowKeys.append(key);
+    m_rowTypes.append(type);
+    countType(type, 1);
+}
+
+void HashRoleIndex::insertRow(int row, const QString& key)
+{
+    QVector<int>& rows = m_rows[key];
+    rows.insert(std::lower_bound(rows.begin(), rows.end(), row), row);
+}
+
+void HashRoleIndex::removeRow(int row, const QString& key)
+{
+    auto it = m_rows.find(key);
+    if (it == m_rows.end())
+        return;
+
+    QVector<int>& rows = it.value();
+    auto rowIt = std::lower_bound(rows.begin(), rows.end(), row);
+    if (rowIt != rows.end() && *rowIt == row)
+        rows.erase(rowIt);
+    if (rows.isEmpty())
+        m_rows.erase(it);
+}
+
+void HashRoleIndex::countType(int type, int count)
+{
+    auto it = m_typeCounts.find(type);
+    if (it == m_typeCounts.end())
+        it = m_typeCounts.insert(type, 0);
+    it.value() += count;
+    if (it.value() <= 0)
+        m_typeCounts.erase(it);
+}
+
+}
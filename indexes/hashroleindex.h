@@ -0,0 +1,48 @@
+#ifndef HASHROLEINDEX_H
+#define HASHROLEINDEX_H
+
+#include <QHash>
+#include <QVector>
+#include <QVariant>
+
+class QAbstractItemModel;
+
+namespace qqsfpm {
+
+class HashRoleIndex
+{
+public:
+    explicit HashRoleIndex(int role = -1);
+
+    int role() const;
+
+    static QString key(const QVariant& value);
+    static int keyType(const QVariant& value);
+
+    bool canFind(const QVariant& value, const QAbstractItemModel& sourceModel);
+    const QVector<int>& sourceRows(const QString& key, const QAbstractItemModel& sourceModel);
+
+    void invalidate();
+    void updateRows(const QAbstractItemModel& sourceModel, int first, int last);
+    void insertRows(const QAbstractItemModel& sourceModel, int first, int last);
+    void removeRows(int first, int last);
+
+private:
+    void build(const QAbstractItemModel& sourceModel);
+    QVariant rowValue(const QAbstractItemModel& sourceModel, int row) const;
+    void appendRow(const QVariant& value);
+    void insertRow(int row, const QString& key);
+    void removeRow(int row, const QString& key);
+    void countType(int type, int count);
+
+    int m_role;
+    bool m_built = false;
+    QVector<QString> m_rowKeys;
+    QVector<int> m_rowTypes;
+    QHash<QString, QVector<int>> m_rows;
+    QHash<int, int> m_typeCounts;
+};
+
+}
+
+#endif // HASHROLEINDEX_H
@@ -0,0 +1,218 @@
+#include "orderedroleindex.h"
+#include <QAbstractItemModel>
+#include <QBitArray>
+#include <algorithm>
+
+namespace qqsfpm {
+
+/*
+    Keeps the (value, source row) pairs of a source model role sorted by value,
+    to find the rows with a value in a given range or starting with a given prefix by binary search.
+    Only the top level rows of the source model are indexed.
+
+    Values are compared like QVariant's comparison operators do, like in RangeFilter.
+    Since these only define a consistent order between values of the same type,
+    the index refuses to answer queries when the role holds values of different types.
+
+    Like HashRoleIndex, the index is built lazily and kept up to date with dataChanged and appended or removed trailing rows.
+*/
+OrderedRoleIndex::OrderedRoleIndex(int role) :
+    m_role(role)
+{
+}
+
+int OrderedRoleIndex::role() const
+{
+    return m_role;
+}
+
+bool OrderedRoleIndex::rangeSourceRows(const QAbstractItemModel& sourceModel,
+                                       const QVariant& minimum, bool minimumInclusive,
+                                       const QVariant& maximum, bool maximumInclusive,
+                                       QBitArray& rows)
+{
+    if (!m_built)
+        build(sourceModel);
+    if (!m_homogeneous || (!m_entries.isEmpty() && m_type == QMetaType::UnknownType))
+        return false;
+
+    QVariant typedMinimum = VariantComparator::convertedValue(minimum, m_type);
+    QVariant typedMaximum = VariantComparator::convertedValue(maximum, m_type);
+    auto begin = m_entries.cbegin();
+    if (minimum.isValid())
+        begin = minimumInclusive ? lowerBound(typedMinimum) : upperBound(typedMinimum);
+    auto end = m_entries.cend();
+    if (maximum.isValid())
+        end = maximumInclusive ? upperBound(typedMaximum) : lowerBound(typedMaximum);
+    // like RangeFilter, the numbers fuzzily equal to a bound are equal to it, they are next to the bound in the exact ordering
+    if (minimum.isValid()) {
+        if (minimumInclusive) {
+            while (begin != m_entries.cbegin() && VariantComparator::fuzzyEquals((begin - 1)->value, typedMinimum))
+                --begin;
+        } else {
+            while (begin != m_entries.cend() && VariantComparator::fuzzyEquals(begin->value, typedMinimum))
+                ++begin;
+        }
+    }
+    if (maximum.isValid()) {
+        if (maximumInclusive) {
+            while (end != m_entries.cend() && VariantComparator::fuzzyEquals(end->value, typedMaximum))
+                ++end;
+        } else {
+            while (end != m_entries.cbegin() && VariantComparator::fuzzyEquals((end - 1)->value, typedMaximum))
+                --end;
+        }
+    }
+    if (end < begin)
+        end = begin;
+
+    rows.fill(false, m_rowValues.size());
+    for (auto it = begin; it < end; ++it)
+        rows.setBit(it->row);
+    return true;
+}
+
+bool OrderedRoleIndex::prefixSourceRows(const QAbstractItemModel& sourceModel, const QString& prefix, QBitArray& rows)
+{
+    if (!m_built)
+        build(sourceModel);
+    if (!m_homogeneous || (!m_entries.isEmpty() && m_type != QMetaType::QString))
+        return false;
+
+    rows.fill(false, m_rowValues.size());
+    for (auto it = lowerBound(prefix); it != m_entries.cend() && it->value.toString().startsWith(prefix); ++it)
+        rows.setBit(it->row);
+    return true;
+}
+
+void OrderedRoleIndex::invalidate()
+{
+    m_built = false;
+    m_rowValues.clear();
+    m_entries.clear();
+}
+
+void OrderedRoleIndex::updateRows(const QAbstractItemModel& sourceModel, int first, int last)
+{
+    if (!m_built)
+        return;
+
+    for (int row = first; row <= last && row < m_rowValues.size(); ++row) {
+        QVariant value = rowValue(sourceModel, row);
+        if (value == m_rowValues.at(row))
+            continue;
+        removeEntry(m_rowValues.at(row), row);
+        insertEntry(value, row);
+        m_rowValues[row] = value;
+    }
+}
+
+void OrderedRoleIndex::insertRows(const QAbstractItemModel& sourceModel, int first, int last)
+{
+    if (!m_built)
+        return;
+
+    // rows inserted before the end would shift all the following rows
+    if (first != m_rowValues.size()) {
+        invalidate();
+        return;
+    }
+
+    for (int row = first; row <= last; ++row) {
+        QVariant value = rowValue(sourceModel, row);
+        m_rowValues.append(value);
+        insertEntry(value, row);
+    }
+}
+
+void OrderedRoleIndex::removeRows(int first, int last)
+{
+    if (!m_built)
+        return;
+
+    if (last != m_rowValues.size() - 1) {
+        invalidate();
+        return;
+    }
+
+    for (int row = last; row >= first; --row)
+        removeEntry(m_rowValues.at(row), row);
+    m_rowValues.resize(first);
+}
+
+void OrderedRoleIndex::build(const QAbstractItemModel& sourceModel)
+{
+    const int rowCount = sourceModel.rowCount();
+    m_homogeneous = true;
+    m_hasType = false;
+    m_rowValues.resize(rowCount);
+    m_entries.resize(rowCount);
+    for (int row = 0; row < rowCount; ++row) {
+        QVariant value = rowValue(sourceModel, row);
+        m_rowValues[row] = value;
+        m_entries[row] = Entry{ value, row };
+    }
+    if (m_homogeneous) {
+        std::sort(m_entries.begin(), m_entries.end(), [this] (const Entry& left, const Entry& right) {
+            return entryLessThan(left.value, left.row, right.value, right.row);
+        });
+    }
+    m_built = true;
+}
+
+QVariant OrderedRoleIndex::rowValue(const QAbstractItemModel& sourceModel, int row)
+{
+    QVariant value = sourceModel.data(sourceModel.index(row, 0), m_role);
+    if (!m_hasType) {
+        m_type = value.userType();
+        m_hasType = true;
+    } else if (value.userType() != m_type) {
+        m_homogeneous = false; // stays so until the index is rebuilt
+    }
+    return value;
+}
+
+void OrderedRoleIndex::insertEntry(const QVariant& value, int row)
+{
+    if (!m_homogeneous)
+        return;
+
+    auto it = std::lower_bound(m_entries.begin(), m_entries.end(), row, [this, &value] (const Entry& entry, int row) {
+        return entryLessThan(entry.value, entry.row, value, row);
+    });
+    m_entries.insert(it, Entry{ value, row });
+}
+
+void OrderedRoleIndex::removeEntry(const QVariant& value, int row)
+{
+    if (!m_homogeneous)
+        return;
+
+    auto it = std::lower_bound(m_entries.begin(), m_entries.end(), row, [this, &value] (const Entry& entry, int row) {
+        return entryLessThan(entry.value, entry.row, value, row);
+    });
+    if (it != m_entries.end() && it->row == row)
+        m_entries.erase(it);
+}
+
+OrderedRoleIndex::Entries::const_iterator OrderedRoleIndex::lowerBound(const QVariant& value) const
+{
+    return std::lower_bound(m_entries.cbegin(), m_entries.cend(), value, [this] (const Entry& entry, const QVariant& value) {
+        return m_comparator.compare(entry.value, value) < 0;
+    });
+}
+
+OrderedRoleIndex::Entries::const_iterator OrderedRoleIndex::upperBound(const QVariant& value) const
+{
+    return std::upper_bound(m_entries.cbegin(), m_entries.cend(), value, [this] (const QVariant& value, const Entry& entry) {
+        return m_comparator.compare(value, entry.value) < 0;
+    });
+}
+
+bool OrderedRoleIndex::entryLessThan(const QVariant& leftValue, int leftRow, const QVariant& rightValue, int rightRow) const
+{
+    int comparison = m_comparator.compare(leftValue, rightValue);
+    return comparison < 0 || (comparison == 0 && leftRow < rightRow);
+}
+
+}
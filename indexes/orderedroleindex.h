@@ -0,0 +1,58 @@
+#ifndef ORDEREDROLEINDEX_H
+#define ORDEREDROLEINDEX_H
+
+#include <QVector>
+#include <QVariant>
+#include "utils/variantcomparator.h"
+
+class QAbstractItemModel;
+class QBitArray;
+
+namespace qqsfpm {
+
+class OrderedRoleIndex
+{
+public:
+    explicit OrderedRoleIndex(int role = -1);
+
+    int role() const;
+
+    bool rangeSourceRows(const QAbstractItemModel& sourceModel,
+                         const QVariant& minimum, bool minimumInclusive,
+                         const QVariant& maximum, bool maximumInclusive,
+                         QBitArray& rows);
+    bool prefixSourceRows(const QAbstractItemModel& sourceModel, const QString& prefix, QBitArray& rows);
+
+    void invalidate();
+    void updateRows(const QAbstractItemModel& sourceModel, int first, int last);
+    void insertRows(const QAbstractItemModel& sourceModel, int first, int last);
+    void removeRows(int first, int last);
+
+private:
+    struct Entry {
+        QVariant value;
+        int row;
+    };
+    using Entries = QVector<Entry>;
+
+    void build(const QAbstractItemModel& sourceModel);
+    QVariant rowValue(const QAbstractItemModel& sourceModel, int row);
+    void insertEntry(const QVariant& value, int row);
+    void removeEntry(const QVariant& value, int row);
+    bool entryLessThan(const QVariant& leftValue, int leftRow, const QVariant& rightValue, int rightRow) const;
+    Entries::const_iterator lowerBound(const QVariant& value) const;
+    Entries::const_iterator upperBound(const QVariant& value) const;
+
+    int m_role;
+    bool m_built = false;
+    bool m_homogeneous = true;
+    bool m_hasType = false;
+    int m_type = QMetaType::UnknownType;
+    QVector<QVariant> m_rowValues;
+    Entries m_entries;
+    VariantComparator m_comparator;
+};
+
+}
+
+#endif // ORDEREDROLEINDEX_H
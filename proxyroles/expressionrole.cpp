@@ -1,5 +1,6 @@
 #include "expressionrole.h"
 #include "qqmlsortfilterproxymodel.h"
+#include "utils/expressioncontext.h"
 #include <QtQml>
 
 namespace qqsfpm {
@@ -39,6 +40,11 @@ namespace qqsfpm {
     This means that if a property is not accessed because of a conditional, it won't be captured and the expression won't be reevaluted when this property changes.
 
     A workaround to this problem is to access all the properties the expressions depends unconditionally at the beggining of the expression.
+
+    Simple expressions, only made of roles (\c model.a or \c a), literals, external properties (like \c root.offset),
+    comparisons, logical and arithmetic operators, are evaluated natively instead of by the JavaScript engine, which is much faster.
+    Their external properties are evaluated with JavaScript once when they change, and the other expressions are evaluated as described above.
+    The rows whose roles used in the expression hold values that JavaScript converts as objects, like dates, are still evaluated with JavaScript.
 */
 const QQmlScriptString& ExpressionRole::expression() const
 {
@@ -57,6 +63,39 @@ void ExpressionRole::setExpression(const QQmlScriptString& scriptString)
     invalidate();
 }
 
+/*!
+    \qmlproperty var ExpressionRole::prepare
+
+    This property holds a value that the \l expression reads as \c prepared when it computes the role of a row.
+
+    Data shared by all the rows, like a lookup object mapping codes to names, is better built in a binding on this property
+    than in the expression, which would build it again for each row whose role is read.
+    When the binding is evaluated again, the role is computed again for every row.
+
+    \code
+    ExpressionRole {
+        name: "countryName"
+        prepare: { var names = {}; for (var i = 0; i < countries.count; ++i) names[countries.get(i).code] = countries.get(i).name; return names; }
+        expression: prepared[model.countryCode]
+    }
+    \endcode
+
+    By default, it is \c undefined.
+*/
+const QJSValue& ExpressionRole::prepare() const
+{
+    return m_prepare;
+}
+
+void ExpressionRole::setPrepare(const QJSValue& prepare)
+{
+    if (!ExpressionContext::setPrepare(m_prepare, prepare, m_context))
+        return;
+
+    Q_EMIT prepareChanged();
+    invalidate();
+}
+
 void ExpressionRole::proxyModelCompleted(const QQmlSortFilterProxyModel& proxyModel)
 {
     updateContext(proxyModel);
@@ -64,27 +103,19 @@ void ExpressionRole::proxyModelCompleted(const QQmlSortFilterProxyModel& proxyMo
 
 QVariant ExpressionRole::data(const QModelIndex& sourceIndex, const QQmlSortFilterProxyModel& proxyModel)
 {
+    QVariant nativeResult;
+    if (m_nativeExpression.isCompiled() && m_nativeExpression.evaluate(sourceIndex, proxyModel, nativeResult))
+        return nativeResult;
     if (!m_scriptString.isEmpty()) {
-        QVariantMap modelMap;
-        QHash<int, QByteArray> roles = proxyModel.roleNames();
-
-        QQmlContext context(qmlContext(this));
-        auto addToContext = [&] (const QString &name, const QVariant& value) {
-            context.setContextProperty(name, value);
-            modelMap.insert(name, value);
-        };
-
-        for (auto it = roles.cbegin(); it != roles.cend(); ++it)
-            addToContext(it.value(), proxyModel.sourceData(sourceIndex, it.key()));
-        addToContext("index", sourceIndex.row());
+        ExpressionContext* context = proxyModel.expressionContext(qmlContext(this));
+        QQmlExpression* expression = context->expression(this, m_scriptString);
+        context->bindRow(sourceIndex, proxyModel);
+        context->setPrepared(m_prepare);
 
-        context.setContextProperty("model", modelMap);
+        QVariant result = expression->evaluate();
 
-        QQmlExpression expression(m_scriptString, &context);
-        QVariant result = expression.evaluate();
-
-        if (expression.hasError()) {
-            qWarning() << expression.error();
+        if (expression->hasError()) {
+            qWarning() << expression->error();
             return true;
         }
         return result;
@@ -96,7 +127,6 @@ void ExpressionRole::updateContext(const QQmlSortFilterProxyModel& proxyModel)
 {
     delete m_context;
     m_context = new QQmlContext(qmlContext(this), this);
-    // what about roles changes ?
     QVariantMap modelMap;
 
     auto addToContext = [&] (const QString &name, const QVariant& value) {
@@ -104,8 +134,12 @@ void ExpressionRole::updateContext(const QQmlSortFilterProxyModel& proxyModel)
         modelMap.insert(name, value);
     };
 
-    for (const QByteArray& roleName : proxyModel.roleNames().values())
+    QStringList roleNames;
+    for (const QByteArray& roleName : proxyModel.roleNames().values()) {
         addToContext(roleName, QVariant());
+        roleNames.append(QString::fromUtf8(roleName));
+    }
+    m_nativeExpression.setRoleNames(roleNames);
 
     addToContext("index", -1);
 
@@ -118,11 +152,21 @@ void ExpressionRole::updateExpression()
     if (!m_context)
         return;
 
+    ExpressionContext::bindPrepared(m_context, m_prepare);
     delete m_expression;
     m_expression = new QQmlExpression(m_scriptString, m_context, 0, this);
+    // a native expression tracks the external properties it depends on itself
+    if (m_nativeExpression.compile(m_expression->expression(), this, [this] { invalidate(); }))
+        return;
+
     connect(m_expression, &QQmlExpression::valueChanged, this, &ExpressionRole::invalidate);
     m_expression->setNotifyOnValueChanged(true);
     m_expression->evaluate();
 }
 
+CostClass ExpressionRole::costClass() const
+{
+    return m_nativeExpression.isCompiled() ? CostClass::Role : CostClass::Script;
+}
+
 }
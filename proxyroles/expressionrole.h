@@ -3,6 +3,8 @@
 
 #include "singlerole.h"
 #include <QQmlScriptString>
+#include <QJSValue>
+#include "utils/nativeexpression.h"
 
 class QQmlExpression;
 
@@ -12,17 +14,24 @@ class ExpressionRole : public SingleRole
 {
     Q_OBJECT
     Q_PROPERTY(QQmlScriptString expression READ expression WRITE setExpression NOTIFY expressionChanged)
+    Q_PROPERTY(QJSValue prepare READ prepare WRITE setPrepare NOTIFY prepareChanged)
 
 public:
     using SingleRole::SingleRole;
 
+    CostClass costClass() const override;
+
     const QQmlScriptString& expression() const;
     void setExpression(const QQmlScriptString& scriptString);
 
+    const QJSValue& prepare() const;
+    void setPrepare(const QJSValue& prepare);
+
     void proxyModelCompleted(const QQmlSortFilterProxyModel& proxyModel) override;
 
 Q_SIGNALS:
     void expressionChanged();
+    void prepareChanged();
 
 private:
     QVariant data(const QModelIndex& sourceIndex, const QQmlSortFilterProxyModel& proxyModel) override;
@@ -30,8 +39,10 @@ private:
     void updateExpression();
 
     QQmlScriptString m_scriptString;
+    QJSValue m_prepare;
     QQmlExpression* m_expression = nullptr;
     QQmlContext* m_context = nullptr;
+    NativeExpression m_nativeExpression;
 };
 
 }
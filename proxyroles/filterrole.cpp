@@ -39,12 +39,16 @@ namespace qqsfpm {
 void FilterRole::onFilterAppended(Filter* filter)
 {
     connect(filter, &Filter::invalidated, this, &FilterRole::invalidate);
+    connect(filter, &Filter::narrowed, this, &FilterRole::invalidate);
+    connect(filter, &Filter::widened, this, &FilterRole::invalidate);
     invalidate();
 }
 
 void FilterRole::onFilterRemoved(Filter* filter)
 {
     disconnect(filter, &Filter::invalidated, this, &FilterRole::invalidate);
+    disconnect(filter, &Filter::narrowed, this, &FilterRole::invalidate);
+    disconnect(filter, &Filter::widened, this, &FilterRole::invalidate);
     invalidate();
 }
 
@@ -62,4 +66,14 @@ QVariant FilterRole::data(const QModelIndex& sourceIndex, const QQmlSortFilterPr
     );
 }
 
+CostClass FilterRole::costClass() const
+{
+    return Plan::filtersCostClass(m_filters);
+}
+
+void FilterRole::explainProxyRole(QVariantMap& plan, const QQmlSortFilterProxyModel& proxyModel, const PlanAnalysis* analysis) const
+{
+    plan.insert(QStringLiteral("filters"), Plan::explainFilters(m_filters, proxyModel, analysis));
+}
+
 }
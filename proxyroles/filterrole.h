@@ -16,7 +16,10 @@ class FilterRole : public SingleRole, public FilterContainer
 public:
     using SingleRole::SingleRole;
 
+    CostClass costClass() const override;
+
 private:
+    void explainProxyRole(QVariantMap& plan, const QQmlSortFilterProxyModel& proxyModel, const PlanAnalysis* analysis) const override;
     void onFilterAppended(Filter* filter) override;
     void onFilterRemoved(Filter* filter) override;
     void onFiltersCleared() override;
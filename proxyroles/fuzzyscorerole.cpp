@@ -0,0 +1,74 @@
+#include "fuzzyscorerole.h"
+
+namespace qqsfpm {
+
+/*!
+    \qmltype FuzzyScoreRole
+    \inherits SingleRole
+    \inqmlmodule SortFilterProxyModel
+    \ingroup ProxyRoles
+    \brief A role exposing the relevance score computed by a \l FuzzyFilter.
+
+    A FuzzyScoreRole is a \l ProxyRole that provides the score of its \l filter for each row.
+    The data of this role is \c -1 for rows not matching the filter's pattern.
+
+    In the following example, the \c score role holds how well the \c name role of each row matches the content of the text field :
+    \code
+    SortFilterProxyModel {
+       sourceModel: fileModel
+       filters: FuzzyFilter {
+           id: fuzzyFilter
+           roleName: "name"
+           pattern: searchField.text
+       }
+       proxyRoles: FuzzyScoreRole {
+           name: "score"
+           filter: fuzzyFilter
+       }
+    }
+    \endcode
+*/
+
+/*!
+    \qmlproperty FuzzyFilter FuzzyScoreRole::filter
+
+    This property holds the \l FuzzyFilter whose scores are exposed by this role.
+*/
+FuzzyFilter* FuzzyScoreRole::filter() const
+{
+    return m_filter;
+}
+
+void FuzzyScoreRole::setFilter(FuzzyFilter* filter)
+{
+    if (m_filter == filter)
+        return;
+
+    if (m_filter)
+        disconnect(m_filter, nullptr, this, nullptr);
+
+    m_filter = filter;
+
+    if (m_filter) {
+        connect(m_filter, &FuzzyFilter::roleNameChanged, this, &FuzzyScoreRole::invalidate);
+        connect(m_filter, &FuzzyFilter::patternChanged, this, &FuzzyScoreRole::invalidate);
+        connect(m_filter, &FuzzyFilter::caseSensitivityChanged, this, &FuzzyScoreRole::invalidate);
+    }
+
+    Q_EMIT filterChanged();
+    invalidate();
+}
+
+QVariant FuzzyScoreRole::data(const QModelIndex& sourceIndex, const QQmlSortFilterProxyModel& proxyModel)
+{
+    if (!m_filter)
+        return QVariant();
+    return m_filter->score(sourceIndex, proxyModel);
+}
+
+CostClass FuzzyScoreRole::costClass() const
+{
+    return CostClass::Text;
+}
+
+}
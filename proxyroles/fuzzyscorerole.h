@@ -0,0 +1,34 @@
+#ifndef FUZZYSCOREROLE_H
+#define FUZZYSCOREROLE_H
+
+#include "singlerole.h"
+#include "filters/fuzzyfilter.h"
+#include <QPointer>
+
+namespace qqsfpm {
+
+class FuzzyScoreRole : public SingleRole
+{
+    Q_OBJECT
+    Q_PROPERTY(qqsfpm::FuzzyFilter* filter READ filter WRITE setFilter NOTIFY filterChanged)
+
+public:
+    using SingleRole::SingleRole;
+
+    CostClass costClass() const override;
+
+    FuzzyFilter* filter() const;
+    void setFilter(FuzzyFilter* filter);
+
+Q_SIGNALS:
+    void filterChanged();
+
+private:
+    QVariant data(const QModelIndex& sourceIndex, const QQmlSortFilterProxyModel& proxyModel) override;
+
+    QPointer<FuzzyFilter> m_filter;
+};
+
+}
+
+#endif // FUZZYSCOREROLE_H
@@ -33,11 +33,61 @@ QVariant ProxyRole::roleData(const QModelIndex& sourceIndex, const QQmlSortFilte
     }
 }
 
+// called when the proxy model is completed, and again when its role names change
 void ProxyRole::proxyModelCompleted(const QQmlSortFilterProxyModel &proxyModel)
 {
     Q_UNUSED(proxyModel)
 }
 
+// called before the proxy model handles a change of the source data, for proxy roles caching per row results
+void ProxyRole::sourceDataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight, const QVector<int>& roles, const QQmlSortFilterProxyModel& proxyModel)
+{
+    Q_UNUSED(topLeft)
+    Q_UNUSED(bottomRight)
+    Q_UNUSED(roles)
+    Q_UNUSED(proxyModel)
+}
+
+// called when source rows are inserted, removed or moved, or when the source model is reset
+void ProxyRole::sourceRowsChanged()
+{
+}
+
+// called when the proxy model assigns its role numbers again, for proxy roles caching role numbers
+void ProxyRole::roleNumbersChanged()
+{
+}
+
+/*
+    Describes how the proxy role computes its data, for SortFilterProxyModel::explain().
+    With an analysis, the description also holds the rows it was read for and the time and source data() calls it took.
+*/
+QVariantMap ProxyRole::explain(const QQmlSortFilterProxyModel& proxyModel, const PlanAnalysis* analysis)
+{
+    QVariantMap plan {
+        {QStringLiteral("type"), Plan::qmlTypeName(this)},
+        {QStringLiteral("objectName"), objectName()},
+        {QStringLiteral("names"), names()},
+        {QStringLiteral("cost"), Plan::costClassName(costClass())}
+    };
+    explainProxyRole(plan, proxyModel, analysis);
+    if (analysis)
+        analysis->annotate(plan, this, QStringLiteral("rowsIn"), false);
+    return plan;
+}
+
+CostClass ProxyRole::costClass() const
+{
+    return CostClass::Role;
+}
+
+void ProxyRole::explainProxyRole(QVariantMap& plan, const QQmlSortFilterProxyModel& proxyModel, const PlanAnalysis* analysis) const
+{
+    Q_UNUSED(plan)
+    Q_UNUSED(proxyModel)
+    Q_UNUSED(analysis)
+}
+
 void ProxyRole::invalidate()
 {
     Q_EMIT invalidated();
@@ -3,6 +3,7 @@
 
 #include <QObject>
 #include <QMutex>
+#include "utils/plan.h"
 
 namespace qqsfpm {
 
@@ -18,10 +19,17 @@ public:
 
     QVariant roleData(const QModelIndex& sourceIndex, const QQmlSortFilterProxyModel& proxyModel, const QString& name);
     virtual void proxyModelCompleted(const QQmlSortFilterProxyModel& proxyModel);
+    virtual void sourceDataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight, const QVector<int>& roles, const QQmlSortFilterProxyModel& proxyModel);
+    virtual void sourceRowsChanged();
+    virtual void roleNumbersChanged();
 
     virtual QStringList names() = 0;
 
+    QVariantMap explain(const QQmlSortFilterProxyModel& proxyModel, const PlanAnalysis* analysis);
+    virtual CostClass costClass() const;
+
 protected:
+    virtual void explainProxyRole(QVariantMap& plan, const QQmlSortFilterProxyModel& proxyModel, const PlanAnalysis* analysis) const;
     void invalidate();
 
 Q_SIGNALS:
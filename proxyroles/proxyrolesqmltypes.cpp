@@ -4,6 +4,7 @@
 #include "expressionrole.h"
 #include "regexprole.h"
 #include "filterrole.h"
+#include "fuzzyscorerole.h"
 #include <QQmlEngine>
 #include <QCoreApplication>
 
@@ -16,6 +17,7 @@ void registerProxyRoleTypes() {
     qmlRegisterType<ExpressionRole>("SortFilterProxyModel", 0, 2, "ExpressionRole");
     qmlRegisterType<RegExpRole>("SortFilterProxyModel", 0, 2, "RegExpRole");
     qmlRegisterType<FilterRole>("SortFilterProxyModel", 0, 2, "FilterRole");
+    qmlRegisterType<FuzzyScoreRole>("SortFilterProxyModel", 0, 2, "FuzzyScoreRole");
 }
 
 Q_COREAPP_STARTUP_FUNCTION(registerProxyRoleTypes)
@@ -4,6 +4,8 @@
 
 namespace qqsfpm {
 
+const int MatchesCacheSize = 1024;
+
 /*!
     \qmltype RegExpRole
     \inherits ProxyRole
@@ -41,7 +43,9 @@ void RegExpRole::setRoleName(const QString& roleName)
         return;
 
     m_roleName = roleName;
+    m_matches.clear();
     Q_EMIT roleNameChanged();
+    invalidate();
 }
 
 /*!
@@ -62,6 +66,7 @@ void RegExpRole::setPattern(const QString& pattern)
 
     Q_EMIT namesAboutToBeChanged();
     m_regularExpression.setPattern(pattern);
+    m_matches.clear();
     invalidate();
     Q_EMIT patternChanged();
     Q_EMIT namesChanged();
@@ -84,7 +89,9 @@ void RegExpRole::setCaseSensitivity(Qt::CaseSensitivity caseSensitivity)
         return;
 
     m_regularExpression.setPatternOptions(m_regularExpression.patternOptions() ^ QRegularExpression::CaseInsensitiveOption); //toggle the option
+    m_matches.clear();
     Q_EMIT caseSensitivityChanged();
+    invalidate();
 }
 
 QStringList RegExpRole::names()
@@ -94,11 +101,55 @@ QStringList RegExpRole::names()
     return nameCaptureGroups;
 }
 
+void RegExpRole::sourceDataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight, const QVector<int>& roles, const QQmlSortFilterProxyModel& proxyModel)
+{
+    if (topLeft.parent().isValid() || m_matches.isEmpty())
+        return;
+
+    int role = proxyModel.roleForName(m_roleName);
+    if (!roles.isEmpty() && role != -1 && !roles.contains(role))
+        return;
+
+    for (int row = topLeft.row(); row <= bottomRight.row(); ++row)
+        m_matches.remove(row);
+}
+
+void RegExpRole::sourceRowsChanged()
+{
+    m_matches.clear();
+}
+
 QVariant RegExpRole::data(const QModelIndex& sourceIndex, const QQmlSortFilterProxyModel& proxyModel, const QString &name)
 {
-    QString text = proxyModel.sourceData(sourceIndex, m_roleName).toString();
-    QRegularExpressionMatch match = m_regularExpression.match(text);
+    QRegularExpressionMatch match = this->match(sourceIndex, proxyModel);
     return match.hasMatch() ? (match.captured(name)) : QVariant{};
 }
 
+/*
+    The last match of each top level row is kept, so that the roles of all the capture groups are extracted from a single match.
+    The text is stored along with the match so that a stale entry is never used.
+    At most MatchesCacheSize rows are kept, an arbitrary one is dropped to make room for a new row.
+*/
+QRegularExpressionMatch RegExpRole::match(const QModelIndex& sourceIndex, const QQmlSortFilterProxyModel& proxyModel)
+{
+    QString text = proxyModel.sourceData(sourceIndex, m_roleName).toString();
+    if (sourceIndex.parent().isValid())
+        return m_regularExpression.match(text);
+
+    auto it = m_matches.find(sourceIndex.row());
+    if (it == m_matches.end()) {
+        if (m_matches.size() >= MatchesCacheSize)
+            m_matches.erase(m_matches.begin());
+        it = m_matches.insert(sourceIndex.row(), {text, m_regularExpression.match(text)});
+    } else if (it->text != text) {
+        *it = {text, m_regularExpression.match(text)};
+    }
+    return it->match;
+}
+
+CostClass RegExpRole::costClass() const
+{
+    return CostClass::Text;
+}
+
 }
@@ -3,6 +3,7 @@
 
 #include "proxyrole.h"
 #include <QRegularExpression>
+#include <QHash>
 
 namespace qqsfpm {
 
@@ -16,6 +17,8 @@ class RegExpRole : public ProxyRole
 public:
     using ProxyRole::ProxyRole;
 
+    CostClass costClass() const override;
+
     QString roleName() const;
     void setRoleName(const QString& roleName);
 
@@ -27,15 +30,25 @@ public:
 
     QStringList names() override;
 
+    void sourceDataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight, const QVector<int>& roles, const QQmlSortFilterProxyModel& proxyModel) override;
+    void sourceRowsChanged() override;
+
 Q_SIGNALS:
     void roleNameChanged();
     void patternChanged();    
     void caseSensitivityChanged();
 
 private:
+    struct RowMatch {
+        QString text;
+        QRegularExpressionMatch match;
+    };
+
     QString m_roleName;
     QRegularExpression m_regularExpression;
+    QHash<int, RowMatch> m_matches;
     QVariant data(const QModelIndex &sourceIndex, const QQmlSortFilterProxyModel &proxyModel, const QString &name) override;
+    QRegularExpressionMatch match(const QModelIndex& sourceIndex, const QQmlSortFilterProxyModel& proxyModel);
 };
 
 }
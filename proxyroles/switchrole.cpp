@@ -1,6 +1,8 @@
 #include "switchrole.h"
 #include "qqmlsortfilterproxymodel.h"
 #include "filters/filter.h"
+#include "filters/valuefilter.h"
+#include "indexes/hashroleindex.h"
 #include <QtQml>
 
 namespace qqsfpm {
@@ -76,6 +78,7 @@ void SwitchRole::setDefaultRoleName(const QString& defaultRoleName)
         return;
 
     m_defaultRoleName = defaultRoleName;
+    m_defaultRoleResolved = false;
     Q_EMIT defaultRoleNameChanged();
     invalidate();
 }
@@ -117,6 +120,11 @@ void SwitchRole::proxyModelCompleted(const QQmlSortFilterProxyModel& proxyModel)
         filter->proxyModelCompleted(proxyModel);
 }
 
+void SwitchRole::roleNumbersChanged()
+{
+    m_defaultRoleResolved = false;
+}
+
 SwitchRoleAttached* SwitchRole::qmlAttachedProperties(QObject* object)
 {
     return new SwitchRoleAttached(object);
@@ -124,45 +132,131 @@ SwitchRoleAttached* SwitchRole::qmlAttachedProperties(QObject* object)
 
 QVariant SwitchRole::data(const QModelIndex &sourceIndex, const QQmlSortFilterProxyModel &proxyModel)
 {
-    for (auto filter: m_filters) {
+    if (!m_casesCompiled)
+        compileCases();
+
+    // all the cases test the same role for equality, the only case that can match is looked up by value
+    if (!m_caseRoleName.isEmpty()) {
+        QVariant data = proxyModel.sourceData(sourceIndex, m_caseRoleName);
+        // data of another key type can be equal to a case value with a different key, the cases are then tested in order
+        if (HashRoleIndex::keyType(data) == m_caseKeyType) {
+            auto it = m_caseIndexes.constFind(HashRoleIndex::key(data));
+            if (it == m_caseIndexes.constEnd())
+                return defaultData(sourceIndex, proxyModel);
+            const Case& matchingCase = m_cases.at(it.value());
+            if (matchingCase.filter->filterAcceptsRow(sourceIndex, proxyModel))
+                return matchingCase.value;
+        }
+    }
+
+    for (const Case& switchCase : m_cases) {
+        if (switchCase.filter->filterAcceptsRow(sourceIndex, proxyModel))
+            return switchCase.value;
+    }
+    return defaultData(sourceIndex, proxyModel);
+}
+
+QVariant SwitchRole::defaultData(const QModelIndex& sourceIndex, const QQmlSortFilterProxyModel& proxyModel)
+{
+    if (m_defaultRoleName.isEmpty())
+        return m_defaultValue;
+
+    if (!m_defaultRoleResolved) {
+        m_defaultRole = proxyModel.roleForName(m_defaultRoleName);
+        m_defaultRoleResolved = true;
+    }
+    if (m_defaultRole == -1)
+        return proxyModel.sourceData(sourceIndex, m_defaultRoleName);
+    return proxyModel.sourceData(sourceIndex, m_defaultRole);
+}
+
+/*
+    Reads the attached values of the enabled filters once, instead of for every row.
+    When every case is a ValueFilter on the same role with values of the same key type (see HashRoleIndex::key),
+    a table from the keys of their values to the cases is built.
+    A row is then tested against the single case with the same key, like a ValueFilter using a role index.
+*/
+void SwitchRole::compileCases()
+{
+    m_cases.clear();
+    m_caseRoleName.clear();
+    m_caseIndexes.clear();
+    m_casesCompiled = true;
+
+    for (Filter* filter : m_filters) {
         if (!filter->enabled())
             continue;
-        if (filter->filterAcceptsRow(sourceIndex, proxyModel)) {
-            auto attached = static_cast<SwitchRoleAttached*>(qmlAttachedPropertiesObject<SwitchRole>(filter, false));
-            if (!attached) {
-                qWarning() << "No SwitchRole.value provided for this filter" << filter;
-                continue;
-            }
-            QVariant value = attached->value();
-            if (!value.isValid()) {
-                qWarning() << "No SwitchRole.value provided for this filter" << filter;
-                continue;
-            }
-            return value;
+        auto attached = static_cast<SwitchRoleAttached*>(qmlAttachedPropertiesObject<SwitchRole>(filter, false));
+        QVariant value = attached ? attached->value() : QVariant();
+        if (!value.isValid()) {
+            qWarning() << "No SwitchRole.value provided for this filter" << filter;
+            continue;
         }
+        m_cases.append({filter, value});
     }
-    if (!m_defaultRoleName.isEmpty())
-        return proxyModel.sourceData(sourceIndex, m_defaultRoleName);
-    return m_defaultValue;
+
+    QString roleName;
+    int keyType = QMetaType::UnknownType;
+    QHash<QString, int> caseIndexes;
+    for (int i = 0; i < m_cases.size(); ++i) {
+        auto valueFilter = qobject_cast<ValueFilter*>(m_cases.at(i).filter);
+        if (!valueFilter || valueFilter->inverted() || !valueFilter->value().isValid())
+            return;
+        if (i == 0) {
+            roleName = valueFilter->roleName();
+            keyType = HashRoleIndex::keyType(valueFilter->value());
+        } else if (valueFilter->roleName() != roleName || HashRoleIndex::keyType(valueFilter->value()) != keyType) {
+            return;
+        }
+        if (keyType == -1)
+            return;
+        QString key = HashRoleIndex::key(valueFilter->value());
+        // the first case wins when several cases have the same value
+        if (!caseIndexes.contains(key))
+            caseIndexes.insert(key, i);
+    }
+    m_caseRoleName = roleName;
+    m_caseKeyType = keyType;
+    m_caseIndexes = caseIndexes;
+}
+
+void SwitchRole::invalidateCases()
+{
+    m_casesCompiled = false;
+    invalidate();
 }
 
 void SwitchRole::onFilterAppended(Filter *filter)
 {
-    connect(filter, &Filter::invalidated, this, &SwitchRole::invalidate);
+    connect(filter, &Filter::invalidated, this, &SwitchRole::invalidateCases);
+    connect(filter, &Filter::narrowed, this, &SwitchRole::invalidateCases);
+    connect(filter, &Filter::widened, this, &SwitchRole::invalidateCases);
     auto attached = static_cast<SwitchRoleAttached*>(qmlAttachedPropertiesObject<SwitchRole>(filter, true));
-    connect(attached, &SwitchRoleAttached::valueChanged, this, &SwitchRole::invalidate);
-    invalidate();
+    connect(attached, &SwitchRoleAttached::valueChanged, this, &SwitchRole::invalidateCases);
+    invalidateCases();
 }
 
 void SwitchRole::onFilterRemoved(Filter *filter)
 {
     Q_UNUSED(filter)
-    invalidate();
+    invalidateCases();
 }
 
 void SwitchRole::onFiltersCleared()
 {
-    invalidate();
+    invalidateCases();
+}
+
+CostClass SwitchRole::costClass() const
+{
+    return Plan::filtersCostClass(m_filters);
+}
+
+// caseRoleName is set once the cases are compiled into a lookup table on that role
+void SwitchRole::explainProxyRole(QVariantMap& plan, const QQmlSortFilterProxyModel& proxyModel, const PlanAnalysis* analysis) const
+{
+    plan.insert(QStringLiteral("filters"), Plan::explainFilters(m_filters, proxyModel, analysis));
+    plan.insert(QStringLiteral("caseRoleName"), m_caseRoleName);
 }
 
 }
@@ -43,6 +43,8 @@ public:
     void setDefaultValue(const QVariant& defaultValue);
 
     void proxyModelCompleted(const QQmlSortFilterProxyModel& proxyModel) override;
+    void roleNumbersChanged() override;
+    CostClass costClass() const override;
 
     static SwitchRoleAttached* qmlAttachedProperties(QObject* object);
 
@@ -51,7 +53,16 @@ Q_SIGNALS:
     void defaultValueChanged();
 
 private:
+    struct Case {
+        Filter* filter;
+        QVariant value;
+    };
+
     QVariant data(const QModelIndex& sourceIndex, const QQmlSortFilterProxyModel& proxyModel) override;
+    void explainProxyRole(QVariantMap& plan, const QQmlSortFilterProxyModel& proxyModel, const PlanAnalysis* analysis) const override;
+    QVariant defaultData(const QModelIndex& sourceIndex, const QQmlSortFilterProxyModel& proxyModel);
+    void compileCases();
+    void invalidateCases();
 
     void onFilterAppended(Filter *filter) override;
     void onFilterRemoved(Filter *filter) override;
@@ -59,6 +70,14 @@ private:
 
     QString m_defaultRoleName;
     QVariant m_defaultValue;
+
+    bool m_casesCompiled = false;
+    QVector<Case> m_cases;
+    QString m_caseRoleName;
+    int m_caseKeyType = QMetaType::UnknownType;
+    QHash<QString, int> m_caseIndexes;
+    bool m_defaultRoleResolved = false;
+    int m_defaultRole = -1;
 };
 
 }
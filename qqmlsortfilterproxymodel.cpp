@@ -4,9 +4,19 @@
 #include "filters/filter.h"
 #include "sorters/sorter.h"
 #include "proxyroles/proxyrole.h"
+#include "utils/sortkey.h"
+#include "utils/workloadrecorder.h"
+#include "utils/expressioncontext.h"
 
 namespace qqsfpm {
 
+namespace {
+
+// number of previous filtering results kept to be restored without testing any row
+const int FilterResultsCacheSize = 8;
+
+}
+
 /*!
     \qmltype SortFilterProxyModel
     \inqmlmodule SortFilterProxyModel
@@ -26,6 +36,7 @@ QQmlSortFilterProxyModel::QQmlSortFilterProxyModel(QObject *parent) :
     m_delayed(false)
 #endif
 {
+    m_statistics = new Statistics(this);
     connect(this, &QAbstractProxyModel::sourceModelChanged, this, &QQmlSortFilterProxyModel::updateRoles);
     connect(this, &QAbstractItemModel::modelReset, this, &QQmlSortFilterProxyModel::updateRoles);
     connect(this, &QAbstractItemModel::rowsInserted, this, &QQmlSortFilterProxyModel::countChanged);
@@ -175,11 +186,89 @@ void QQmlSortFilterProxyModel::setAscendingSortOrder(bool ascendingSortOrder)
     queueInvalidate();
 }
 
+/*!
+    \qmlproperty list<string> SortFilterProxyModel::indexedRoleNames
+
+    This property holds the names of the source model roles for which the proxy model maintains an index of their values.
+
+    An index lets a \l ValueFilter or a \l ValuesFilter on one of these roles find the rows they accept without testing all the rows,
+    and speeds up \l findRow for these roles.
+    Indexes are kept up to date with the source model, at the cost of some memory and of some work when the source model changes.
+    They are only useful for large models and roles with many different values, like identifiers.
+
+    Only the roles of the source model can be indexed, proxy roles are ignored.
+
+    By default, no role is indexed.
+
+    \sa orderedIndexedRoleNames
+*/
+const QStringList& QQmlSortFilterProxyModel::indexedRoleNames() const
+{
+    return m_indexedRoleNames;
+}
+
+void QQmlSortFilterProxyModel::setIndexedRoleNames(const QStringList& indexedRoleNames)
+{
+    if (m_indexedRoleNames == indexedRoleNames)
+        return;
+
+    m_indexedRoleNames = indexedRoleNames;
+    updateRoleIndexes();
+    Q_EMIT indexedRoleNamesChanged();
+}
+
+/*!
+    \qmlproperty list<string> SortFilterProxyModel::orderedIndexedRoleNames
+
+    This property holds the names of the source model roles for which the proxy model maintains a sorted index of their values.
+
+    A sorted index lets a \l RangeFilter on one of these roles find the rows it accepts by binary search instead of testing all the rows,
+    which makes moving its bounds (with a slider for example) cheap on large models.
+    It also serves \l RegExpFilter patterns looking for a prefix, like \c {"^text"}, for autocompletion lists.
+
+    A sorted index can only be used if all the values of the role have the same type.
+    Only the roles of the source model can be indexed, proxy roles are ignored.
+
+    By default, no role is indexed.
+
+    \sa indexedRoleNames
+*/
+const QStringList& QQmlSortFilterProxyModel::orderedIndexedRoleNames() const
+{
+    return m_orderedIndexedRoleNames;
+}
+
+void QQmlSortFilterProxyModel::setOrderedIndexedRoleNames(const QStringList& orderedIndexedRoleNames)
+{
+    if (m_orderedIndexedRoleNames == orderedIndexedRoleNames)
+        return;
+
+    m_orderedIndexedRoleNames = orderedIndexedRoleNames;
+    updateRoleIndexes();
+    Q_EMIT orderedIndexedRoleNamesChanged();
+}
+
+/*!
+    \qmlproperty Statistics SortFilterProxyModel::statistics
+
+    This property holds the \l Statistics of the work done by the model, its filters, sorters and proxy roles.
+    They are only collected once enabled, with \c {statistics.enabled: true}.
+*/
+Statistics* QQmlSortFilterProxyModel::statistics() const
+{
+    return m_statistics;
+}
+
 /*!
     \qmlproperty list<Filter> SortFilterProxyModel::filters
 
     This property holds the list of filters for this proxy model. To be included in the model, a row of the source model has to be accepted by all the top level filters of this list.
 
+    A row is rejected as soon as one filter rejects it. The filters are evaluated in the order measured to be the fastest,
+    starting with the ones cheapest to evaluate and rejecting the most rows, the same rows are accepted as with the declaration order.
+    The filters with side effects, like an \l ExpressionFilter that isn't \l {ExpressionFilter::pure} {pure}, keep their declared position.
+    The filters of an \l AllOf or an \l AnyOf are evaluated the same way.
+
     \sa Filter, FilterContainer
 */
 
@@ -207,31 +296,85 @@ void QQmlSortFilterProxyModel::classBegin()
 void QQmlSortFilterProxyModel::componentComplete()
 {
     m_completed = true;
+    completeComponents();
 
+    invalidate();
+    sort(0);
+}
+
+void QQmlSortFilterProxyModel::completeComponents()
+{
     for (const auto& filter : m_filters)
         filter->proxyModelCompleted(*this);
     for (const auto& sorter : m_sorters)
         sorter->proxyModelCompleted(*this);
     for (const auto& proxyRole : m_proxyRoles)
         proxyRole->proxyModelCompleted(*this);
-
-    invalidate();
-    sort(0);
 }
 
 QVariant QQmlSortFilterProxyModel::sourceData(const QModelIndex& sourceIndex, const QString& roleName) const
 {
-    int role = roleNames().key(roleName.toUtf8());
+    auto it = m_roleForName.constFind(roleName);
+    if (it != m_roleForName.constEnd())
+        return sourceData(sourceIndex, it.value());
+    int role = m_roleNames.isEmpty() ? roleNames().key(roleName.toUtf8()) : 0;
     return sourceData(sourceIndex, role);
 }
 
 QVariant QQmlSortFilterProxyModel::sourceData(const QModelIndex &sourceIndex, int role) const
 {
-    QPair<ProxyRole*, QString> proxyRolePair = m_proxyRoleMap[role];
-    if (ProxyRole* proxyRole = proxyRolePair.first)
-        return proxyRole->roleData(sourceIndex, *this, proxyRolePair.second);
-    else
-        return sourceModel()->data(sourceIndex, role);
+    // the roles already read for the row being evaluated
+    QVariant data;
+    if (m_rowCache.lookup(sourceIndex, role, data))
+        return data;
+
+    // proxy roles are numbered right after the source roles, other roles are forwarded without any lookup
+    const int slot = role - m_firstProxyRole;
+    if (slot >= 0 && slot < m_proxyRoleSlots.size()) {
+        const ProxyRoleSlot& proxyRoleSlot = m_proxyRoleSlots.at(slot);
+        // the filters of a SwitchRole or a FilterRole, or an ExpressionRole, often read the same roles
+        RowCache::Scope scope(m_rowCache, sourceIndex);
+        // a proxy role read while another one is computed can depend on it, and get an undefined value if they read each other
+        const bool reentrant = m_proxyRoleDepth > 0;
+        ++m_proxyRoleDepth;
+        if (Q_UNLIKELY(m_statistics->enabled())) {
+            QElapsedTimer timer;
+            timer.start();
+            data = proxyRoleSlot.proxyRole->roleData(sourceIndex, *this, proxyRoleSlot.name);
+            m_statistics->recordProxyRole(proxyRoleSlot.proxyRole, timer.nsecsElapsed());
+        } else {
+            data = proxyRoleSlot.proxyRole->roleData(sourceIndex, *this, proxyRoleSlot.name);
+        }
+        --m_proxyRoleDepth;
+        if (!reentrant)
+            m_rowCache.store(sourceIndex, role, data);
+        return data;
+    }
+    if (Q_UNLIKELY(m_statistics->enabled()))
+        m_statistics->recordSourceData(role);
+    if (Q_UNLIKELY(m_planAnalysis))
+        ++m_planAnalysis->dataCalls;
+    data = sourceModel()->data(sourceIndex, role);
+    m_rowCache.store(sourceIndex, role, data);
+    return data;
+}
+
+/*
+    Returns the context in which the expressions of the components declared in parentContext are evaluated,
+    shared by all the expression filters, sorters and proxy roles of the model.
+*/
+ExpressionContext* QQmlSortFilterProxyModel::expressionContext(QQmlContext* parentContext) const
+{
+    ExpressionContext*& context = m_expressionContexts[parentContext];
+    if (!context) {
+        context = new ExpressionContext(parentContext, const_cast<QQmlSortFilterProxyModel*>(this));
+        ExpressionContext* createdContext = context;
+        connect(parentContext, &QObject::destroyed, createdContext, [this, parentContext, createdContext] {
+            m_expressionContexts.remove(parentContext);
+            createdContext->deleteLater();
+        });
+    }
+    return context;
 }
 
 QVariant QQmlSortFilterProxyModel::data(const QModelIndex &index, int role) const
@@ -253,7 +396,62 @@ QHash<int, QByteArray> QQmlSortFilterProxyModel::roleNames() const
 
 int QQmlSortFilterProxyModel::roleForName(const QString& roleName) const
 {
-    return m_roleNames.key(roleName.toUtf8(), -1);
+    return m_roleForName.value(roleName, -1);
+}
+
+/*!
+    \qmlmethod int SortFilterProxyModel::findRow(string roleName, variant value)
+
+    Returns the first row of the proxy model with its data for \a roleName equal to \a value.
+    If no row is found, \c -1 is returned.
+
+    If \a roleName is in \l indexedRoleNames, the row is found without iterating over the whole model.
+*/
+int QQmlSortFilterProxyModel::findRow(const QString& roleName, const QVariant& value) const
+{
+    int role = roleForName(roleName);
+    if (!sourceModel() || role == -1)
+        return -1;
+
+    HashRoleIndex* roleIndex = hashIndex(roleName);
+    if (roleIndex && roleIndex->canFind(value, *sourceModel())) {
+        int foundRow = -1;
+        for (int sourceRow : roleIndex->sourceRows(HashRoleIndex::key(value), *sourceModel())) {
+            QModelIndex sourceIndex = sourceModel()->index(sourceRow, 0);
+            if (sourceModel()->data(sourceIndex, role) != value)
+                continue;
+            int row = mapFromSource(sourceIndex).row();
+            if (row != -1 && (foundRow == -1 || row < foundRow))
+                foundRow = row;
+        }
+        return foundRow;
+    }
+
+    for (int row = 0, count = rowCount(); row < count; ++row) {
+        if (data(index(row, 0), role) == value)
+            return row;
+    }
+    return -1;
+}
+
+/*
+    Returns the index of the values of the source model role named roleName,
+    or nullptr if this role isn't in indexedRoleNames.
+*/
+HashRoleIndex* QQmlSortFilterProxyModel::hashIndex(const QString& roleName) const
+{
+    auto it = m_hashIndexes.find(roleName);
+    return it != m_hashIndexes.end() ? &it.value() : nullptr;
+}
+
+/*
+    Returns the sorted index of the values of the source model role named roleName,
+    or nullptr if this role isn't in orderedIndexedRoleNames.
+*/
+OrderedRoleIndex* QQmlSortFilterProxyModel::orderedIndex(const QString& roleName) const
+{
+    auto it = m_orderedIndexes.find(roleName);
+    return it != m_orderedIndexes.end() ? &it.value() : nullptr;
 }
 
 /*!
@@ -282,6 +480,137 @@ QVariant QQmlSortFilterProxyModel::get(int row, const QString& roleName) const
     return data(index(row, 0), roleForName(roleName));
 }
 
+/*!
+    \qmlmethod object SortFilterProxyModel::explain()
+
+    Returns the plan followed by the model to filter, sort and compute the roles of its rows, without evaluating anything.
+    This helps tuning complex configurations, like deeply nested \l AllOf and \l AnyOf filters.
+
+    The plan is a tree of objects describing the model, its \l filters, \l sorters and \l proxyRoles.
+    Each node has the \c type and \c objectName of the object it describes, and its estimated \c cost
+    for a row: \c "constant", \c "role" (comparing role values), \c "text" (regular expression, collation or fuzzy matching)
+    or \c "script" (evaluating a JavaScript expression). A container costs as much as its most expensive child.
+
+    \list
+    \li Filters are listed in declaration order and tested in their evaluation \c order, see \l filters.
+        Their \c access is \c "rowList" when the rows they accept are looked up in a role index
+        (see \l indexedRoleNames and \l orderedIndexedRoleNames), and \c "rowScan" when every row is tested.
+        \c cached tells whether the results of the filter can be restored from a previous filtering pass.
+        The child filters of \l AllOf and \l AnyOf are listed in \c filters, in the order they are tested.
+    \li Sorters are applied in their \c order. Their \c access is \c "sortKey" when rows are compared with
+        precomputed keys, and \c "comparison" when the sorter compares each pair of rows.
+    \endlist
+
+    \sa analyze()
+*/
+QVariantMap QQmlSortFilterProxyModel::explain() const
+{
+    return plan(nullptr);
+}
+
+/*!
+    \qmlmethod object SortFilterProxyModel::analyze()
+
+    Returns the same plan as \l explain(), after running a full evaluation of every source row
+    and annotating each node with what it did.
+    The pass ignores the filtering results cached by the model and doesn't change its content.
+
+    Filters and proxy roles get \c rowsIn, the number of rows they were evaluated for, and filters \c rowsOut, the number of rows they accepted.
+    Sorters get \c comparisons, the number of pairs of rows they compared when sorting the accepted rows without the precomputed keys.
+    Every node gets its \c time in milliseconds and its \c dataCalls, the number of source model \c data() calls it made;
+    the time and calls of a container include those of its children.
+    Filters listing their rows from a role index also get \c listedRows and \c listingTime.
+
+    \note The pass evaluates every filter, sorter and proxy role, it can be slow for large models.
+
+    \sa explain()
+*/
+QVariantMap QQmlSortFilterProxyModel::analyze()
+{
+    if (!sourceModel())
+        return plan(nullptr);
+
+    PlanAnalysis analysis;
+    m_planAnalysis = &analysis;
+    QElapsedTimer timer;
+
+    QBitArray listedRows;
+    for (Filter* filter : m_filters) {
+        timer.start();
+        if (filter->acceptedSourceRows(*this, listedRows))
+            analysis.recordListing(filter, listedRows.count(true), timer.nsecsElapsed());
+    }
+
+    // every row is tested in the current evaluation order, stopping at the first rejecting filter like a filtering pass
+    const QVector<int> filterOrder = m_filterOrder.order(m_filters.size());
+    QVector<int> acceptedRows;
+    const int sourceRowCount = sourceModel()->rowCount();
+    const bool baseFiltering = m_filterValue.isValid() || !filterRegExp().isEmpty();
+    for (int row = 0; row < sourceRowCount; ++row) {
+        const QModelIndex sourceIndex = sourceModel()->index(row, 0);
+        RowCache::Scope scope(m_rowCache, sourceIndex);
+        if (baseFiltering) {
+            timer.start();
+            qint64 dataCalls = 0;
+            bool accepted = true;
+            if (m_filterValue.isValid()) {
+                ++dataCalls;
+                accepted = m_filterValue == sourceModel()->data(sourceIndex, filterRole());
+            }
+            if (accepted && !filterRegExp().isEmpty()) {
+                ++dataCalls;
+                accepted = QSortFilterProxyModel::filterAcceptsRow(row, QModelIndex());
+            }
+            analysis.record(&m_filterValue, accepted, timer.nsecsElapsed(), dataCalls);
+            if (!accepted)
+                continue;
+        }
+        bool accepted = std::all_of(filterOrder.begin(), filterOrder.end(),
+            [this, &sourceIndex] (int filterIndex) {
+                return m_filters.at(filterIndex)->filterAcceptsRow(sourceIndex, *this);
+            }
+        );
+        if (accepted)
+            acceptedRows.append(row);
+    }
+
+    // sorting steps are identified by their sorter, or by m_sortRoleName for the sortRoleName property
+    const int stepCount = sortStepCount();
+    const int sorterStepOffset = m_sortRoleName.isEmpty() ? 0 : 1;
+    std::stable_sort(acceptedRows.begin(), acceptedRows.end(),
+        [&] (int leftRow, int rightRow) {
+            const QModelIndex sourceLeft = sourceModel()->index(leftRow, 0);
+            const QModelIndex sourceRight = sourceModel()->index(rightRow, 0);
+            for (int step = 0; step < stepCount; ++step) {
+                const void* node = step < sorterStepOffset ? static_cast<const void*>(&m_sortRoleName) : sortChain().at(step - sorterStepOffset);
+                const qint64 dataCalls = analysis.dataCalls;
+                QElapsedTimer stepTimer;
+                stepTimer.start();
+                int comparison = compareSortStep(step, sourceLeft, sourceRight);
+                analysis.record(node, comparison != 0, stepTimer.nsecsElapsed(), analysis.dataCalls - dataCalls);
+                if (comparison != 0)
+                    return comparison < 0;
+            }
+            return leftRow < rightRow;
+        }
+    );
+
+    for (int slot = 0; slot < m_proxyRoleSlots.size(); ++slot) {
+        ProxyRole* proxyRole = m_proxyRoleSlots.at(slot).proxyRole;
+        for (int row : acceptedRows) {
+            const qint64 dataCalls = analysis.dataCalls;
+            timer.start();
+            sourceData(sourceModel()->index(row, 0), m_firstProxyRole + slot);
+            analysis.record(proxyRole, true, timer.nsecsElapsed(), analysis.dataCalls - dataCalls);
+        }
+    }
+
+    m_planAnalysis = nullptr;
+    QVariantMap result = plan(&analysis);
+    result.insert(QStringLiteral("acceptedRows"), acceptedRows.size());
+    return result;
+}
+
 /*!
     \qmlmethod index SortFilterProxyModel::mapToSource(index proxyIndex)
 
@@ -335,12 +664,18 @@ bool QQmlSortFilterProxyModel::filterAcceptsRow(int source_row, const QModelInde
 {
     if (!m_completed)
         return true;
+    // the result of this row is already known from a previous filtering pass
+    if (!source_parent.isValid() && source_row < m_knownSourceRows.size() && m_knownSourceRows.testBit(source_row))
+        return m_knownAcceptedSourceRows.testBit(source_row);
     QModelIndex sourceIndex = sourceModel()->index(source_row, 0, source_parent);
+    // the filters reading the same roles of the row share their values
+    RowCache::Scope scope(m_rowCache, sourceIndex);
     bool valueAccepted = !m_filterValue.isValid() || ( m_filterValue == sourceModel()->data(sourceIndex, filterRole()) );
     bool baseAcceptsRow = valueAccepted && QSortFilterProxyModel::filterAcceptsRow(source_row, source_parent);
-    baseAcceptsRow = baseAcceptsRow && std::all_of(m_filters.begin(), m_filters.end(),
-        [=, &source_parent] (Filter* filter) {
-            return filter->filterAcceptsRow(sourceIndex, *this);
+    // the filters are evaluated in the order measured to be the fastest, which accepts the same rows as the declaration order
+    baseAcceptsRow = baseAcceptsRow && m_filterOrder.evaluate(m_filters, false,
+        [this, &sourceIndex] (Filter* filter) {
+            return evaluateFilter(filter, sourceIndex);
         }
     );
     return baseAcceptsRow;
@@ -348,25 +683,27 @@ bool QQmlSortFilterProxyModel::filterAcceptsRow(int source_row, const QModelInde
 
 bool QQmlSortFilterProxyModel::lessThan(const QModelIndex& source_left, const QModelIndex& source_right) const
 {
+    if (Q_UNLIKELY(m_statistics->enabled()))
+        m_statistics->recordComparison();
     if (m_completed) {
-        if (!m_sortRoleName.isEmpty()) {
-            if (QSortFilterProxyModel::lessThan(source_left, source_right))
-                return m_ascendingSortOrder;
-            if (QSortFilterProxyModel::lessThan(source_right, source_left))
-                return !m_ascendingSortOrder;
+        int step = 0;
+        // the leading steps of the sort chain are compared at once with the keys of the rows, encoded when they are first compared.
+        // encoding the right key can drop steps from all the keys, the left one is then encoded again
+        if (m_sortKeysValid && !source_left.parent().isValid() && !source_right.parent().isValid()
+                && encodeSortKey(source_left.row()) && encodeSortKey(source_right.row()) && encodeSortKey(source_left.row())) {
+            const SortKeySpan& left = m_sortKeySpans.at(source_left.row());
+            const SortKeySpan& right = m_sortKeySpans.at(source_right.row());
+            const char* data = m_sortKeyData.constData();
+            int comparison = SortKey::compare(data + left.offset, left.size, data + right.offset, right.size);
+            if (comparison != 0 || m_sortKeysComplete)
+                return comparison < 0;
+            step = m_sortKeyStepCount;
         }
-        auto sortedSorters = m_sorters;
-        std::stable_sort(sortedSorters.begin(),
-                         sortedSorters.end(),
-                         [] (Sorter* a, Sorter* b) {
-                             return a->priority() > b->priority();
-                         });
-        for(auto sorter : sortedSorters) {
-            if (sorter->enabled()) {
-                int comparison = sorter->compareRows(source_left, source_right, *this);
-                if (comparison != 0)
-                    return comparison < 0;
-            }
+        const int stepCount = sortStepCount();
+        for (; step < stepCount; ++step) {
+            int comparison = compareSortStep(step, source_left, source_right);
+            if (comparison != 0)
+                return comparison < 0;
         }
     }
     return source_left.row() < source_right.row();
@@ -384,17 +721,98 @@ void QQmlSortFilterProxyModel::setSourceModel(QAbstractItemModel *sourceModel)
         // QTBUG-57971
         connect(sourceModel, &QAbstractItemModel::rowsInserted, this, &QQmlSortFilterProxyModel::initRoles);
     }
+
+    for (const auto& connection : m_sourceConnections)
+        disconnect(connection);
+    m_sourceConnections.clear();
+    clearFilterResults();
+    clearSortKeys();
+    if (sourceModel) {
+        // previous filtering results are only valid as long as the source model doesn't change
+        m_sourceConnections = {
+            connect(sourceModel, &QAbstractItemModel::dataChanged, this, &QQmlSortFilterProxyModel::clearFilterResults),
+            connect(sourceModel, &QAbstractItemModel::rowsInserted, this, &QQmlSortFilterProxyModel::clearFilterResults),
+            connect(sourceModel, &QAbstractItemModel::rowsRemoved, this, &QQmlSortFilterProxyModel::clearFilterResults),
+            connect(sourceModel, &QAbstractItemModel::rowsMoved, this, &QQmlSortFilterProxyModel::clearFilterResults),
+            connect(sourceModel, &QAbstractItemModel::layoutChanged, this, &QQmlSortFilterProxyModel::clearFilterResults),
+            connect(sourceModel, &QAbstractItemModel::modelReset, this, &QQmlSortFilterProxyModel::clearFilterResults),
+            connect(sourceModel, &QAbstractItemModel::dataChanged, this, &QQmlSortFilterProxyModel::onSourceDataChanged),
+            connect(sourceModel, &QAbstractItemModel::rowsInserted, this, &QQmlSortFilterProxyModel::onSourceRowsInserted),
+            connect(sourceModel, &QAbstractItemModel::rowsRemoved, this, &QQmlSortFilterProxyModel::onSourceRowsRemoved),
+            connect(sourceModel, &QAbstractItemModel::rowsMoved, this, &QQmlSortFilterProxyModel::invalidateRoleIndexes),
+            connect(sourceModel, &QAbstractItemModel::layoutChanged, this, &QQmlSortFilterProxyModel::invalidateRoleIndexes),
+            connect(sourceModel, &QAbstractItemModel::modelReset, this, &QQmlSortFilterProxyModel::invalidateRoleIndexes),
+            connect(sourceModel, &QAbstractItemModel::rowsMoved, this, &QQmlSortFilterProxyModel::clearSortKeys),
+            connect(sourceModel, &QAbstractItemModel::layoutChanged, this, &QQmlSortFilterProxyModel::clearSortKeys),
+            connect(sourceModel, &QAbstractItemModel::modelReset, this, &QQmlSortFilterProxyModel::clearSortKeys),
+            connect(sourceModel, &QAbstractItemModel::rowsInserted, this, &QQmlSortFilterProxyModel::onSourceRowsChanged),
+            connect(sourceModel, &QAbstractItemModel::rowsRemoved, this, &QQmlSortFilterProxyModel::onSourceRowsChanged),
+            connect(sourceModel, &QAbstractItemModel::rowsMoved, this, &QQmlSortFilterProxyModel::onSourceRowsChanged),
+            connect(sourceModel, &QAbstractItemModel::layoutChanged, this, &QQmlSortFilterProxyModel::onSourceRowsChanged),
+            connect(sourceModel, &QAbstractItemModel::modelReset, this, &QQmlSortFilterProxyModel::onSourceRowsChanged)
+        };
+    }
     QSortFilterProxyModel::setSourceModel(sourceModel);
+    if (sourceModel) {
+        // connected after QSortFilterProxyModel's own handlers, so that its mapping already includes the changes
+        m_sourceConnections << connect(sourceModel, &QAbstractItemModel::rowsInserted, this, &QQmlSortFilterProxyModel::onSourceRowsShifted)
+                            << connect(sourceModel, &QAbstractItemModel::rowsRemoved, this, &QQmlSortFilterProxyModel::onSourceRowsShifted);
+    }
 }
 
 void QQmlSortFilterProxyModel::queueInvalidateFilter()
 {
+    traceQueue("queueInvalidateFilter", m_invalidateFilterQueued || m_invalidateQueued, m_invalidateFilterCause);
+    m_filterNarrowing = false;
+    m_filterWidening = false;
+    if (m_delayed) {
+        if (!m_invalidateFilterQueued && !m_invalidateQueued) {
+            m_invalidateFilterQueued = true;
+            QMetaObject::invokeMethod(this, "invalidateFilter", Qt::QueuedConnection);
+        }
+    } else {
+        invalidateFilter();
+    }
+}
+
+/*
+    Called when the filters can only reject rows that are currently accepted,
+    the rows already filtered out are then not tested again.
+*/
+void QQmlSortFilterProxyModel::queueNarrowFilter()
+{
+    traceQueue("queueNarrowFilter", m_invalidateFilterQueued || m_invalidateQueued, m_invalidateFilterCause);
+    // a narrowing after a pending widening can change any row
+    m_filterWidening = false;
+    if (m_delayed) {
+        if (!m_invalidateFilterQueued && !m_invalidateQueued) {
+            m_invalidateFilterQueued = true;
+            m_filterNarrowing = true;
+            QMetaObject::invokeMethod(this, "invalidateFilter", Qt::QueuedConnection);
+        }
+    } else {
+        m_filterNarrowing = true;
+        invalidateFilter();
+    }
+}
+
+/*
+    Called when the filters can only accept rows that are currently rejected,
+    the rows already accepted are then not tested again.
+*/
+void QQmlSortFilterProxyModel::queueWidenFilter()
+{
+    traceQueue("queueWidenFilter", m_invalidateFilterQueued || m_invalidateQueued, m_invalidateFilterCause);
+    // a widening after a pending narrowing can change any row
+    m_filterNarrowing = false;
     if (m_delayed) {
         if (!m_invalidateFilterQueued && !m_invalidateQueued) {
             m_invalidateFilterQueued = true;
+            m_filterWidening = true;
             QMetaObject::invokeMethod(this, "invalidateFilter", Qt::QueuedConnection);
         }
     } else {
+        m_filterWidening = true;
         invalidateFilter();
     }
 }
@@ -402,12 +820,34 @@ void QQmlSortFilterProxyModel::queueInvalidateFilter()
 void QQmlSortFilterProxyModel::invalidateFilter()
 {
     m_invalidateFilterQueued = false;
-    if (m_completed && !m_invalidateQueued)
-        QSortFilterProxyModel::invalidateFilter();
+    if (m_completed && !m_invalidateQueued) {
+        Statistics::InvalidationRecorder recorder(m_statistics, Statistics::FilterInvalidation);
+        Tracer::Scope scope(this, "filterInvalidation", m_invalidateFilterCause);
+        {
+            Tracer::Scope phase(this, "beginFilterPass");
+            beginFilterPass();
+        }
+        {
+            // filters the rows and notifies the views of the removed and inserted ones
+            Tracer::Scope phase(this, "QSortFilterProxyModel::invalidateFilter");
+            QSortFilterProxyModel::invalidateFilter();
+        }
+        {
+            Tracer::Scope phase(this, "endFilterPass");
+            endFilterPass();
+        }
+    }
+    m_invalidateFilterCause.clear();
 }
 
 void QQmlSortFilterProxyModel::queueInvalidate()
 {
+    traceQueue("queueInvalidate", m_invalidateQueued, m_invalidateCause);
+    // the sorters or their order might have changed, the rows are compared the slow way until the next invalidation
+    clearSortKeys();
+    m_sortChainValid = false;
+    m_filterNarrowing = false;
+    m_filterWidening = false;
     if (m_delayed) {
         if (!m_invalidateQueued) {
             m_invalidateQueued = true;
@@ -421,29 +861,68 @@ void QQmlSortFilterProxyModel::queueInvalidate()
 void QQmlSortFilterProxyModel::invalidate()
 {
     m_invalidateQueued = false;
-    if (m_completed)
-        QSortFilterProxyModel::invalidate();
+    if (m_completed) {
+        Statistics::InvalidationRecorder recorder(m_statistics, Statistics::SortInvalidation);
+        Tracer::Scope scope(this, "sortInvalidation", m_invalidateCause);
+        {
+            Tracer::Scope phase(this, "buildSortKeys");
+            buildSortKeys();
+        }
+        {
+            Tracer::Scope phase(this, "beginFilterPass");
+            beginFilterPass();
+        }
+        {
+            // notifies the views of the layout change, the rows are filtered and sorted again when they are next accessed
+            Tracer::Scope phase(this, "QSortFilterProxyModel::invalidate");
+            QSortFilterProxyModel::invalidate();
+        }
+        {
+            Tracer::Scope phase(this, "endFilterPass");
+            endFilterPass();
+        }
+    }
+    m_invalidateCause.clear();
 }
 
 void QQmlSortFilterProxyModel::updateRoleNames()
 {
     if (!sourceModel())
         return;
+    const QHash<int, QByteArray> previousRoleNames = m_roleNames;
     m_roleNames = sourceModel()->roleNames();
-    m_proxyRoleMap.clear();
+    clearFilterResults();
+    updateRoleIndexes();
+    m_proxyRoleSlots.clear();
     m_proxyRoleNumbers.clear();
 
     auto roles = m_roleNames.keys();
     auto maxIt = std::max_element(roles.cbegin(), roles.cend());
     int maxRole = maxIt != roles.cend() ? *maxIt : -1;
+    m_firstProxyRole = maxRole + 1;
     for (auto proxyRole : m_proxyRoles) {
         for (auto roleName : proxyRole->names()) {
             ++maxRole;
             m_roleNames[maxRole] = roleName.toUtf8();
-            m_proxyRoleMap[maxRole] = {proxyRole, roleName};
+            m_proxyRoleSlots.append({proxyRole, roleName});
             m_proxyRoleNumbers.append(maxRole);
         }
     }
+
+    // filters and sorters look their role up by name for every row, without converting the name to UTF-8
+    m_roleForName.clear();
+    for (auto it = m_roleNames.cbegin(); it != m_roleNames.cend(); ++it) {
+        QString roleName = QString::fromUtf8(it.value());
+        if (!m_roleForName.contains(roleName))
+            m_roleForName.insert(roleName, it.key());
+    }
+
+    for (auto proxyRole : m_proxyRoles)
+        proxyRole->roleNumbersChanged();
+
+    // the components resolving the role names when the model is completed, like the expressions compiled natively, resolve them again
+    if (m_completed && m_roleNames != previousRoleNames)
+        completeComponents();
 }
 
 void QQmlSortFilterProxyModel::updateFilterRole()
@@ -460,6 +939,8 @@ void QQmlSortFilterProxyModel::updateSortRole()
     QList<int> sortRoles = roleNames().keys(m_sortRoleName.toUtf8());
     if (!sortRoles.empty())
     {
+        // setSortRole() sorts again right away
+        clearSortKeys();
         setSortRole(sortRoles.first());
         queueInvalidate();
     }
@@ -487,6 +968,8 @@ void QQmlSortFilterProxyModel::onDataChanged(const QModelIndex& topLeft, const Q
 
 void QQmlSortFilterProxyModel::queueInvalidateProxyRoles()
 {
+    traceQueue("queueInvalidateProxyRoles", m_invalidateProxyRolesQueued, m_invalidateProxyRolesCause);
+    clearFilterResults();
     queueInvalidate();
     if (m_delayed) {
         if (!m_invalidateProxyRolesQueued) {
@@ -501,8 +984,124 @@ void QQmlSortFilterProxyModel::queueInvalidateProxyRoles()
 void QQmlSortFilterProxyModel::invalidateProxyRoles()
 {
     m_invalidateProxyRolesQueued = false;
-    if (m_completed)
+    if (m_completed) {
+        Statistics::InvalidationRecorder recorder(m_statistics, Statistics::ProxyRoleInvalidation);
+        Tracer::Scope scope(this, "proxyRoleInvalidation", m_invalidateProxyRolesCause);
         Q_EMIT dataChanged(index(0,0), index(rowCount() - 1, columnCount() - 1), m_proxyRoleNumbers);
+    }
+    m_invalidateProxyRolesCause.clear();
+}
+
+void QQmlSortFilterProxyModel::clearFilterResults()
+{
+    m_filterResults.clear();
+}
+
+void QQmlSortFilterProxyModel::updateRoleIndexes()
+{
+    m_hashIndexes.clear();
+    m_orderedIndexes.clear();
+    if (!sourceModel())
+        return;
+
+    QHash<int, QByteArray> sourceRoleNames = sourceModel()->roleNames();
+    for (const QString& roleName : m_indexedRoleNames) {
+        int role = sourceRoleNames.key(roleName.toUtf8(), -1);
+        if (role != -1)
+            m_hashIndexes.insert(roleName, HashRoleIndex(role));
+    }
+    for (const QString& roleName : m_orderedIndexedRoleNames) {
+        int role = sourceRoleNames.key(roleName.toUtf8(), -1);
+        if (role != -1)
+            m_orderedIndexes.insert(roleName, OrderedRoleIndex(role));
+    }
+}
+
+void QQmlSortFilterProxyModel::invalidateRoleIndexes()
+{
+    for (HashRoleIndex& roleIndex : m_hashIndexes)
+        roleIndex.invalidate();
+    for (OrderedRoleIndex& roleIndex : m_orderedIndexes)
+        roleIndex.invalidate();
+}
+
+void QQmlSortFilterProxyModel::onSourceDataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight, const QVector<int>& roles)
+{
+    traceSourceSignal();
+    m_rowCache.clear();
+    for (ProxyRole* proxyRole : m_proxyRoles)
+        proxyRole->sourceDataChanged(topLeft, bottomRight, roles, *this);
+
+    if (topLeft.parent().isValid())
+        return;
+
+    // sorters can use proxy roles depending on any source role, the keys of the changed rows are always encoded again
+    for (int row = topLeft.row(); row <= bottomRight.row() && row < m_sortKeySpans.size(); ++row)
+        m_sortKeySpans[row] = SortKeySpan();
+
+    for (HashRoleIndex& roleIndex : m_hashIndexes) {
+        if (roles.isEmpty() || roles.contains(roleIndex.role()))
+            roleIndex.updateRows(*sourceModel(), topLeft.row(), bottomRight.row());
+    }
+    for (OrderedRoleIndex& roleIndex : m_orderedIndexes) {
+        if (roles.isEmpty() || roles.contains(roleIndex.role()))
+            roleIndex.updateRows(*sourceModel(), topLeft.row(), bottomRight.row());
+    }
+}
+
+void QQmlSortFilterProxyModel::onSourceRowsInserted(const QModelIndex& parent, int first, int last)
+{
+    if (parent.isValid())
+        return;
+
+    // the keys are stored by row and end with their row number, the keys of the following rows are encoded again
+    if (first < m_sortKeySpans.size())
+        m_sortKeySpans.resize(first);
+
+    for (HashRoleIndex& roleIndex : m_hashIndexes)
+        roleIndex.insertRows(*sourceModel(), first, last);
+    for (OrderedRoleIndex& roleIndex : m_orderedIndexes)
+        roleIndex.insertRows(*sourceModel(), first, last);
+}
+
+void QQmlSortFilterProxyModel::onSourceRowsRemoved(const QModelIndex& parent, int first, int last)
+{
+    if (parent.isValid())
+        return;
+
+    if (first < m_sortKeySpans.size())
+        m_sortKeySpans.resize(first);
+
+    for (HashRoleIndex& roleIndex : m_hashIndexes)
+        roleIndex.removeRows(first, last);
+    for (OrderedRoleIndex& roleIndex : m_orderedIndexes)
+        roleIndex.removeRows(first, last);
+}
+
+void QQmlSortFilterProxyModel::onSourceRowsChanged()
+{
+    traceSourceSignal();
+    m_rowCache.clear();
+    for (ProxyRole* proxyRole : m_proxyRoles)
+        proxyRole->sourceRowsChanged();
+}
+
+/*
+    QSortFilterProxyModel only filters the inserted rows, the other rows can enter or leave the slice of an IndexFilter.
+    Such filters list their accepted rows without testing them, so only the rows in their slice are tested again.
+*/
+void QQmlSortFilterProxyModel::onSourceRowsShifted(const QModelIndex& parent, int first)
+{
+    if (!m_completed || parent.isValid())
+        return;
+
+    bool positional = std::any_of(m_filters.begin(), m_filters.end(),
+        [=] (Filter* filter) {
+            return filter->dependsOnRowPositions(first);
+        }
+    );
+    if (positional)
+        queueInvalidateFilter();
 }
 
 QVariantMap QQmlSortFilterProxyModel::modelDataMap(const QModelIndex& modelIndex) const
@@ -514,20 +1113,424 @@ QVariantMap QQmlSortFilterProxyModel::modelDataMap(const QModelIndex& modelIndex
     return map;
 }
 
+/*
+    Records the request of an invalidation and whether it is done right away, queued, or coalesced with a queued one.
+    The object and signal that requested it are kept in cause, until the invalidation is done.
+*/
+void QQmlSortFilterProxyModel::traceQueue(const char* name, bool alreadyQueued, QString& cause)
+{
+    if (Q_LIKELY(!Tracer::isEnabled()))
+        return;
+    QString requester = Tracer::describe(sender(), senderSignalIndex());
+    if (!m_delayed || !alreadyQueued)
+        cause = requester;
+    Tracer::instant(this, "queue", name, requester, !m_delayed ? "immediate" : alreadyQueued ? "coalesced" : "queued");
+}
+
+void QQmlSortFilterProxyModel::traceSourceSignal()
+{
+    if (Q_UNLIKELY(Tracer::isEnabled()))
+        Tracer::instant(this, "source", "sourceSignal", Tracer::describe(sender(), senderSignalIndex()));
+}
+
+// the description of the model returned by explain() and analyze()
+QVariantMap QQmlSortFilterProxyModel::plan(const PlanAnalysis* analysis) const
+{
+    QVariantMap plan {
+        {QStringLiteral("type"), Plan::qmlTypeName(this)},
+        {QStringLiteral("objectName"), objectName()},
+        {QStringLiteral("sourceRows"), sourceModel() ? sourceModel()->rowCount() : 0},
+        {QStringLiteral("rows"), rowCount()},
+        {QStringLiteral("cachedFilterResults"), m_filterResults.size()},
+        {QStringLiteral("indexedRoleNames"), m_indexedRoleNames},
+        {QStringLiteral("orderedIndexedRoleNames"), m_orderedIndexedRoleNames}
+    };
+
+    // filterValue and filterPattern are tested before the filters
+    if (m_filterValue.isValid() || !filterRegExp().isEmpty()) {
+        QVariantMap baseFilter {
+            {QStringLiteral("type"), QStringLiteral("filterRoleName")},
+            {QStringLiteral("roleName"), m_filterRoleName},
+            {QStringLiteral("cost"), Plan::costClassName(filterRegExp().isEmpty() ? CostClass::Role : CostClass::Text)},
+            {QStringLiteral("access"), QStringLiteral("rowScan")}
+        };
+        if (analysis)
+            analysis->annotate(baseFilter, &m_filterValue, QStringLiteral("rowsIn"), true);
+        plan.insert(QStringLiteral("baseFilter"), baseFilter);
+    }
+
+    QVariantList filters;
+    QBitArray listedRows;
+    const QVector<int> filterOrder = m_filterOrder.order(m_filters.size());
+    for (int i = 0; i < m_filters.size(); ++i) {
+        Filter* filter = m_filters.at(i);
+        QVariantMap filterPlan = filter->explain(*this, analysis);
+        filterPlan.insert(QStringLiteral("order"), filterOrder.indexOf(i));
+        if (sourceModel() && filter->acceptedSourceRows(*this, listedRows))
+            filterPlan.insert(QStringLiteral("access"), QStringLiteral("rowList"));
+        filters.append(filterPlan);
+    }
+    plan.insert(QStringLiteral("filters"), filters);
+
+    QVariantList sorters;
+    int step = 0;
+    auto sortAccess = [this] (int sortStep) {
+        return m_sortKeysValid && sortStep < m_sortKeyStepCount ? QStringLiteral("sortKey") : QStringLiteral("comparison");
+    };
+    if (!m_sortRoleName.isEmpty()) {
+        QVariantMap sortRolePlan {
+            {QStringLiteral("type"), QStringLiteral("sortRoleName")},
+            {QStringLiteral("roleName"), m_sortRoleName},
+            {QStringLiteral("sortOrder"), m_ascendingSortOrder ? QStringLiteral("ascending") : QStringLiteral("descending")},
+            {QStringLiteral("cost"), Plan::costClassName(CostClass::Role)},
+            {QStringLiteral("order"), step},
+            {QStringLiteral("access"), sortAccess(step)}
+        };
+        if (analysis)
+            analysis->annotate(sortRolePlan, &m_sortRoleName, QStringLiteral("comparisons"), false);
+        sorters.append(sortRolePlan);
+        ++step;
+    }
+    for (Sorter* sorter : sortChain()) {
+        QVariantMap sorterPlan = sorter->explain(*this, analysis);
+        sorterPlan.insert(QStringLiteral("order"), step);
+        sorterPlan.insert(QStringLiteral("access"), sortAccess(step));
+        sorters.append(sorterPlan);
+        ++step;
+    }
+    // disabled sorters aren't in the sort chain, they are listed last without an order
+    for (Sorter* sorter : m_sorters) {
+        if (!sorter->enabled())
+            sorters.append(sorter->explain(*this, analysis));
+    }
+    plan.insert(QStringLiteral("sorters"), sorters);
+
+    QVariantList proxyRoles;
+    for (ProxyRole* proxyRole : m_proxyRoles)
+        proxyRoles.append(proxyRole->explain(*this, analysis));
+    plan.insert(QStringLiteral("proxyRoles"), proxyRoles);
+
+    return plan;
+}
+
+bool QQmlSortFilterProxyModel::evaluateFilter(Filter* filter, const QModelIndex& sourceIndex) const
+{
+    if (Q_LIKELY(!m_statistics->enabled()))
+        return filter->filterAcceptsRow(sourceIndex, *this);
+    QElapsedTimer timer;
+    timer.start();
+    bool accepted = filter->filterAcceptsRow(sourceIndex, *this);
+    m_statistics->recordFilter(filter, accepted, timer.nsecsElapsed());
+    return accepted;
+}
+
+/*
+    Identifies the current filtering configuration of the model, or returns an invalid QVariant
+    if one of its filters can't be identified. Rows accepted with a given key are stored in m_filterResults.
+*/
+QVariant QQmlSortFilterProxyModel::filterResultsKey() const
+{
+    QRegExp regExp = filterRegExp();
+    QVariantList key { m_filterValue, filterRole(), regExp.pattern(), regExp.patternSyntax(), regExp.caseSensitivity() };
+    for (Filter* filter : m_filters) {
+        QVariant filterKey = filter->cacheKey();
+        if (!filterKey.isValid())
+            return QVariant();
+        key.append(filterKey);
+    }
+    return key;
+}
+
+QBitArray QQmlSortFilterProxyModel::acceptedSourceRows() const
+{
+    QBitArray rows(sourceModel()->rowCount());
+    for (int row = 0, count = rowCount(); row < count; ++row) {
+        int sourceRow = mapToSource(index(row, 0)).row();
+        if (sourceRow >= 0 && sourceRow < rows.size())
+            rows.setBit(sourceRow);
+    }
+    return rows;
+}
+
+void QQmlSortFilterProxyModel::beginFilterPass()
+{
+    if (!sourceModel())
+        return;
+
+    QVariant key = filterResultsKey();
+    const int sourceRowCount = sourceModel()->rowCount();
+    if (key.isValid()) {
+        for (int i = 0; i < m_filterResults.size(); ++i) {
+            if (m_filterResults.at(i).first == key && m_filterResults.at(i).second.size() == sourceRowCount) {
+                m_filterResults.move(i, 0);
+                m_knownSourceRows.fill(true, sourceRowCount);
+                m_knownAcceptedSourceRows = m_filterResults.first().second;
+                return;
+            }
+        }
+    }
+
+    if (m_filterWidening) {
+        // rows accepted before are still accepted, only the rejected ones need to be tested again
+        m_knownSourceRows = acceptedSourceRows();
+        m_knownAcceptedSourceRows = m_knownSourceRows;
+        return;
+    }
+
+    // rows rejected before are still rejected, only the accepted ones need to be tested again
+    m_knownSourceRows = m_filterNarrowing ? ~acceptedSourceRows() : QBitArray(sourceRowCount);
+    m_knownAcceptedSourceRows.fill(false, sourceRowCount);
+
+    // rows rejected by a filter that can list the rows it accepts (from a role index) don't need to be tested either
+    QBitArray filterAcceptedRows;
+    QBitArray acceptedRows(sourceRowCount, true);
+    bool allRowsKnown = !m_filterValue.isValid() && filterRegExp().isEmpty();
+    for (Filter* filter : m_filters) {
+        if (filter->acceptedSourceRows(*this, filterAcceptedRows)) {
+            m_knownSourceRows |= ~filterAcceptedRows;
+            acceptedRows &= filterAcceptedRows;
+        } else if (filter->enabled()) {
+            allRowsKnown = false;
+        }
+    }
+
+    // if all the filters could do so, no row needs to be tested at all
+    if (allRowsKnown) {
+        m_knownSourceRows.fill(true, sourceRowCount);
+        m_knownAcceptedSourceRows = acceptedRows;
+    }
+}
+
+void QQmlSortFilterProxyModel::endFilterPass()
+{
+    m_filterNarrowing = false;
+    m_filterWidening = false;
+    if (!sourceModel())
+        return;
+
+    // QSortFilterProxyModel::invalidate() only rebuilds its mapping lazily, this forces it while the known rows are still set
+    QBitArray acceptedRows = acceptedSourceRows();
+    m_knownSourceRows.clear();
+    m_knownAcceptedSourceRows.clear();
+
+    QVariant key = filterResultsKey();
+    if (!key.isValid())
+        return;
+
+    for (int i = 0; i < m_filterResults.size(); ++i) {
+        if (m_filterResults.at(i).first == key) {
+            m_filterResults.removeAt(i);
+            break;
+        }
+    }
+    m_filterResults.prepend({key, acceptedRows});
+    while (m_filterResults.size() > FilterResultsCacheSize)
+        m_filterResults.removeLast();
+}
+
+// the sorting steps in the order they are applied: the sortRoleName property, then the enabled sorters by priority
+const QList<Sorter*>& QQmlSortFilterProxyModel::sortChain() const
+{
+    if (!m_sortChainValid) {
+        m_sortChain.clear();
+        for (Sorter* sorter : m_sorters) {
+            if (sorter->enabled())
+                m_sortChain.append(sorter);
+        }
+        std::stable_sort(m_sortChain.begin(),
+                         m_sortChain.end(),
+                         [] (Sorter* a, Sorter* b) {
+                             return a->priority() > b->priority();
+                         });
+        m_sortChainValid = true;
+    }
+    return m_sortChain;
+}
+
+int QQmlSortFilterProxyModel::sortStepCount() const
+{
+    return (m_sortRoleName.isEmpty() ? 0 : 1) + sortChain().size();
+}
+
+int QQmlSortFilterProxyModel::compareSortStep(int step, const QModelIndex& source_left, const QModelIndex& source_right) const
+{
+    if (!m_sortRoleName.isEmpty()) {
+        if (step == 0) {
+            if (QSortFilterProxyModel::lessThan(source_left, source_right))
+                return m_ascendingSortOrder ? -1 : 1;
+            if (QSortFilterProxyModel::lessThan(source_right, source_left))
+                return m_ascendingSortOrder ? 1 : -1;
+            return 0;
+        }
+        --step;
+    }
+    Sorter* sorter = sortChain().at(step);
+    if (Q_LIKELY(!m_statistics->enabled()))
+        return sorter->compareRows(source_left, source_right, *this);
+    QElapsedTimer timer;
+    timer.start();
+    int comparison = sorter->compareRows(source_left, source_right, *this);
+    m_statistics->recordSorter(sorter, timer.nsecsElapsed());
+    return comparison;
+}
+
+bool QQmlSortFilterProxyModel::appendSortKey(int step, const QModelIndex& sourceIndex, QByteArray& key) const
+{
+    if (!m_sortRoleName.isEmpty()) {
+        if (step == 0) {
+            QVariant value = sourceModel()->data(sourceIndex, sortRole());
+            // QSortFilterProxyModel can compare strings case insensitively or with the locale
+            if (value.type() == QVariant::String && (sortCaseSensitivity() != Qt::CaseSensitive || isSortLocaleAware()))
+                return false;
+            const int size = key.size();
+            if (!SortKey::appendValue(key, value))
+                return false;
+            if (!m_ascendingSortOrder)
+                SortKey::invert(key, size);
+            return true;
+        }
+        --step;
+    }
+    Sorter* sorter = sortChain().at(step);
+    if (Q_LIKELY(!m_statistics->enabled()))
+        return sorter->appendSortKey(sourceIndex, *this, key);
+    QElapsedTimer timer;
+    timer.start();
+    bool encoded = sorter->appendSortKey(sourceIndex, *this, key);
+    m_statistics->recordSorter(sorter, timer.nsecsElapsed());
+    return encoded;
+}
+
+/*
+    Encodes the key of a row for the leading steps of the sort chain, the first time the row is compared,
+    so that only the rows accepted by the filters get a key.
+    A step is only encoded if all the rows compared have a key of the same kind for it. When a row doesn't,
+    that step and the following ones are dropped and the keys of the other rows are encoded again with the remaining steps.
+    Returns false if no step can be encoded.
+*/
+bool QQmlSortFilterProxyModel::encodeSortKey(int row) const
+{
+    if (!m_sortKeysValid)
+        return false;
+    if (row >= m_sortKeySpans.size()) {
+        m_sortKeySpans.resize(sourceModel()->rowCount());
+        if (row >= m_sortKeySpans.size())
+            return false;
+    }
+    if (m_sortKeySpans.at(row).size > 0)
+        return true;
+
+    // the keys are released once the rows are sorted
+    if (!m_sortKeysReleaseQueued) {
+        m_sortKeysReleaseQueued = true;
+        QMetaObject::invokeMethod(const_cast<QQmlSortFilterProxyModel*>(this), "releaseSortKeys", Qt::QueuedConnection);
+    }
+
+    // the key is encoded in a buffer keeping its capacity from row to row, then appended to the keys of the other rows
+    QByteArray& key = m_sortKeyBuffer;
+    key.reserve(qMax(key.capacity(), 64));
+    key.resize(0);
+    const QModelIndex sourceIndex = sourceModel()->index(row, 0);
+    RowCache::Scope scope(m_rowCache, sourceIndex);
+    for (int step = 0; step < m_sortKeyStepCount; ++step) {
+        const int start = key.size();
+        const bool encoded = appendSortKey(step, sourceIndex, key) && key.size() > start;
+        if (encoded && step == m_sortKeyTags.size())
+            m_sortKeyTags.append(key.at(start));
+        if (!encoded || key.at(start) != m_sortKeyTags.at(step)) {
+            dropSortKeySteps(step);
+            return encodeSortKey(row);
+        }
+    }
+    if (m_sortKeysComplete)
+        SortKey::appendRow(key, row);
+
+    // the storage of the keys is reserved explicitly, it keeps its capacity when it is emptied for the next sort
+    const int offset = m_sortKeyData.size();
+    if (offset + key.size() > m_sortKeyData.capacity())
+        m_sortKeyData.reserve(qMax(2 * m_sortKeyData.capacity(), offset + key.size()));
+    m_sortKeyData.append(key.constData(), key.size());
+    SortKeySpan& span = m_sortKeySpans[row];
+    span.offset = offset;
+    span.size = key.size();
+    return true;
+}
+
+// keeps the first stepCount steps of the keys, the keys already encoded with more steps are cleared
+void QQmlSortFilterProxyModel::dropSortKeySteps(int stepCount) const
+{
+    m_sortKeySpans.clear();
+    m_sortKeyData.resize(0);
+    m_sortKeyTags.truncate(stepCount);
+    m_sortKeyStepCount = stepCount;
+    m_sortKeysComplete = false;
+    m_sortKeysValid = stepCount > 0;
+}
+
+/*
+    Prepares binary keys for the steps of the sort chain that can be encoded,
+    comparing two rows is then a single memcmp instead of going through the sorters and QVariant comparisons.
+    When all the steps are encoded, the row number is appended as the final tie-break.
+    The keys themselves are encoded lazily by lessThan(), for the rows it compares.
+*/
+void QQmlSortFilterProxyModel::buildSortKeys()
+{
+    clearSortKeys();
+    if (!sourceModel())
+        return;
+
+    const int stepCount = sortStepCount();
+    if (stepCount == 0)
+        return;
+
+    m_sortKeyStepCount = stepCount;
+    m_sortKeysComplete = true;
+    m_sortKeysValid = true;
+}
+
+/*
+    Frees the keys of the rows after a sort. The steps that can be encoded are kept,
+    the following sorts, like the ones moving the changed rows, encode the keys of the rows they compare again.
+*/
+void QQmlSortFilterProxyModel::releaseSortKeys()
+{
+    m_sortKeysReleaseQueued = false;
+    QVector<SortKeySpan>().swap(m_sortKeySpans);
+    QByteArray().swap(m_sortKeyData);
+    QByteArray().swap(m_sortKeyBuffer);
+}
+
+void QQmlSortFilterProxyModel::clearSortKeys()
+{
+    m_sortKeySpans.clear();
+    m_sortKeyData.resize(0);
+    m_sortKeyTags.clear();
+    m_sortKeyStepCount = 0;
+    m_sortKeysValid = false;
+    m_sortKeysComplete = false;
+}
+
 void QQmlSortFilterProxyModel::onFilterAppended(Filter* filter)
 {
+    m_filterOrder.reset();
     connect(filter, &Filter::invalidated, this, &QQmlSortFilterProxyModel::queueInvalidateFilter);
-    queueInvalidateFilter();
+    connect(filter, &Filter::narrowed, this, &QQmlSortFilterProxyModel::queueNarrowFilter);
+    connect(filter, &Filter::widened, this, &QQmlSortFilterProxyModel::queueWidenFilter);
+    // a new top level filter can only reject more rows
+    queueNarrowFilter();
 }
 
 void QQmlSortFilterProxyModel::onFilterRemoved(Filter* filter)
 {
-    Q_UNUSED(filter)
-    queueInvalidateFilter();
+    m_statistics->removeFilter(filter);
+    m_filterOrder.reset();
+    queueWidenFilter();
 }
 
 void QQmlSortFilterProxyModel::onFiltersCleared()
 {
+    m_statistics->clearFilters();
+    m_filterOrder.reset();
     queueInvalidateFilter();
 }
 
@@ -539,12 +1542,13 @@ void QQmlSortFilterProxyModel::onSorterAppended(Sorter* sorter)
 
 void QQmlSortFilterProxyModel::onSorterRemoved(Sorter* sorter)
 {
-    Q_UNUSED(sorter)
+    m_statistics->removeSorter(sorter);
     queueInvalidate();
 }
 
 void QQmlSortFilterProxyModel::onSortersCleared()
 {
+    m_statistics->clearSorters();
     queueInvalidate();
 }
 
@@ -559,19 +1563,28 @@ void QQmlSortFilterProxyModel::onProxyRoleAppended(ProxyRole *proxyRole)
 
 void QQmlSortFilterProxyModel::onProxyRoleRemoved(ProxyRole *proxyRole)
 {
-    Q_UNUSED(proxyRole)
+    m_statistics->removeProxyRole(proxyRole);
     beginResetModel();
     endResetModel();
 }
 
 void QQmlSortFilterProxyModel::onProxyRolesCleared()
 {
+    m_statistics->clearProxyRoles();
     beginResetModel();
     endResetModel();
 }
 
 void registerQQmlSortFilterProxyModelTypes() {
     qmlRegisterType<QQmlSortFilterProxyModel>("SortFilterProxyModel", 0, 2, "SortFilterProxyModel");
+    // created right away so that the tracer is enabled from the start when SFPM_TRACE is set
+    Tracer::instance();
+    qmlRegisterSingletonType<Tracer>("SortFilterProxyModel", 0, 2, "Tracer", [] (QQmlEngine*, QJSEngine*) -> QObject* {
+        QQmlEngine::setObjectOwnership(Tracer::instance(), QQmlEngine::CppOwnership);
+        return Tracer::instance();
+    });
+    qmlRegisterType<WorkloadRecorder>("SortFilterProxyModel", 0, 2, "WorkloadRecorder");
+    qmlRegisterUncreatableType<Statistics>("SortFilterProxyModel", 0, 2, "Statistics", "Statistics is only available through SortFilterProxyModel.statistics");
 }
 
 Q_COREAPP_STARTUP_FUNCTION(registerQQmlSortFilterProxyModelTypes)
@@ -3,12 +3,22 @@
 
 #include <QSortFilterProxyModel>
 #include <QQmlParserStatus>
+#include <QBitArray>
 #include "filters/filtercontainer.h"
 #include "sorters/sortercontainer.h"
 #include "proxyroles/proxyrolecontainer.h"
+#include "indexes/hashroleindex.h"
+#include "indexes/orderedroleindex.h"
+#include "utils/statistics.h"
+#include "utils/tracer.h"
+#include "utils/plan.h"
+#include "utils/filterorder.h"
+#include "utils/rowcache.h"
 
 namespace qqsfpm {
 
+class ExpressionContext;
+
 class QQmlSortFilterProxyModel : public QSortFilterProxyModel,
                                  public QQmlParserStatus,
                                  public FilterContainer,
@@ -32,10 +42,15 @@ class QQmlSortFilterProxyModel : public QSortFilterProxyModel,
     Q_PROPERTY(QString sortRoleName READ sortRoleName WRITE setSortRoleName NOTIFY sortRoleNameChanged)
     Q_PROPERTY(bool ascendingSortOrder READ ascendingSortOrder WRITE setAscendingSortOrder NOTIFY ascendingSortOrderChanged)
 
+    Q_PROPERTY(QStringList indexedRoleNames READ indexedRoleNames WRITE setIndexedRoleNames NOTIFY indexedRoleNamesChanged)
+    Q_PROPERTY(QStringList orderedIndexedRoleNames READ orderedIndexedRoleNames WRITE setOrderedIndexedRoleNames NOTIFY orderedIndexedRoleNamesChanged)
+
     Q_PROPERTY(QQmlListProperty<qqsfpm::Filter> filters READ filtersListProperty)
     Q_PROPERTY(QQmlListProperty<qqsfpm::Sorter> sorters READ sortersListProperty)
     Q_PROPERTY(QQmlListProperty<qqsfpm::ProxyRole> proxyRoles READ proxyRolesListProperty)
 
+    Q_PROPERTY(qqsfpm::Statistics* statistics READ statistics CONSTANT)
+
 public:
     enum PatternSyntax {
         RegExp = QRegExp::RegExp,
@@ -71,6 +86,17 @@ public:
     bool ascendingSortOrder() const;
     void setAscendingSortOrder(bool ascendingSortOrder);
 
+    const QStringList& indexedRoleNames() const;
+    void setIndexedRoleNames(const QStringList& indexedRoleNames);
+
+    const QStringList& orderedIndexedRoleNames() const;
+    void setOrderedIndexedRoleNames(const QStringList& orderedIndexedRoleNames);
+
+    Statistics* statistics() const;
+    PlanAnalysis* planAnalysis() const { return m_planAnalysis; }
+    const RowCache& rowCache() const { return m_rowCache; }
+    ExpressionContext* expressionContext(QQmlContext* parentContext) const;
+
     void classBegin() override;
     void componentComplete() override;
 
@@ -81,10 +107,17 @@ public:
     QHash<int, QByteArray> roleNames() const override;
 
     Q_INVOKABLE int roleForName(const QString& roleName) const;
+    Q_INVOKABLE int findRow(const QString& roleName, const QVariant& value) const;
+
+    HashRoleIndex* hashIndex(const QString& roleName) const;
+    OrderedRoleIndex* orderedIndex(const QString& roleName) const;
 
     Q_INVOKABLE QVariantMap get(int row) const;
     Q_INVOKABLE QVariant get(int row, const QString& roleName) const;
 
+    Q_INVOKABLE QVariantMap explain() const;
+    Q_INVOKABLE QVariantMap analyze();
+
     Q_INVOKABLE QModelIndex mapToSource(const QModelIndex& proxyIndex) const override;
     Q_INVOKABLE int mapToSource(int proxyRow) const;
     Q_INVOKABLE QModelIndex mapFromSource(const QModelIndex& sourceIndex) const override;
@@ -104,6 +137,9 @@ Q_SIGNALS:
     void sortRoleNameChanged();
     void ascendingSortOrderChanged();
 
+    void indexedRoleNamesChanged();
+    void orderedIndexedRoleNamesChanged();
+
 protected:
     bool filterAcceptsRow(int source_row, const QModelIndex& source_parent) const override;
     bool lessThan(const QModelIndex& source_left, const QModelIndex& source_right) const override;
@@ -113,6 +149,8 @@ protected Q_SLOTS:
 
 private Q_SLOTS:
     void queueInvalidateFilter();
+    void queueNarrowFilter();
+    void queueWidenFilter();
     void invalidateFilter();
     void queueInvalidate();
     void invalidate();
@@ -124,9 +162,38 @@ private Q_SLOTS:
     void onDataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight, const QVector<int>& roles);
     void queueInvalidateProxyRoles();
     void invalidateProxyRoles();
+    void clearFilterResults();
+    void updateRoleIndexes();
+    void invalidateRoleIndexes();
+    void onSourceDataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight, const QVector<int>& roles);
+    void onSourceRowsInserted(const QModelIndex& parent, int first, int last);
+    void onSourceRowsRemoved(const QModelIndex& parent, int first, int last);
+    void clearSortKeys();
+    void releaseSortKeys();
+    void onSourceRowsShifted(const QModelIndex& parent, int first);
+    void onSourceRowsChanged();
 
 private:
     QVariantMap modelDataMap(const QModelIndex& modelIndex) const;
+    void completeComponents();
+
+    bool evaluateFilter(Filter* filter, const QModelIndex& sourceIndex) const;
+    void traceQueue(const char* name, bool alreadyQueued, QString& cause);
+    void traceSourceSignal();
+    QVariantMap plan(const PlanAnalysis* analysis) const;
+
+    QVariant filterResultsKey() const;
+    QBitArray acceptedSourceRows() const;
+    void beginFilterPass();
+    void endFilterPass();
+
+    const QList<Sorter*>& sortChain() const;
+    int sortStepCount() const;
+    int compareSortStep(int step, const QModelIndex& source_left, const QModelIndex& source_right) const;
+    bool appendSortKey(int step, const QModelIndex& sourceIndex, QByteArray& key) const;
+    bool encodeSortKey(int row) const;
+    void dropSortKeySteps(int stepCount) const;
+    void buildSortKeys();
 
     void onFilterAppended(Filter* filter) override;
     void onFilterRemoved(Filter* filter) override;
@@ -147,12 +214,56 @@ private:
     bool m_ascendingSortOrder = true;
     bool m_completed = false;
     QHash<int, QByteArray> m_roleNames;
-    QHash<int, QPair<ProxyRole*, QString>> m_proxyRoleMap;
+    QHash<QString, int> m_roleForName;
+    struct ProxyRoleSlot {
+        ProxyRole* proxyRole;
+        QString name;
+    };
+    QVector<ProxyRoleSlot> m_proxyRoleSlots;
+    int m_firstProxyRole = 0;
     QVector<int> m_proxyRoleNumbers;
 
     bool m_invalidateFilterQueued = false;
     bool m_invalidateQueued = false;
     bool m_invalidateProxyRolesQueued = false;
+
+    bool m_filterNarrowing = false;
+    bool m_filterWidening = false;
+    QBitArray m_knownSourceRows;
+    QBitArray m_knownAcceptedSourceRows;
+    QList<QPair<QVariant, QBitArray>> m_filterResults;
+    mutable FilterOrder m_filterOrder;
+    mutable RowCache m_rowCache;
+    mutable int m_proxyRoleDepth = 0;
+    mutable QHash<QQmlContext*, ExpressionContext*> m_expressionContexts;
+    QList<QMetaObject::Connection> m_sourceConnections;
+
+    QStringList m_indexedRoleNames;
+    mutable QHash<QString, HashRoleIndex> m_hashIndexes;
+    QStringList m_orderedIndexedRoleNames;
+    mutable QHash<QString, OrderedRoleIndex> m_orderedIndexes;
+
+    mutable QList<Sorter*> m_sortChain;
+    mutable bool m_sortChainValid = false;
+    // the keys of the rows follow each other in m_sortKeyData, the span of a row is empty until its key is encoded
+    struct SortKeySpan {
+        int offset = 0;
+        int size = 0;
+    };
+    mutable QByteArray m_sortKeyData;
+    mutable QVector<SortKeySpan> m_sortKeySpans;
+    mutable QByteArray m_sortKeyBuffer;
+    mutable QByteArray m_sortKeyTags;
+    mutable int m_sortKeyStepCount = 0;
+    mutable bool m_sortKeysValid = false;
+    mutable bool m_sortKeysComplete = false;
+    mutable bool m_sortKeysReleaseQueued = false;
+
+    Statistics* m_statistics;
+    PlanAnalysis* m_planAnalysis = nullptr;
+    QString m_invalidateFilterCause;
+    QString m_invalidateCause;
+    QString m_invalidateProxyRolesCause;
 };
 
 }
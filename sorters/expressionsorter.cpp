@@ -1,5 +1,6 @@
 #include "expressionsorter.h"
 #include "qqmlsortfilterproxymodel.h"
+#include "utils/expressioncontext.h"
 #include <QtQml>
 
 namespace qqsfpm {
@@ -57,6 +58,38 @@ void ExpressionSorter::setExpression(const QQmlScriptString& scriptString)
     invalidate();
 }
 
+/*!
+    \qmlproperty var ExpressionSorter::prepare
+
+    This property holds a value that the \l expression reads as \c prepared when it compares two rows.
+
+    The expression is evaluated for each comparison, with a single \c prepared shared by \c modelLeft and \c modelRight,
+    so an ordering computed once for the whole sort, like the priority of each category, is better built in a binding on this property.
+    When the binding is evaluated again, the rows are sorted again.
+
+    \code
+    ExpressionSorter {
+        prepare: priorityField.text.split(",")
+        expression: prepared.indexOf(modelLeft.category) < prepared.indexOf(modelRight.category)
+    }
+    \endcode
+
+    By default, it is \c undefined.
+*/
+const QJSValue& ExpressionSorter::prepare() const
+{
+    return m_prepare;
+}
+
+void ExpressionSorter::setPrepare(const QJSValue& prepare)
+{
+    if (!ExpressionContext::setPrepare(m_prepare, prepare, m_context))
+        return;
+
+    Q_EMIT prepareChanged();
+    invalidate();
+}
+
 void ExpressionSorter::proxyModelCompleted(const QQmlSortFilterProxyModel& proxyModel)
 {
     updateContext(proxyModel);
@@ -83,28 +116,16 @@ bool evaluateBoolExpression(QQmlExpression& expression)
 int ExpressionSorter::compare(const QModelIndex& sourceLeft, const QModelIndex& sourceRight, const QQmlSortFilterProxyModel& proxyModel) const
 {
     if (!m_scriptString.isEmpty()) {
-        QVariantMap modelLeftMap, modelRightMap;
-        QHash<int, QByteArray> roles = proxyModel.roleNames();
-
-        QQmlContext context(qmlContext(this));
+        ExpressionContext* context = proxyModel.expressionContext(qmlContext(this));
+        QQmlExpression* expression = context->expression(this, m_scriptString);
+        context->bindRows(sourceLeft, sourceRight, proxyModel);
+        context->setPrepared(m_prepare);
 
-        for (auto it = roles.cbegin(); it != roles.cend(); ++it) {
-            modelLeftMap.insert(it.value(), proxyModel.sourceData(sourceLeft, it.key()));
-            modelRightMap.insert(it.value(), proxyModel.sourceData(sourceRight, it.key()));
-        }
-        modelLeftMap.insert("index", sourceLeft.row());
-        modelRightMap.insert("index", sourceRight.row());
-
-        QQmlExpression expression(m_scriptString, &context);
-
-        context.setContextProperty("modelLeft", modelLeftMap);
-        context.setContextProperty("modelRight", modelRightMap);
-        if (evaluateBoolExpression(expression))
+        if (evaluateBoolExpression(*expression))
                 return -1;
 
-        context.setContextProperty("modelLeft", modelRightMap);
-        context.setContextProperty("modelRight", modelLeftMap);
-        if (evaluateBoolExpression(expression))
+        context->swapRows();
+        if (evaluateBoolExpression(*expression))
                 return 1;
     }
     return 0;
@@ -116,7 +137,6 @@ void ExpressionSorter::updateContext(const QQmlSortFilterProxyModel& proxyModel)
     m_context = new QQmlContext(qmlContext(this), this);
 
     QVariantMap modelLeftMap, modelRightMap;
-    // what about roles changes ?
 
     for (const QByteArray& roleName : proxyModel.roleNames().values()) {
         modelLeftMap.insert(roleName, QVariant());
@@ -136,6 +156,7 @@ void ExpressionSorter::updateExpression()
     if (!m_context)
         return;
 
+    ExpressionContext::bindPrepared(m_context, m_prepare);
     delete m_expression;
     m_expression = new QQmlExpression(m_scriptString, m_context, 0, this);
     connect(m_expression, &QQmlExpression::valueChanged, this, &ExpressionSorter::invalidate);
@@ -143,4 +164,9 @@ void ExpressionSorter::updateExpression()
     m_expression->evaluate();
 }
 
+CostClass ExpressionSorter::costClass() const
+{
+    return CostClass::Script;
+}
+
 }
@@ -3,6 +3,7 @@
 
 #include "sorter.h"
 #include <QQmlScriptString>
+#include <QJSValue>
 
 class QQmlExpression;
 
@@ -14,17 +15,24 @@ class ExpressionSorter : public Sorter
 {
     Q_OBJECT
     Q_PROPERTY(QQmlScriptString expression READ expression WRITE setExpression NOTIFY expressionChanged)
+    Q_PROPERTY(QJSValue prepare READ prepare WRITE setPrepare NOTIFY prepareChanged)
 
 public:
     using Sorter::Sorter;
 
+    CostClass costClass() const override;
+
     const QQmlScriptString& expression() const;
     void setExpression(const QQmlScriptString& scriptString);
 
+    const QJSValue& prepare() const;
+    void setPrepare(const QJSValue& prepare);
+
     void proxyModelCompleted(const QQmlSortFilterProxyModel& proxyModel) override;
 
 Q_SIGNALS:
     void expressionChanged();
+    void prepareChanged();
 
 protected:
     int compare(const QModelIndex& sourceLeft, const QModelIndex& sourceRight, const QQmlSortFilterProxyModel& proxyModel) const override;
@@ -34,6 +42,7 @@ private:
     void updateExpression();
 
     QQmlScriptString m_scriptString;
+    QJSValue m_prepare;
     QQmlExpression* m_expression = nullptr;
     QQmlContext* m_context = nullptr;
 };
@@ -1,5 +1,6 @@
 #include "filtersorter.h"
 #include "filters/filter.h"
+#include "utils/sortkey.h"
 
 namespace qqsfpm {
 
@@ -46,6 +47,16 @@ int FilterSorter::compare(const QModelIndex& sourceLeft, const QModelIndex& sour
     return leftIsAccepted ? -1 : 1;
 }
 
+/*
+    The filters are evaluated once per row when the sort keys are built, instead of twice per comparison.
+    Accepted rows get a lower flag so that they come first.
+*/
+bool FilterSorter::sortKey(const QModelIndex& sourceIndex, const QQmlSortFilterProxyModel& proxyModel, QByteArray& key) const
+{
+    SortKey::appendFlag(key, !indexIsAccepted(sourceIndex, proxyModel));
+    return true;
+}
+
 void FilterSorter::proxyModelCompleted(const QQmlSortFilterProxyModel& proxyModel)
 {
     for (Filter* filter : m_filters)
@@ -55,12 +66,16 @@ void FilterSorter::proxyModelCompleted(const QQmlSortFilterProxyModel& proxyMode
 void FilterSorter::onFilterAppended(Filter* filter)
 {
     connect(filter, &Filter::invalidated, this, &FilterSorter::invalidate);
+    connect(filter, &Filter::narrowed, this, &FilterSorter::invalidate);
+    connect(filter, &Filter::widened, this, &FilterSorter::invalidate);
     invalidate();
 }
 
 void FilterSorter::onFilterRemoved(Filter* filter)
 {
     disconnect(filter, &Filter::invalidated, this, &FilterSorter::invalidate);
+    disconnect(filter, &Filter::narrowed, this, &FilterSorter::invalidate);
+    disconnect(filter, &Filter::widened, this, &FilterSorter::invalidate);
     invalidate();
 }
 
@@ -78,4 +93,14 @@ bool FilterSorter::indexIsAccepted(const QModelIndex& sourceIndex, const QQmlSor
     );
 }
 
+CostClass FilterSorter::costClass() const
+{
+    return Plan::filtersCostClass(m_filters);
+}
+
+void FilterSorter::explainSorter(QVariantMap& plan, const QQmlSortFilterProxyModel& proxyModel, const PlanAnalysis* analysis) const
+{
+    plan.insert(QStringLiteral("filters"), Plan::explainFilters(m_filters, proxyModel, analysis));
+}
+
 }
@@ -16,8 +16,12 @@ class FilterSorter : public Sorter, public FilterContainer
 public:
     using Sorter::Sorter;
 
+    CostClass costClass() const override;
+
 protected:
     int compare(const QModelIndex &sourceLeft, const QModelIndex &sourceRight, const QQmlSortFilterProxyModel &proxyModel) const override;
+    bool sortKey(const QModelIndex& sourceIndex, const QQmlSortFilterProxyModel& proxyModel, QByteArray& key) const override;
+    void explainSorter(QVariantMap& plan, const QQmlSortFilterProxyModel& proxyModel, const PlanAnalysis* analysis) const override;
 
 private:
     void proxyModelCompleted(const QQmlSortFilterProxyModel& proxyModel) override;
@@ -0,0 +1,78 @@
+#include "fuzzysorter.h"
+
+namespace qqsfpm {
+
+/*!
+    \qmltype FuzzySorter
+    \inherits Sorter
+    \inqmlmodule SortFilterProxyModel
+    \ingroup Sorters
+    \brief Sorts rows by their relevance score computed by a \l FuzzyFilter.
+
+    A FuzzySorter is a \l Sorter that orders rows by the score of its \l filter, the best matches first.
+    It reads the scores cached by the \l FuzzyFilter when it filtered the rows, so rows are not matched again when they are sorted.
+
+    In the following example, rows will be sorted by how well their \c name role matches the content of the text field :
+    \code
+    SortFilterProxyModel {
+       sourceModel: fileModel
+       filters: FuzzyFilter {
+           id: fuzzyFilter
+           roleName: "name"
+           pattern: searchField.text
+       }
+       sorters: FuzzySorter { filter: fuzzyFilter }
+    }
+    \endcode
+*/
+
+/*!
+    \qmlproperty FuzzyFilter FuzzySorter::filter
+
+    This property holds the \l FuzzyFilter whose scores are used to sort the rows.
+*/
+FuzzyFilter* FuzzySorter::filter() const
+{
+    return m_filter;
+}
+
+void FuzzySorter::setFilter(FuzzyFilter* filter)
+{
+    if (m_filter == filter)
+        return;
+
+    if (m_filter)
+        disconnect(m_filter, nullptr, this, nullptr);
+
+    m_filter = filter;
+
+    if (m_filter) {
+        connect(m_filter, &FuzzyFilter::roleNameChanged, this, &FuzzySorter::invalidate);
+        connect(m_filter, &FuzzyFilter::patternChanged, this, &FuzzySorter::invalidate);
+        connect(m_filter, &FuzzyFilter::caseSensitivityChanged, this, &FuzzySorter::invalidate);
+    }
+
+    Q_EMIT filterChanged();
+    invalidate();
+}
+
+int FuzzySorter::compare(const QModelIndex& sourceLeft, const QModelIndex& sourceRight, const QQmlSortFilterProxyModel& proxyModel) const
+{
+    if (!m_filter)
+        return 0;
+
+    int leftScore = m_filter->score(sourceLeft, proxyModel);
+    int rightScore = m_filter->score(sourceRight, proxyModel);
+    if (leftScore > rightScore)
+        return -1;
+    if (leftScore < rightScore)
+        return 1;
+    return 0;
+}
+
+CostClass FuzzySorter::costClass() const
+{
+    return CostClass::Text;
+}
+
+}
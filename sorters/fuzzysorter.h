@@ -0,0 +1,35 @@
+#ifndef FUZZYSORTER_H
+#define FUZZYSORTER_H
+
+#include "sorter.h"
+#include "filters/fuzzyfilter.h"
+#include <QPointer>
+
+namespace qqsfpm {
+
+class FuzzySorter : public Sorter
+{
+    Q_OBJECT
+    Q_PROPERTY(qqsfpm::FuzzyFilter* filter READ filter WRITE setFilter NOTIFY filterChanged)
+
+public:
+    using Sorter::Sorter;
+
+    CostClass costClass() const override;
+
+    FuzzyFilter* filter() const;
+    void setFilter(FuzzyFilter* filter);
+
+Q_SIGNALS:
+    void filterChanged();
+
+protected:
+    int compare(const QModelIndex& sourceLeft, const QModelIndex& sourceRight, const QQmlSortFilterProxyModel& proxyModel) const override;
+
+private:
+    QPointer<FuzzyFilter> m_filter;
+};
+
+}
+
+#endif // FUZZYSORTER_H
@@ -1,5 +1,6 @@
 #include "rolesorter.h"
 #include "qqmlsortfilterproxymodel.h"
+#include "utils/sortkey.h"
 
 namespace qqsfpm {
 
@@ -57,13 +58,21 @@ QPair<QVariant, QVariant> RoleSorter::sourceData(const QModelIndex &sourceLeft,
 int RoleSorter::compare(const QModelIndex &sourceLeft, const QModelIndex& sourceRight, const QQmlSortFilterProxyModel& proxyModel) const
 {
     QPair<QVariant, QVariant> pair = sourceData(sourceLeft, sourceRight, proxyModel);
-    QVariant leftValue = pair.first;
-    QVariant rightValue = pair.second;
-    if (leftValue < rightValue)
-        return -1;
-    if (leftValue > rightValue)
-        return 1;
-    return 0;
+    return m_comparator.compare(pair.first, pair.second);
+}
+
+bool RoleSorter::sortKey(const QModelIndex& sourceIndex, const QQmlSortFilterProxyModel& proxyModel, QByteArray& key) const
+{
+    int role = proxyModel.roleForName(m_roleName);
+    QVariant value = role == -1 ? QVariant() : proxyModel.sourceData(sourceIndex, role);
+    return SortKey::appendValue(key, value);
+}
+
+void RoleSorter::explainSorter(QVariantMap& plan, const QQmlSortFilterProxyModel& proxyModel, const PlanAnalysis* analysis) const
+{
+    Q_UNUSED(proxyModel)
+    Q_UNUSED(analysis)
+    plan.insert(QStringLiteral("roleName"), m_roleName);
 }
 
 }
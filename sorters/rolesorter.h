@@ -2,6 +2,7 @@
 #define ROLESORTER_H
 
 #include "sorter.h"
+#include "utils/variantcomparator.h"
 
 namespace qqsfpm {
 
@@ -22,9 +23,12 @@ Q_SIGNALS:
 protected:
     QPair<QVariant, QVariant> sourceData(const QModelIndex &sourceLeft, const QModelIndex& sourceRight, const QQmlSortFilterProxyModel& proxyModel) const;
     int compare(const QModelIndex& sourceLeft, const QModelIndex& sourceRight, const QQmlSortFilterProxyModel& proxyModel) const override;
+    bool sortKey(const QModelIndex& sourceIndex, const QQmlSortFilterProxyModel& proxyModel, QByteArray& key) const override;
+    void explainSorter(QVariantMap& plan, const QQmlSortFilterProxyModel& proxyModel, const PlanAnalysis* analysis) const override;
 
 private:
     QString m_roleName;
+    VariantComparator m_comparator;
 };
 
 }
@@ -1,5 +1,6 @@
 #include "sorter.h"
 #include "qqmlsortfilterproxymodel.h"
+#include "utils/sortkey.h"
 
 namespace qqsfpm {
 
@@ -120,6 +121,45 @@ int Sorter::compare(const QModelIndex &sourceLeft, const QModelIndex &sourceRigh
     return 0;
 }
 
+// appends the normalized sort key of a row to key, leaves key untouched if the row can't be encoded
+bool Sorter::appendSortKey(const QModelIndex& sourceIndex, const QQmlSortFilterProxyModel& proxyModel, QByteArray& key) const
+{
+    const int size = key.size();
+    if (!sortKey(sourceIndex, proxyModel, key)) {
+        key.truncate(size);
+        return false;
+    }
+    if (m_sortOrder == Qt::DescendingOrder)
+        SortKey::invert(key, size);
+    return true;
+}
+
+/*
+    Describes how the sorter compares rows, for SortFilterProxyModel::explain().
+    With an analysis, the description also holds the comparisons done and the time and source data() calls they took.
+*/
+QVariantMap Sorter::explain(const QQmlSortFilterProxyModel& proxyModel, const PlanAnalysis* analysis) const
+{
+    QVariantMap plan {
+        {QStringLiteral("type"), Plan::qmlTypeName(this)},
+        {QStringLiteral("objectName"), objectName()},
+        {QStringLiteral("enabled"), m_enabled},
+        {QStringLiteral("sortOrder"), m_sortOrder == Qt::AscendingOrder ? QStringLiteral("ascending") : QStringLiteral("descending")},
+        {QStringLiteral("priority"), m_priority},
+        {QStringLiteral("cost"), Plan::costClassName(costClass())}
+    };
+    explainSorter(plan, proxyModel, analysis);
+    if (analysis)
+        analysis->annotate(plan, this, QStringLiteral("comparisons"), false);
+    return plan;
+}
+
+CostClass Sorter::costClass() const
+{
+    return CostClass::Role;
+}
+
+// called when the proxy model is completed, and again when its role names change
 void Sorter::proxyModelCompleted(const QQmlSortFilterProxyModel& proxyModel)
 {
     Q_UNUSED(proxyModel)
@@ -133,6 +173,22 @@ bool Sorter::lessThan(const QModelIndex &sourceLeft, const QModelIndex &sourceRi
     return false;
 }
 
+// the key must sort bytewise like compare() orders the rows, sorters unable to guarantee that return false
+bool Sorter::sortKey(const QModelIndex& sourceIndex, const QQmlSortFilterProxyModel& proxyModel, QByteArray& key) const
+{
+    Q_UNUSED(sourceIndex)
+    Q_UNUSED(proxyModel)
+    Q_UNUSED(key)
+    return false;
+}
+
+void Sorter::explainSorter(QVariantMap& plan, const QQmlSortFilterProxyModel& proxyModel, const PlanAnalysis* analysis) const
+{
+    Q_UNUSED(plan)
+    Q_UNUSED(proxyModel)
+    Q_UNUSED(analysis)
+}
+
 void Sorter::invalidate()
 {
     if (m_enabled)
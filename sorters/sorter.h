@@ -2,6 +2,9 @@
 #define SORTER_H
 
 #include <QObject>
+#include "utils/plan.h"
+
+class QByteArray;
 
 namespace qqsfpm {
 
@@ -32,6 +35,9 @@ public:
     void setPriority(int priority);
 
     int compareRows(const QModelIndex& source_left, const QModelIndex& source_right, const QQmlSortFilterProxyModel& proxyModel) const;
+    bool appendSortKey(const QModelIndex& sourceIndex, const QQmlSortFilterProxyModel& proxyModel, QByteArray& key) const;
+    QVariantMap explain(const QQmlSortFilterProxyModel& proxyModel, const PlanAnalysis* analysis) const;
+    virtual CostClass costClass() const;
 
     virtual void proxyModelCompleted(const QQmlSortFilterProxyModel& proxyModel);
 
@@ -45,6 +51,8 @@ Q_SIGNALS:
 protected:
     virtual int compare(const QModelIndex& sourceLeft, const QModelIndex& sourceRight, const QQmlSortFilterProxyModel& proxyModel) const;
     virtual bool lessThan(const QModelIndex& sourceLeft, const QModelIndex& sourceRight, const QQmlSortFilterProxyModel& proxyModel) const;
+    virtual bool sortKey(const QModelIndex& sourceIndex, const QQmlSortFilterProxyModel& proxyModel, QByteArray& key) const;
+    virtual void explainSorter(QVariantMap& plan, const QQmlSortFilterProxyModel& proxyModel, const PlanAnalysis* analysis) const;
     void invalidate();
 
 private:
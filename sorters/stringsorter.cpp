@@ -114,4 +114,18 @@ int StringSorter::compare(const QModelIndex &sourceLeft, const QModelIndex &sour
     return m_collator.compare(leftValue, rightValue);
 }
 
+// collation keys can't be concatenated with other keys, rows are compared with the collator instead
+bool StringSorter::sortKey(const QModelIndex& sourceIndex, const QQmlSortFilterProxyModel& proxyModel, QByteArray& key) const
+{
+    Q_UNUSED(sourceIndex)
+    Q_UNUSED(proxyModel)
+    Q_UNUSED(key)
+    return false;
+}
+
+CostClass StringSorter::costClass() const
+{
+    return CostClass::Text;
+}
+
 }
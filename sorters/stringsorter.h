@@ -17,6 +17,8 @@ class StringSorter : public RoleSorter
 public:
     using RoleSorter::RoleSorter;
 
+    CostClass costClass() const override;
+
     Qt::CaseSensitivity caseSensitivity() const;
     void setCaseSensitivity(Qt::CaseSensitivity caseSensitivity);
 
@@ -37,6 +39,7 @@ Q_SIGNALS:
 
 protected:
     int compare(const QModelIndex& sourceLeft, const QModelIndex& sourceRight, const QQmlSortFilterProxyModel& proxyModel) const override;
+    bool sortKey(const QModelIndex& sourceIndex, const QQmlSortFilterProxyModel& proxyModel, QByteArray& key) const override;
 
 private:
     QCollator m_collator;
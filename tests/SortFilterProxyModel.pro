@@ -7,12 +7,14 @@ include(../SortFilterProxyModel.pri)
 
 HEADERS += \
     indexsorter.h \
-    testroles.h
+    testroles.h \
+    allocationcounter.h
 
 SOURCES += \
     tst_sortfilterproxymodel.cpp \
     indexsorter.cpp \
-    testroles.cpp
+    testroles.cpp \
+    allocationcounter.cpp
 
 OTHER_FILES += \
     tst_rangefilter.qml \
@@ -33,4 +35,21 @@ OTHER_FILES += \
     tst_filtersorter.qml \
     tst_filterrole.qml \
     tst_delayed.qml \
-    tst_sortercontainerattached.qml
+    tst_sortercontainerattached.qml \
+    tst_fuzzyfilter.qml \
+    tst_incrementalfilter.qml \
+    tst_valuesfilter.qml \
+    tst_roleindex.qml \
+    tst_orderedindex.qml \
+    tst_sortkeys.qml \
+    tst_allocations.qml \
+    tst_statistics.qml \
+    tst_tracer.qml \
+    tst_workloadrecorder.qml \
+    tst_explain.qml \
+    tst_filterorder.qml \
+    tst_rowcache.qml \
+    tst_expressioncontext.qml \
+    tst_queryfilter.qml \
+    tst_nativeexpression.qml \
+    tst_prepare.qml
@@ -0,0 +1,183 @@
+#include "allocationcounter.h"
+#include "qqmlsortfilterproxymodel.h"
+#include <QtQml>
+#include <cerrno>
+#include <cstdlib>
+
+namespace {
+
+thread_local bool counting = false;
+thread_local int allocationCount = 0;
+
+}
+
+/*
+    With glibc, the allocation functions of the C library can be replaced by the executable.
+    Every allocation goes through them, including the ones made by operator new and by Qt containers,
+    and the aligned ones made by the aligned operator new or by std::aligned_alloc.
+    valloc() and pvalloc() are obsolete and used by neither Qt nor the C++ library, they aren't counted.
+*/
+#if defined(__GLIBC__)
+#define SFPM_COUNT_ALLOCATIONS
+
+extern "C" {
+
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* pointer, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+
+void* malloc(size_t size)
+{
+    if (counting)
+        ++allocationCount;
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size)
+{
+    if (counting)
+        ++allocationCount;
+    return __libc_calloc(count, size);
+}
+
+// a realloc growing a block in place doesn't allocate
+void* realloc(void* pointer, size_t size)
+{
+    void* result = __libc_realloc(pointer, size);
+    if (counting && result != pointer)
+        ++allocationCount;
+    return result;
+}
+
+void* memalign(size_t alignment, size_t size)
+{
+    if (counting)
+        ++allocationCount;
+    return __libc_memalign(alignment, size);
+}
+
+void* aligned_alloc(size_t alignment, size_t size)
+{
+    if (counting)
+        ++allocationCount;
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** pointer, size_t alignment, size_t size)
+{
+    if (alignment == 0 || alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0)
+        return EINVAL;
+    if (counting)
+        ++allocationCount;
+    void* result = __libc_memalign(alignment, size);
+    if (!result)
+        return ENOMEM;
+    *pointer = result;
+    return 0;
+}
+
+}
+#endif
+
+namespace {
+
+// the first run lets lazily built caches and compiled patterns settle, only the second run is counted
+template <typename Function>
+int countAllocations(Function function)
+{
+    function();
+    allocationCount = 0;
+    counting = true;
+    function();
+    counting = false;
+    return allocationCount;
+}
+
+}
+
+AllocationTestModel::AllocationTestModel(QObject* parent) :
+    QAbstractListModel(parent)
+{
+    resize(64);
+}
+
+// resets the model with rowCount rows, the same 64 values being repeated
+void AllocationTestModel::resize(int rowCount)
+{
+    beginResetModel();
+    m_rows.clear();
+    for (int row = 0; row < rowCount; ++row) {
+        int number = (row * 37) % 64;
+        m_rows.append({number, number / 4.0, QStringLiteral("item %1").arg(number)});
+    }
+    endResetModel();
+}
+
+int AllocationTestModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : m_rows.size();
+}
+
+QVariant AllocationTestModel::data(const QModelIndex& index, int role) const
+{
+    int column = role - NumberRole;
+    if (!index.isValid() || column < 0 || column >= m_rows.at(index.row()).size())
+        return QVariant();
+    return m_rows.at(index.row()).at(column);
+}
+
+QHash<int, QByteArray> AllocationTestModel::roleNames() const
+{
+    return {
+        {NumberRole, "number"},
+        {RealRole, "real"},
+        {TextRole, "text"}
+    };
+}
+
+bool AllocationCounter::available() const
+{
+#ifdef SFPM_COUNT_ALLOCATIONS
+    return true;
+#else
+    return false;
+#endif
+}
+
+/*
+    Returns the number of allocations that a filtering and sorting pass of proxyModel makes for its rows:
+    the pass is the one of an invalidation, going through QQmlSortFilterProxyModel::filterAcceptsRow() and lessThan(),
+    and the allocations of a pass over four times the rows of its AllocationTestModel are compared to those of a pass over its rows.
+    The allocations made once per pass, by QSortFilterProxyModel or to notify the views, are the same for both.
+*/
+int AllocationCounter::rowAllocations(QObject* proxyModel) const
+{
+    auto model = qobject_cast<qqsfpm::QQmlSortFilterProxyModel*>(proxyModel);
+    auto sourceModel = qobject_cast<AllocationTestModel*>(model ? model->sourceModel() : nullptr);
+    if (!sourceModel)
+        return -1;
+
+    // the filtering results of the previous passes are forgotten, so that every row is tested again
+    const QMetaObject* metaObject = model->metaObject();
+    const QMetaMethod clearFilterResults = metaObject->method(metaObject->indexOfMethod("clearFilterResults()"));
+    const QMetaMethod invalidate = metaObject->method(metaObject->indexOfMethod("invalidate()"));
+    auto pass = [&] () {
+        clearFilterResults.invoke(model, Qt::DirectConnection);
+        invalidate.invoke(model, Qt::DirectConnection);
+    };
+
+    const int rowCount = sourceModel->rowCount();
+    const int allocations = countAllocations(pass);
+    sourceModel->resize(rowCount * 4);
+    const int moreRowsAllocations = countAllocations(pass);
+    sourceModel->resize(rowCount);
+    return moreRowsAllocations - allocations;
+}
+
+void registerAllocationCounterTypes() {
+    qmlRegisterType<AllocationTestModel>("SortFilterProxyModel.Test", 0, 2, "AllocationTestModel");
+    qmlRegisterType<AllocationCounter>("SortFilterProxyModel.Test", 0, 2, "AllocationCounter");
+}
+
+Q_COREAPP_STARTUP_FUNCTION(registerAllocationCounterTypes)
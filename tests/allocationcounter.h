@@ -0,0 +1,44 @@
+#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+
+#include <QAbstractListModel>
+#include <QVector>
+#include <QVariant>
+
+class AllocationTestModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    enum Roles {
+        NumberRole = Qt::UserRole,
+        RealRole,
+        TextRole
+    };
+
+    explicit AllocationTestModel(QObject* parent = nullptr);
+
+    void resize(int rowCount);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+private:
+    QVector<QVector<QVariant>> m_rows;
+};
+
+class AllocationCounter : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(bool available READ available CONSTANT)
+
+public:
+    using QObject::QObject;
+
+    bool available() const;
+
+    Q_INVOKABLE int rowAllocations(QObject* proxyModel) const;
+};
+
+#endif // ALLOCATIONCOUNTER_H
@@ -0,0 +1,107 @@
+#include "benchmarkmodel.h"
+
+namespace {
+
+const char* const Syllables[] = { "ka", "no", "ri", "te", "su", "ma", "lo", "vi", "de", "pa", "zu", "ne" };
+const int SyllableCount = sizeof(Syllables) / sizeof(Syllables[0]);
+const int CategoryCount = 8;
+
+// a linear congruential generator, so that the data doesn't depend on the platform's random functions
+quint32 next(quint32& seed)
+{
+    seed = seed * 1664525u + 1013904223u;
+    return seed >> 8;
+}
+
+}
+
+BenchmarkModel::BenchmarkModel(int rowCount, QObject* parent) :
+    QAbstractListModel(parent)
+{
+    m_rows.reserve(rowCount);
+    for (int i = 0; i < rowCount; ++i)
+        m_rows.append(generateRow());
+}
+
+int BenchmarkModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : m_rows.size();
+}
+
+QVariant BenchmarkModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_rows.size())
+        return QVariant();
+
+    const Row& row = m_rows.at(index.row());
+    switch (role) {
+    case IdRole:
+        return row.id;
+    case ValueRole:
+        return row.value;
+    case NameRole:
+        return row.name;
+    case CategoryRole:
+        return row.category;
+    case FlagRole:
+        return row.flag;
+    case DateRole:
+        return row.date;
+    default:
+        return QVariant();
+    }
+}
+
+QHash<int, QByteArray> BenchmarkModel::roleNames() const
+{
+    return {
+        {IdRole, "id"},
+        {ValueRole, "value"},
+        {NameRole, "name"},
+        {CategoryRole, "category"},
+        {FlagRole, "flag"},
+        {DateRole, "date"}
+    };
+}
+
+bool BenchmarkModel::removeRows(int row, int count, const QModelIndex& parent)
+{
+    if (parent.isValid() || count <= 0 || row < 0 || row + count > m_rows.size())
+        return false;
+
+    beginRemoveRows(parent, row, row + count - 1);
+    m_rows.remove(row, count);
+    endRemoveRows();
+    return true;
+}
+
+void BenchmarkModel::insertGeneratedRows(int row, int count)
+{
+    beginInsertRows(QModelIndex(), row, row + count - 1);
+    m_rows.insert(row, count, Row());
+    for (int i = row; i < row + count; ++i)
+        m_rows[i] = generateRow();
+    endInsertRows();
+}
+
+// gives new values to the value role of the rows and notifies it with dataChanged
+void BenchmarkModel::changeRows(int row, int count)
+{
+    for (int i = row; i < row + count; ++i)
+        m_rows[i].value = next(m_seed) % 100000 / 100.0;
+    Q_EMIT dataChanged(index(row, 0), index(row + count - 1, 0), {ValueRole});
+}
+
+BenchmarkModel::Row BenchmarkModel::generateRow()
+{
+    Row row;
+    row.id = m_nextId++;
+    row.value = next(m_seed) % 100000 / 100.0;
+    int syllables = 2 + next(m_seed) % 3;
+    for (int i = 0; i < syllables; ++i)
+        row.name += QLatin1String(Syllables[next(m_seed) % SyllableCount]);
+    row.category = QStringLiteral("cat-%1").arg(next(m_seed) % CategoryCount);
+    row.flag = next(m_seed) % 4 == 0;
+    row.date = QDateTime(QDate(2000, 1, 1), QTime(0, 0), Qt::UTC).addSecs(next(m_seed) % (20 * 365 * 24 * 3600));
+    return row;
+}
@@ -0,0 +1,50 @@
+#ifndef BENCHMARKMODEL_H
+#define BENCHMARKMODEL_H
+
+#include <QAbstractListModel>
+#include <QDateTime>
+#include <QVector>
+
+// a list model with deterministic pseudo random data of various types, the same for a given row count
+class BenchmarkModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    enum Roles {
+        IdRole = Qt::UserRole,
+        ValueRole,
+        NameRole,
+        CategoryRole,
+        FlagRole,
+        DateRole
+    };
+
+    explicit BenchmarkModel(int rowCount, QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    bool removeRows(int row, int count, const QModelIndex& parent = QModelIndex()) override;
+    void insertGeneratedRows(int row, int count);
+    void changeRows(int row, int count);
+
+private:
+    struct Row {
+        int id;
+        double value;
+        QString name;
+        QString category;
+        bool flag;
+        QDateTime date;
+    };
+
+    Row generateRow();
+
+    QVector<Row> m_rows;
+    quint32 m_seed = 42;
+    int m_nextId = 0;
+};
+
+#endif // BENCHMARKMODEL_H
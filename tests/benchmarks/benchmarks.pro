@@ -0,0 +1,14 @@
+TEMPLATE = app
+TARGET = tst_benchmarks
+QT += qml testlib
+CONFIG += c++11 warn_on console no_keywords
+CONFIG -= app_bundle
+
+include(../../SortFilterProxyModel.pri)
+
+HEADERS += \
+    benchmarkmodel.h
+
+SOURCES += \
+    tst_benchmarks.cpp \
+    benchmarkmodel.cpp
@@ -0,0 +1,323 @@
+/*
+    Benchmarks of the filters, sorters and proxy roles on deterministic source models of 10k, 100k and 1M rows.
+
+    The proxy models are created before the measurements, which only cover the passes over the rows.
+    The output format is chosen with the usual Qt Test options, for example: tst_benchmarks -o results.xml,xml
+*/
+
+#include <QtTest>
+#include <QQmlEngine>
+#include <QQmlComponent>
+#include <QQmlContext>
+#include <QSortFilterProxyModel>
+#include "benchmarkmodel.h"
+
+namespace {
+
+const int BatchSize = 100;
+
+QString proxyModelQml(const QString& content)
+{
+    return QStringLiteral("import QtQml 2.2\n"
+                          "import SortFilterProxyModel 0.2\n"
+                          "SortFilterProxyModel {\n"
+                          "    sourceModel: benchmarkModel\n"
+                          "%1\n"
+                          "}\n").arg(content);
+}
+
+// filters and sorts all the rows again, without the results the proxy model caches for its previous filters
+void runPass(QObject* proxyModel)
+{
+    QMetaObject::invokeMethod(proxyModel, "clearFilterResults");
+    QMetaObject::invokeMethod(proxyModel, "invalidate");
+    proxyModel->property("count");
+}
+
+}
+
+class Benchmarks : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void plainProxyModel_data();
+    void plainProxyModel();
+    void filter_data();
+    void filter();
+    void sorter_data();
+    void sorter();
+    void proxyRole_data();
+    void proxyRole();
+    void invalidation_data();
+    void invalidation();
+    void insertion_data();
+    void insertion();
+    void removal_data();
+    void removal();
+    void dataChanged_data();
+    void dataChanged();
+
+private:
+    void addRowCounts();
+    void addRowCounts(const QString& name, const QString& content);
+    QObject* createProxyModel(BenchmarkModel& model, const QString& content);
+
+    QQmlEngine m_engine;
+};
+
+void Benchmarks::addRowCounts()
+{
+    QTest::addColumn<int>("rowCount");
+    QTest::newRow("10k") << 10000;
+    QTest::newRow("100k") << 100000;
+    QTest::newRow("1M") << 1000000;
+}
+
+void Benchmarks::addRowCounts(const QString& name, const QString& content)
+{
+    const QPair<const char*, int> rowCounts[] = { {"10k", 10000}, {"100k", 100000}, {"1M", 1000000} };
+    for (const auto& rowCount : rowCounts)
+        QTest::newRow(qPrintable(name + QLatin1Char('/') + QLatin1String(rowCount.first))) << rowCount.second << content;
+}
+
+QObject* Benchmarks::createProxyModel(BenchmarkModel& model, const QString& content)
+{
+    m_engine.rootContext()->setContextProperty(QStringLiteral("benchmarkModel"), &model);
+    QQmlComponent component(&m_engine);
+    component.setData(proxyModelQml(content).toUtf8(), QUrl());
+    QObject* proxyModel = component.create();
+    if (!proxyModel)
+        qWarning() << component.errors();
+    return proxyModel;
+}
+
+// the same filtering and sorting with QSortFilterProxyModel alone, as a reference
+void Benchmarks::plainProxyModel_data()
+{
+    addRowCounts();
+}
+
+void Benchmarks::plainProxyModel()
+{
+    QFETCH(int, rowCount);
+    BenchmarkModel model(rowCount);
+    QSortFilterProxyModel proxyModel;
+    proxyModel.setFilterRole(BenchmarkModel::CategoryRole);
+    proxyModel.setFilterFixedString(QStringLiteral("cat-3"));
+    proxyModel.setSortRole(BenchmarkModel::ValueRole);
+    proxyModel.setSourceModel(&model);
+    proxyModel.sort(0);
+
+    QBENCHMARK {
+        proxyModel.invalidate();
+        proxyModel.rowCount();
+    }
+}
+
+// filters all the rows again with the filter of a proxy model
+void Benchmarks::filter_data()
+{
+    QTest::addColumn<int>("rowCount");
+    QTest::addColumn<QString>("content");
+
+    addRowCounts("ValueFilter", "filters: ValueFilter { roleName: \"category\"; value: \"cat-3\" }");
+    addRowCounts("ValueFilterIndexed", "indexedRoleNames: [\"category\"]\n"
+                                       "filters: ValueFilter { roleName: \"category\"; value: \"cat-3\" }");
+    addRowCounts("ValuesFilter", "filters: ValuesFilter { roleName: \"category\"; values: [\"cat-1\", \"cat-5\"] }");
+    addRowCounts("RangeFilter", "filters: RangeFilter { roleName: \"value\"; minimumValue: 250; maximumValue: 750 }");
+    addRowCounts("RangeFilterOrderedIndex", "orderedIndexedRoleNames: [\"value\"]\n"
+                                            "filters: RangeFilter { roleName: \"value\"; minimumValue: 250; maximumValue: 750 }");
+    addRowCounts("RegExpFilter", "filters: RegExpFilter { roleName: \"name\"; pattern: \"^k[a-z]+ri\" }");
+    addRowCounts("RegExpFilterLiteral", "filters: RegExpFilter { roleName: \"name\"; pattern: \"note\" }");
+    addRowCounts("IndexFilter", "filters: IndexFilter { minimumIndex: 100; maximumIndex: -100 }");
+    addRowCounts("ExpressionFilter", "filters: ExpressionFilter { expression: model.id % 3 === 0 }");
+    addRowCounts("FuzzyFilter", "filters: FuzzyFilter { roleName: \"name\"; pattern: \"kri\" }");
+    addRowCounts("AllOf", "filters: AllOf {\n"
+                          "    ValueFilter { roleName: \"flag\"; value: true }\n"
+                          "    RangeFilter { roleName: \"value\"; maximumValue: 500 }\n"
+                          "}");
+    addRowCounts("AnyOf", "filters: AnyOf {\n"
+                          "    ValueFilter { roleName: \"flag\"; value: true }\n"
+                          "    RangeFilter { roleName: \"value\"; maximumValue: 500 }\n"
+                          "}");
+}
+
+void Benchmarks::filter()
+{
+    QFETCH(int, rowCount);
+    QFETCH(QString, content);
+    BenchmarkModel model(rowCount);
+    QScopedPointer<QObject> proxyModel(createProxyModel(model, content));
+    QVERIFY(proxyModel);
+    proxyModel->property("count");
+
+    QBENCHMARK {
+        runPass(proxyModel.data());
+    }
+}
+
+// sorts all the rows again with the sorter of a proxy model
+void Benchmarks::sorter_data()
+{
+    QTest::addColumn<int>("rowCount");
+    QTest::addColumn<QString>("content");
+
+    addRowCounts("RoleSorterNumber", "sorters: RoleSorter { roleName: \"value\" }");
+    addRowCounts("RoleSorterString", "sorters: RoleSorter { roleName: \"name\" }");
+    addRowCounts("RoleSorterDate", "sorters: RoleSorter { roleName: \"date\"; sortOrder: Qt.DescendingOrder }");
+    addRowCounts("RoleSorterChain", "sorters: [\n"
+                                    "    RoleSorter { roleName: \"category\"; priority: 1 },\n"
+                                    "    RoleSorter { roleName: \"value\"; sortOrder: Qt.DescendingOrder }\n"
+                                    "]");
+    addRowCounts("StringSorter", "sorters: StringSorter { roleName: \"name\" }");
+    addRowCounts("FilterSorter", "sorters: FilterSorter { ValueFilter { roleName: \"flag\"; value: true } }");
+    addRowCounts("ExpressionSorter", "sorters: ExpressionSorter { expression: modelLeft.value < modelRight.value }");
+    addRowCounts("FuzzySorter", "filters: FuzzyFilter { id: fuzzyFilter; roleName: \"name\"; pattern: \"ka\" }\n"
+                                "sorters: FuzzySorter { filter: fuzzyFilter }");
+    addRowCounts("sortRoleName", "sortRoleName: \"value\"");
+}
+
+void Benchmarks::sorter()
+{
+    QFETCH(int, rowCount);
+    QFETCH(QString, content);
+    BenchmarkModel model(rowCount);
+    QScopedPointer<QObject> proxyModel(createProxyModel(model, content));
+    QVERIFY(proxyModel);
+    proxyModel->property("count");
+
+    QBENCHMARK {
+        runPass(proxyModel.data());
+    }
+}
+
+// reads the data of a proxy role for all the rows
+void Benchmarks::proxyRole_data()
+{
+    QTest::addColumn<int>("rowCount");
+    QTest::addColumn<QString>("content");
+
+    addRowCounts("JoinRole", "proxyRoles: JoinRole { name: \"benchmarkRole\"; roleNames: [\"name\", \"category\"] }");
+    addRowCounts("SwitchRole", "proxyRoles: SwitchRole {\n"
+                               "    name: \"benchmarkRole\"\n"
+                               "    ValueFilter { roleName: \"category\"; value: \"cat-1\"; SwitchRole.value: \"one\" }\n"
+                               "    ValueFilter { roleName: \"category\"; value: \"cat-2\"; SwitchRole.value: \"two\" }\n"
+                               "    ValueFilter { roleName: \"category\"; value: \"cat-3\"; SwitchRole.value: \"three\" }\n"
+                               "    defaultRoleName: \"category\"\n"
+                               "}");
+    addRowCounts("ExpressionRole", "proxyRoles: ExpressionRole { name: \"benchmarkRole\"; expression: model.value * 2 }");
+    addRowCounts("RegExpRole", "proxyRoles: RegExpRole { roleName: \"name\"; pattern: \"(?<benchmarkRole>[a-z]{2})(?<second>[a-z]{2})\" }");
+    addRowCounts("FilterRole", "proxyRoles: FilterRole { name: \"benchmarkRole\"; ValueFilter { roleName: \"flag\"; value: true } }");
+    addRowCounts("FuzzyScoreRole", "filters: FuzzyFilter { id: fuzzyFilter; roleName: \"name\"; pattern: \"ka\" }\n"
+                                   "proxyRoles: FuzzyScoreRole { name: \"benchmarkRole\"; filter: fuzzyFilter }");
+}
+
+void Benchmarks::proxyRole()
+{
+    QFETCH(int, rowCount);
+    QFETCH(QString, content);
+    BenchmarkModel model(rowCount);
+    QScopedPointer<QObject> proxyModel(createProxyModel(model, content));
+    QVERIFY(proxyModel);
+
+    auto itemModel = qobject_cast<QAbstractItemModel*>(proxyModel.data());
+    int role = itemModel->roleNames().key("benchmarkRole", -1);
+    QVERIFY(role != -1);
+
+    QBENCHMARK {
+        for (int row = 0, count = itemModel->rowCount(); row < count; ++row)
+            itemModel->data(itemModel->index(row, 0), role);
+    }
+}
+
+// changes a filter and a sorter so that all the rows are filtered and sorted again
+void Benchmarks::invalidation_data()
+{
+    addRowCounts();
+}
+
+void Benchmarks::invalidation()
+{
+    QFETCH(int, rowCount);
+    BenchmarkModel model(rowCount);
+    QScopedPointer<QObject> proxyModel(createProxyModel(model,
+        "filters: RangeFilter { objectName: \"rangeFilter\"; roleName: \"value\"; minimumValue: 0 }\n"
+        "sorters: RoleSorter { objectName: \"roleSorter\"; roleName: \"value\" }"));
+    QVERIFY(proxyModel);
+    QObject* rangeFilter = proxyModel->findChild<QObject*>(QStringLiteral("rangeFilter"));
+    QObject* roleSorter = proxyModel->findChild<QObject*>(QStringLiteral("roleSorter"));
+    QVERIFY(rangeFilter && roleSorter);
+
+    // cycling over more bounds than the proxy model caches results for, so that each change is a full filter pass
+    int iteration = 0;
+    QBENCHMARK {
+        ++iteration;
+        rangeFilter->setProperty("minimumValue", (iteration % 32) * 10);
+        roleSorter->setProperty("ascendingOrder", iteration % 2 == 0);
+        proxyModel->property("count");
+    }
+}
+
+// the modifications of the source model are done with a filter and a sorter, on rows in the middle of the model
+void Benchmarks::insertion_data()
+{
+    addRowCounts();
+}
+
+void Benchmarks::insertion()
+{
+    QFETCH(int, rowCount);
+    BenchmarkModel model(rowCount);
+    QScopedPointer<QObject> proxyModel(createProxyModel(model,
+        "filters: RangeFilter { roleName: \"value\"; maximumValue: 500 }\n"
+        "sorters: RoleSorter { roleName: \"value\" }"));
+    QVERIFY(proxyModel);
+
+    QBENCHMARK {
+        model.insertGeneratedRows(model.rowCount() / 2, BatchSize);
+    }
+}
+
+void Benchmarks::removal_data()
+{
+    addRowCounts();
+}
+
+void Benchmarks::removal()
+{
+    QFETCH(int, rowCount);
+    BenchmarkModel model(rowCount);
+    QScopedPointer<QObject> proxyModel(createProxyModel(model,
+        "filters: RangeFilter { roleName: \"value\"; maximumValue: 500 }\n"
+        "sorters: RoleSorter { roleName: \"value\" }"));
+    QVERIFY(proxyModel);
+
+    // measured once, repeated removals would empty the smaller models
+    QBENCHMARK_ONCE {
+        model.removeRows(model.rowCount() / 2, BatchSize);
+    }
+}
+
+void Benchmarks::dataChanged_data()
+{
+    addRowCounts();
+}
+
+void Benchmarks::dataChanged()
+{
+    QFETCH(int, rowCount);
+    BenchmarkModel model(rowCount);
+    QScopedPointer<QObject> proxyModel(createProxyModel(model,
+        "filters: RangeFilter { roleName: \"value\"; maximumValue: 500 }\n"
+        "sorters: RoleSorter { roleName: \"value\" }"));
+    QVERIFY(proxyModel);
+
+    QBENCHMARK {
+        model.changeRows(model.rowCount() / 2, BatchSize);
+    }
+}
+
+QTEST_GUILESS_MAIN(Benchmarks)
+
+#include "tst_benchmarks.moc"
@@ -0,0 +1,285 @@
+/*
+    Replays a workload recorded by a WorkloadRecorder and reports the time spent by the SortFilterProxyModel.
+
+    usage: sfpm-replay [--realtime] [--repeat N] file
+
+    The proxy model is rebuilt from the recorded configuration over a model holding the recorded source data,
+    then the source changes and property changes are applied in order, at full speed by default
+    or spaced like they were recorded with --realtime. Queued invalidations of delayed models are run after each record.
+*/
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QQmlEngine>
+#include <QQmlComponent>
+#include <QQmlContext>
+#include <QElapsedTimer>
+#include <QThread>
+#include <QFile>
+#include <QDataStream>
+#include <QTextStream>
+#include <QMap>
+#include <cstdio>
+#include "qqmlsortfilterproxymodel.h"
+#include "utils/workloadrecorder.h"
+#include "replaymodel.h"
+
+using namespace qqsfpm;
+
+namespace {
+
+struct Record {
+    WorkloadRecorder::RecordType type;
+    qint64 timestamp;
+    QVariantList arguments;
+};
+
+struct Timing {
+    int count = 0;
+    qint64 totalNsecs = 0;
+    qint64 maxNsecs = 0;
+};
+
+const char* const RecordNames[] = { "configuration", "snapshot", "property", "rowsInserted", "rowsRemoved", "rowsMoved", "dataChanged", "layoutChanged" };
+
+bool readRecords(const QString& fileName, QList<Record>& records, QString& error)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        error = file.errorString();
+        return false;
+    }
+    if (file.read(WorkloadRecorder::Magic.size()) != WorkloadRecorder::Magic) {
+        error = QStringLiteral("not a workload file");
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(WorkloadRecorder::StreamVersion);
+    while (!stream.atEnd()) {
+        quint8 type;
+        Record record;
+        stream >> type >> record.timestamp;
+        record.type = static_cast<WorkloadRecorder::RecordType>(type);
+        switch (record.type) {
+        case WorkloadRecorder::ConfigurationRecord: {
+            QVariantMap configuration;
+            stream >> configuration;
+            record.arguments << configuration;
+            break;
+        }
+        case WorkloadRecorder::SnapshotRecord:
+        case WorkloadRecorder::RowsInsertedRecord: {
+            QStringList roleNames;
+            int first = 0;
+            QVariantList rows;
+            if (record.type == WorkloadRecorder::SnapshotRecord)
+                stream >> roleNames;
+            else
+                stream >> first;
+            stream >> rows;
+            record.arguments << roleNames << first << QVariant(rows);
+            break;
+        }
+        case WorkloadRecorder::PropertyRecord: {
+            QString path, name;
+            QVariant value;
+            stream >> path >> name >> value;
+            record.arguments << path << name << value;
+            break;
+        }
+        case WorkloadRecorder::RowsRemovedRecord:
+        case WorkloadRecorder::RowsMovedRecord: {
+            int first, last, destination = 0;
+            stream >> first >> last;
+            if (record.type == WorkloadRecorder::RowsMovedRecord)
+                stream >> destination;
+            record.arguments << first << last << destination;
+            break;
+        }
+        case WorkloadRecorder::DataChangedRecord: {
+            int first;
+            QStringList roleNames;
+            QVariantList rows;
+            stream >> first >> roleNames >> rows;
+            record.arguments << first << roleNames << QVariant(rows);
+            break;
+        }
+        case WorkloadRecorder::LayoutChangedRecord: {
+            QVector<int> previousRows;
+            stream >> previousRows;
+            QVariantList rows;
+            rows.reserve(previousRows.size());
+            for (int row : previousRows)
+                rows.append(row);
+            record.arguments << QVariant(rows);
+            break;
+        }
+        default:
+            error = QStringLiteral("unknown record type %1").arg(static_cast<int>(type));
+            return false;
+        }
+        if (stream.status() != QDataStream::Ok) {
+            error = QStringLiteral("truncated file");
+            return false;
+        }
+        records.append(record);
+    }
+    return true;
+}
+
+// the QML declaration of an object of the configuration, its properties are set separately
+QString qmlDeclaration(const QVariantMap& node, bool root)
+{
+    QStringList members;
+    if (root)
+        members << QStringLiteral("sourceModel: replayModel");
+    for (const char* listName : { "filters", "sorters", "proxyRoles" }) {
+        const QVariantList children = node.value(QLatin1String(listName)).toList();
+        if (children.isEmpty())
+            continue;
+        QStringList declarations;
+        for (const QVariant& child : children)
+            declarations << qmlDeclaration(child.toMap(), false);
+        members << QStringLiteral("%1: [%2]").arg(QLatin1String(listName), declarations.join(QStringLiteral(", ")));
+    }
+    return QStringLiteral("%1 { %2 }").arg(node.value(QStringLiteral("type")).toString(), members.join(QStringLiteral("; ")));
+}
+
+void setProperties(QObject* object, const QVariantMap& node)
+{
+    const QVariantMap properties = node.value(QStringLiteral("properties")).toMap();
+    for (auto it = properties.cbegin(); it != properties.cend(); ++it)
+        object->setProperty(qPrintable(it.key()), it.value());
+
+    for (const auto& child : WorkloadRecorder::children(object)) {
+        const QString listName = child.first.section(QLatin1Char('/'), 0, 0);
+        const int index = child.first.section(QLatin1Char('/'), 1, 1).toInt();
+        setProperties(child.second, node.value(listName).toList().value(index).toMap());
+    }
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("Replays a SortFilterProxyModel workload recorded by a WorkloadRecorder."));
+    parser.addHelpOption();
+    QCommandLineOption realtimeOption(QStringLiteral("realtime"), QStringLiteral("Replay the records at the pace they were recorded."));
+    QCommandLineOption repeatOption(QStringLiteral("repeat"), QStringLiteral("Replay the workload <count> times."), QStringLiteral("count"), QStringLiteral("1"));
+    parser.addOption(realtimeOption);
+    parser.addOption(repeatOption);
+    parser.addPositionalArgument(QStringLiteral("file"), QStringLiteral("The workload file."));
+    parser.process(app);
+    if (parser.positionalArguments().size() != 1)
+        parser.showHelp(1);
+
+    QList<Record> records;
+    QString error;
+    if (!readRecords(parser.positionalArguments().first(), records, error)) {
+        std::fprintf(stderr, "%s\n", qPrintable(error));
+        return 1;
+    }
+    if (records.size() < 2 || records.at(0).type != WorkloadRecorder::ConfigurationRecord || records.at(1).type != WorkloadRecorder::SnapshotRecord) {
+        std::fprintf(stderr, "the workload doesn't start with a configuration and a snapshot\n");
+        return 1;
+    }
+
+    const bool realtime = parser.isSet(realtimeOption);
+    const int repeat = qMax(1, parser.value(repeatOption).toInt());
+    const QVariantMap configuration = records.at(0).arguments.first().toMap();
+    QMap<int, Timing> timings;
+    qint64 totalNsecs = 0;
+    int finalCount = 0;
+
+    QQmlEngine engine;
+    for (int iteration = 0; iteration < repeat; ++iteration) {
+        ReplayModel model;
+        model.reset(records.at(1).arguments.at(0).toStringList(), records.at(1).arguments.at(2).toList());
+        engine.rootContext()->setContextProperty(QStringLiteral("replayModel"), &model);
+
+        QQmlComponent component(&engine);
+        component.setData("import SortFilterProxyModel 0.2\n" + qmlDeclaration(configuration, true).toUtf8(), QUrl());
+        QScopedPointer<QObject> object(component.beginCreate(engine.rootContext()));
+        if (!object) {
+            std::fprintf(stderr, "%s\n", qPrintable(component.errorString()));
+            return 1;
+        }
+        setProperties(object.data(), configuration);
+        QElapsedTimer timer;
+        timer.start();
+        component.completeCreate();
+        auto proxyModel = qobject_cast<QQmlSortFilterProxyModel*>(object.data());
+        proxyModel->rowCount();
+        Timing& creation = timings[-1];
+        ++creation.count;
+        creation.totalNsecs += timer.nsecsElapsed();
+        creation.maxNsecs = qMax(creation.maxNsecs, timer.nsecsElapsed());
+
+        QElapsedTimer replayTimer;
+        replayTimer.start();
+        const qint64 startTimestamp = records.at(1).timestamp;
+        for (int i = 2; i < records.size(); ++i) {
+            const Record& record = records.at(i);
+            if (realtime) {
+                const qint64 delay = record.timestamp - startTimestamp - replayTimer.nsecsElapsed();
+                if (delay > 0)
+                    QThread::usleep(static_cast<unsigned long>(delay / 1000));
+            }
+
+            timer.start();
+            const QVariantList& arguments = record.arguments;
+            switch (record.type) {
+            case WorkloadRecorder::SnapshotRecord:
+                model.reset(arguments.at(0).toStringList(), arguments.at(2).toList());
+                break;
+            case WorkloadRecorder::PropertyRecord:
+                if (QObject* target = WorkloadRecorder::objectAt(proxyModel, arguments.at(0).toString()))
+                    target->setProperty(qPrintable(arguments.at(1).toString()), arguments.at(2));
+                break;
+            case WorkloadRecorder::RowsInsertedRecord:
+                model.insertRecordedRows(arguments.at(1).toInt(), arguments.at(2).toList());
+                break;
+            case WorkloadRecorder::RowsRemovedRecord:
+                model.removeRecordedRows(arguments.at(0).toInt(), arguments.at(1).toInt());
+                break;
+            case WorkloadRecorder::RowsMovedRecord:
+                model.moveRecordedRows(arguments.at(0).toInt(), arguments.at(1).toInt(), arguments.at(2).toInt());
+                break;
+            case WorkloadRecorder::DataChangedRecord:
+                model.changeRecordedRows(arguments.at(0).toInt(), arguments.at(1).toStringList(), arguments.at(2).toList());
+                break;
+            case WorkloadRecorder::LayoutChangedRecord:
+                model.rearrangeRecordedRows(arguments.at(0).toList());
+                break;
+            default:
+                break;
+            }
+            // runs the invalidations queued by delayed models and makes the proxy model update its mapping
+            QCoreApplication::sendPostedEvents();
+            proxyModel->rowCount();
+            const qint64 elapsed = timer.nsecsElapsed();
+
+            Timing& timing = timings[record.type];
+            ++timing.count;
+            timing.totalNsecs += elapsed;
+            timing.maxNsecs = qMax(timing.maxNsecs, elapsed);
+            totalNsecs += elapsed;
+        }
+        finalCount = proxyModel->rowCount();
+    }
+
+    QTextStream out(stdout);
+    out << QStringLiteral("%1 %2 %3 %4\n").arg(QStringLiteral("record"), -16).arg(QStringLiteral("count"), 10)
+                                          .arg(QStringLiteral("total ms"), 12).arg(QStringLiteral("max ms"), 12);
+    for (auto it = timings.cbegin(); it != timings.cend(); ++it) {
+        const QString name = it.key() == -1 ? QStringLiteral("creation") : QString::fromLatin1(RecordNames[it.key()]);
+        out << QStringLiteral("%1 %2 %3 %4\n").arg(name, -16).arg(it->count, 10)
+                                              .arg(it->totalNsecs / 1e6, 12, 'f', 3).arg(it->maxNsecs / 1e6, 12, 'f', 3);
+    }
+    out << QStringLiteral("replayed %1 records %2 times in %3 ms, %4 rows accepted at the end\n")
+           .arg(records.size() - 2).arg(repeat).arg(totalNsecs / 1e6, 0, 'f', 3).arg(finalCount);
+    return 0;
+}
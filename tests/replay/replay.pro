@@ -0,0 +1,14 @@
+TEMPLATE = app
+TARGET = sfpm-replay
+QT += qml
+CONFIG += c++11 warn_on console no_keywords
+CONFIG -= app_bundle
+
+include(../../SortFilterProxyModel.pri)
+
+HEADERS += \
+    replaymodel.h
+
+SOURCES += \
+    main.cpp \
+    replaymodel.cpp
@@ -0,0 +1,109 @@
+#include "replaymodel.h"
+
+int ReplayModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : m_rows.size();
+}
+
+QVariant ReplayModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_rows.size())
+        return QVariant();
+    return m_rows.at(index.row()).value(role - Qt::UserRole);
+}
+
+// the roles are renumbered from Qt::UserRole, in the order they were recorded
+QHash<int, QByteArray> ReplayModel::roleNames() const
+{
+    QHash<int, QByteArray> roleNames;
+    for (int i = 0; i < m_roleNames.size(); ++i)
+        roleNames.insert(Qt::UserRole + i, m_roleNames.at(i).toUtf8());
+    return roleNames;
+}
+
+void ReplayModel::reset(const QStringList& roleNames, const QVariantList& rows)
+{
+    beginResetModel();
+    m_roleNames = roleNames;
+    m_rows.clear();
+    m_rows.reserve(rows.size());
+    for (const QVariant& row : rows)
+        m_rows.append(row.toList());
+    endResetModel();
+}
+
+void ReplayModel::insertRecordedRows(int first, const QVariantList& rows)
+{
+    if (rows.isEmpty())
+        return;
+    beginInsertRows(QModelIndex(), first, first + rows.size() - 1);
+    m_rows.insert(first, rows.size(), QVariantList());
+    for (int i = 0; i < rows.size(); ++i)
+        m_rows[first + i] = rows.at(i).toList();
+    endInsertRows();
+}
+
+void ReplayModel::removeRecordedRows(int first, int last)
+{
+    beginRemoveRows(QModelIndex(), first, last);
+    m_rows.remove(first, last - first + 1);
+    endRemoveRows();
+}
+
+void ReplayModel::moveRecordedRows(int first, int last, int destination)
+{
+    if (!beginMoveRows(QModelIndex(), first, last, QModelIndex(), destination))
+        return;
+    const int count = last - first + 1;
+    QVector<QVariantList> moved = m_rows.mid(first, count);
+    m_rows.remove(first, count);
+    const int target = destination > first ? destination - count : destination;
+    for (int i = 0; i < count; ++i)
+        m_rows.insert(target + i, moved.at(i));
+    endMoveRows();
+}
+
+void ReplayModel::changeRecordedRows(int first, const QStringList& roleNames, const QVariantList& rows)
+{
+    if (rows.isEmpty())
+        return;
+    QVector<int> columns;
+    QVector<int> roles;
+    for (const QString& roleName : roleNames) {
+        columns.append(m_roleNames.indexOf(roleName));
+        roles.append(Qt::UserRole + columns.last());
+    }
+    for (int i = 0; i < rows.size(); ++i) {
+        QVariantList& row = m_rows[first + i];
+        const QVariantList values = rows.at(i).toList();
+        for (int j = 0; j < columns.size() && j < values.size(); ++j) {
+            if (columns.at(j) >= 0 && columns.at(j) < row.size())
+                row[columns.at(j)] = values.at(j);
+        }
+    }
+    Q_EMIT dataChanged(index(first, 0), index(first + rows.size() - 1, 0), roles);
+}
+
+// previousRows holds the previous row of each row, the persistent indexes follow their rows
+void ReplayModel::rearrangeRecordedRows(const QVariantList& previousRows)
+{
+    if (previousRows.size() != m_rows.size())
+        return;
+    Q_EMIT layoutAboutToBeChanged({}, QAbstractItemModel::VerticalSortHint);
+    QVector<QVariantList> rows(m_rows.size());
+    QVector<int> newRows(m_rows.size());
+    for (int row = 0; row < previousRows.size(); ++row) {
+        const int previousRow = previousRows.at(row).toInt();
+        rows[row] = m_rows.at(previousRow);
+        newRows[previousRow] = row;
+    }
+    m_rows.swap(rows);
+
+    const QModelIndexList from = persistentIndexList();
+    QModelIndexList to;
+    to.reserve(from.size());
+    for (const QModelIndex& persistentIndex : from)
+        to.append(index(newRows.at(persistentIndex.row()), persistentIndex.column()));
+    changePersistentIndexList(from, to);
+    Q_EMIT layoutChanged({}, QAbstractItemModel::VerticalSortHint);
+}
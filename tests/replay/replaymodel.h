@@ -0,0 +1,32 @@
+#ifndef REPLAYMODEL_H
+#define REPLAYMODEL_H
+
+#include <QAbstractListModel>
+#include <QVector>
+#include <QStringList>
+
+// a list model rebuilt from the records of a workload file
+class ReplayModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    using QAbstractListModel::QAbstractListModel;
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    void reset(const QStringList& roleNames, const QVariantList& rows);
+    void insertRecordedRows(int first, const QVariantList& rows);
+    void removeRecordedRows(int first, int last);
+    void moveRecordedRows(int first, int last, int destination);
+    void changeRecordedRows(int first, const QStringList& roleNames, const QVariantList& rows);
+    void rearrangeRecordedRows(const QVariantList& previousRows);
+
+private:
+    QStringList m_roleNames;
+    QVector<QVariantList> m_rows;
+};
+
+#endif // REPLAYMODEL_H
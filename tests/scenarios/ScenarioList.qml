@@ -0,0 +1,27 @@
+import QtQuick 2.0
+
+// the ListView shared by the scenarios, its delegates report their creation, destruction and binding evaluations
+ListView {
+    width: 400
+    height: 800
+
+    delegate: Item {
+        width: ListView.view.width
+        height: 20
+
+        Component.onCompleted: scenarioCounters.delegateCreated()
+        Component.onDestruction: scenarioCounters.delegateDestroyed()
+
+        Text {
+            text: scenarioCounters.evaluated(model.name)
+        }
+        Text {
+            x: 200
+            text: scenarioCounters.evaluated(model.value)
+        }
+        Text {
+            x: 300
+            text: scenarioCounters.evaluated(model.category)
+        }
+    }
+}
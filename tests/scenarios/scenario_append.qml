@@ -0,0 +1,19 @@
+import QtQuick 2.0
+import SortFilterProxyModel 0.2
+
+// rows streamed at the end of a filtered and sorted model, like incoming log entries
+Item {
+    readonly property int stepCount: 50
+
+    function step(index) {
+        scenarioModel.append(20);
+    }
+
+    ScenarioList {
+        model: SortFilterProxyModel {
+            sourceModel: scenarioModel
+            filters: ValueFilter { roleName: "flag"; value: false }
+            sorters: RoleSorter { roleName: "date"; sortOrder: Qt.DescendingOrder }
+        }
+    }
+}
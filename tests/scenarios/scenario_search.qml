@@ -0,0 +1,31 @@
+import QtQuick 2.0
+import SortFilterProxyModel 0.2
+
+// typing a search in a text field filtering the names, then erasing it
+Item {
+    readonly property string search: "kanori"
+    readonly property int stepCount: search.length * 2
+
+    function step(index) {
+        if (index < search.length)
+            searchField.insert(searchField.length, search[index]);
+        else
+            searchField.remove(searchField.length - 1, searchField.length);
+    }
+
+    TextInput {
+        id: searchField
+    }
+
+    ScenarioList {
+        y: 20
+        model: SortFilterProxyModel {
+            sourceModel: scenarioModel
+            filters: RegExpFilter {
+                roleName: "name"
+                pattern: searchField.text
+                caseSensitivity: Qt.CaseInsensitive
+            }
+        }
+    }
+}
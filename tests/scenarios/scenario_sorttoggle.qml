@@ -0,0 +1,29 @@
+import QtQuick 2.0
+import SortFilterProxyModel 0.2
+
+// switching between sorters and reversing their order, as with the headers of a table
+Item {
+    readonly property int stepCount: 12
+
+    function step(index) {
+        var sorter = [nameSorter, valueSorter, dateSorter][index % 3];
+        if (sorter.enabled) {
+            sorter.ascendingOrder = !sorter.ascendingOrder;
+        } else {
+            nameSorter.enabled = sorter === nameSorter;
+            valueSorter.enabled = sorter === valueSorter;
+            dateSorter.enabled = sorter === dateSorter;
+        }
+    }
+
+    ScenarioList {
+        model: SortFilterProxyModel {
+            sourceModel: scenarioModel
+            sorters: [
+                StringSorter { id: nameSorter; roleName: "name" },
+                RoleSorter { id: valueSorter; roleName: "value"; enabled: false },
+                RoleSorter { id: dateSorter; roleName: "date"; enabled: false }
+            ]
+        }
+    }
+}
@@ -0,0 +1,20 @@
+import QtQuick 2.0
+import SortFilterProxyModel 0.2
+
+// live updates of a value that is filtered and sorted on, like a quote board
+Item {
+    readonly property int stepCount: 50
+
+    function step(index) {
+        scenarioModel.tick(100);
+    }
+
+    ScenarioList {
+        model: SortFilterProxyModel {
+            sourceModel: scenarioModel
+            filters: RangeFilter { roleName: "value"; minimumValue: 100 }
+            sorters: RoleSorter { roleName: "value"; sortOrder: Qt.DescendingOrder }
+            proxyRoles: ExpressionRole { name: "trend"; expression: model.value > 500 ? "up" : "down" }
+        }
+    }
+}
@@ -0,0 +1,40 @@
+#include "scenariocounters.h"
+
+int ScenarioCounters::createdDelegates() const
+{
+    return m_createdDelegates;
+}
+
+int ScenarioCounters::destroyedDelegates() const
+{
+    return m_destroyedDelegates;
+}
+
+int ScenarioCounters::bindingEvaluations() const
+{
+    return m_bindingEvaluations;
+}
+
+void ScenarioCounters::reset()
+{
+    m_createdDelegates = 0;
+    m_destroyedDelegates = 0;
+    m_bindingEvaluations = 0;
+}
+
+void ScenarioCounters::delegateCreated()
+{
+    ++m_createdDelegates;
+}
+
+void ScenarioCounters::delegateDestroyed()
+{
+    ++m_destroyedDelegates;
+}
+
+// to be wrapped around the value of a binding in a delegate, so that its evaluations are counted
+QVariant ScenarioCounters::evaluated(const QVariant& value)
+{
+    ++m_bindingEvaluations;
+    return value;
+}
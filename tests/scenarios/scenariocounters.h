@@ -0,0 +1,30 @@
+#ifndef SCENARIOCOUNTERS_H
+#define SCENARIOCOUNTERS_H
+
+#include <QObject>
+#include <QVariant>
+
+// counts the delegate churn and the binding evaluations reported by the delegates of a scenario
+class ScenarioCounters : public QObject
+{
+    Q_OBJECT
+
+public:
+    using QObject::QObject;
+
+    int createdDelegates() const;
+    int destroyedDelegates() const;
+    int bindingEvaluations() const;
+    void reset();
+
+    Q_INVOKABLE void delegateCreated();
+    Q_INVOKABLE void delegateDestroyed();
+    Q_INVOKABLE QVariant evaluated(const QVariant& value);
+
+private:
+    int m_createdDelegates = 0;
+    int m_destroyedDelegates = 0;
+    int m_bindingEvaluations = 0;
+};
+
+#endif // SCENARIOCOUNTERS_H
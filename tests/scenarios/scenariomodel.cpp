@@ -0,0 +1,45 @@
+#include "scenariomodel.h"
+
+ScenarioModel::ScenarioModel(int rowCount, QObject* parent) :
+    BenchmarkModel(rowCount, parent)
+{
+}
+
+QVariant ScenarioModel::data(const QModelIndex& index, int role) const
+{
+    ++m_dataCallCounts[role];
+    return BenchmarkModel::data(index, role);
+}
+
+int ScenarioModel::dataCallCount(int role) const
+{
+    return m_dataCallCounts.value(role);
+}
+
+int ScenarioModel::totalDataCallCount() const
+{
+    int total = 0;
+    for (int count : m_dataCallCounts)
+        total += count;
+    return total;
+}
+
+void ScenarioModel::resetCounters()
+{
+    m_dataCallCounts.clear();
+}
+
+void ScenarioModel::append(int count)
+{
+    insertGeneratedRows(rowCount(), count);
+}
+
+// changes the next rows of the model, wrapping around at its end
+void ScenarioModel::tick(int count)
+{
+    count = qMin(count, rowCount());
+    if (m_tickRow + count > rowCount())
+        m_tickRow = 0;
+    changeRows(m_tickRow, count);
+    m_tickRow += count;
+}
@@ -0,0 +1,28 @@
+#ifndef SCENARIOMODEL_H
+#define SCENARIOMODEL_H
+
+#include "benchmarkmodel.h"
+
+// a BenchmarkModel counting its data() calls per role, with invokable modifications for the scenarios
+class ScenarioModel : public BenchmarkModel
+{
+    Q_OBJECT
+
+public:
+    explicit ScenarioModel(int rowCount, QObject* parent = nullptr);
+
+    QVariant data(const QModelIndex& index, int role) const override;
+
+    int dataCallCount(int role) const;
+    int totalDataCallCount() const;
+    void resetCounters();
+
+    Q_INVOKABLE void append(int count);
+    Q_INVOKABLE void tick(int count);
+
+private:
+    mutable QHash<int, int> m_dataCallCounts;
+    int m_tickRow = 0;
+};
+
+#endif // SCENARIOMODEL_H
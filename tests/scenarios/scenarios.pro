@@ -0,0 +1,28 @@
+TEMPLATE = app
+TARGET = tst_scenarios
+QT += qml quick testlib
+CONFIG += c++11 warn_on console no_keywords
+CONFIG -= app_bundle
+
+include(../../SortFilterProxyModel.pri)
+
+INCLUDEPATH += ../benchmarks
+DEFINES += SCENARIOS_DIR=\\\"$$PWD\\\"
+
+HEADERS += \
+    ../benchmarks/benchmarkmodel.h \
+    scenariomodel.h \
+    scenariocounters.h
+
+SOURCES += \
+    tst_scenarios.cpp \
+    ../benchmarks/benchmarkmodel.cpp \
+    scenariomodel.cpp \
+    scenariocounters.cpp
+
+OTHER_FILES += \
+    ScenarioList.qml \
+    scenario_search.qml \
+    scenario_sorttoggle.qml \
+    scenario_append.qml \
+    scenario_ticks.qml
@@ -0,0 +1,96 @@
+/*
+    Scenarios driving a SortFilterProxyModel displayed in a ListView, run headless on the offscreen platform.
+
+    Each scenario_*.qml file of this directory has a stepCount property and a step(index) function,
+    its source model is the scenarioModel context property and its delegates report to scenarioCounters.
+    Every step is followed by a synchronous frame so that the view updates its delegates.
+    For each scenario the wall time of all its steps is reported as the benchmark result,
+    along with the data() calls per role, the created and destroyed delegates and the binding evaluations.
+*/
+
+#include <QtTest>
+#include <QQuickView>
+#include <QQmlEngine>
+#include <QQmlContext>
+#include "scenariomodel.h"
+#include "scenariocounters.h"
+
+class Scenarios : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void scenario_data();
+    void scenario();
+};
+
+void Scenarios::scenario_data()
+{
+    QTest::addColumn<QString>("fileName");
+    QTest::addColumn<int>("rowCount");
+
+    const QStringList fileNames = QDir(QStringLiteral(SCENARIOS_DIR)).entryList({QStringLiteral("scenario_*.qml")}, QDir::Files, QDir::Name);
+    for (const QString& fileName : fileNames) {
+        const QString name = fileName.mid(9, fileName.size() - 13);
+        QTest::newRow(qPrintable(name + QStringLiteral("/10k"))) << fileName << 10000;
+        QTest::newRow(qPrintable(name + QStringLiteral("/100k"))) << fileName << 100000;
+    }
+}
+
+void Scenarios::scenario()
+{
+    QFETCH(QString, fileName);
+    QFETCH(int, rowCount);
+
+    ScenarioModel model(rowCount);
+    ScenarioCounters counters;
+    QQuickView view;
+    view.rootContext()->setContextProperty(QStringLiteral("scenarioModel"), &model);
+    view.rootContext()->setContextProperty(QStringLiteral("scenarioCounters"), &counters);
+    view.setSource(QUrl::fromLocalFile(QDir(QStringLiteral(SCENARIOS_DIR)).filePath(fileName)));
+    QVERIFY2(view.status() == QQuickView::Ready, qPrintable(view.errors().isEmpty() ? QString() : view.errors().first().toString()));
+    view.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&view));
+
+    QQuickItem* root = view.rootObject();
+    const int stepCount = root->property("stepCount").toInt();
+    QVERIFY(stepCount > 0);
+
+    // the initial population of the view isn't part of the scenario
+    view.grabWindow();
+    model.resetCounters();
+    counters.reset();
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < stepCount; ++i) {
+        QVERIFY(QMetaObject::invokeMethod(root, "step", Q_ARG(QVariant, i)));
+        view.grabWindow(); // polishes the view, creating and destroying its delegates
+    }
+    QTest::setBenchmarkResult(timer.elapsed(), QTest::WalltimeMilliseconds);
+
+    const QHash<int, QByteArray> roleNames = model.roleNames();
+    QStringList dataCalls;
+    for (auto it = roleNames.constBegin(); it != roleNames.constEnd(); ++it) {
+        if (int count = model.dataCallCount(it.key()))
+            dataCalls << QStringLiteral("%1=%2").arg(QString::fromUtf8(it.value())).arg(count);
+    }
+    dataCalls.sort();
+    qInfo("steps: %d, data() calls: %d (%s)", stepCount, model.totalDataCallCount(), qPrintable(dataCalls.join(QStringLiteral(", "))));
+    qInfo("delegates created: %d, destroyed: %d, binding evaluations: %d",
+          counters.createdDelegates(), counters.destroyedDelegates(), counters.bindingEvaluations());
+}
+
+int main(int argc, char* argv[])
+{
+    if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    if (!qEnvironmentVariableIsSet("QT_QUICK_BACKEND"))
+        qputenv("QT_QUICK_BACKEND", "software");
+
+    QGuiApplication app(argc, argv);
+    Scenarios scenarios;
+    return QTest::qExec(&scenarios, argc, argv);
+}
+
+#include "tst_scenarios.moc"
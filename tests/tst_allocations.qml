@@ -0,0 +1,116 @@
+import QtQuick 2.0
+import QtTest 1.1
+import SortFilterProxyModel 0.2
+import SortFilterProxyModel.Test 0.2
+
+Item {
+    AllocationTestModel {
+        id: allocationTestModel
+    }
+
+    SortFilterProxyModel {
+        id: testModel
+        sourceModel: allocationTestModel
+        statistics.enabled: true
+    }
+
+    // evaluated with each tested filter, so that the filters are ordered by their measures
+    RangeFilter {
+        id: acceptingFilter
+        roleName: "number"
+        minimumValue: 0
+    }
+
+    AllocationCounter {
+        id: allocationCounter
+    }
+
+    property list<QtObject> filters: [
+        ValueFilter {
+            property string tag: "ValueFilter"
+            roleName: "text"
+            value: "item 3"
+        },
+        RangeFilter {
+            property string tag: "RangeFilter"
+            roleName: "number"
+            minimumValue: 10
+            maximumValue: 40
+        },
+        RangeFilter {
+            property string tag: "RangeFilterReal"
+            roleName: "real"
+            minimumValue: 2.5
+        },
+        RegExpFilter {
+            property string tag: "RegExpFilterLiteral"
+            roleName: "text"
+            pattern: "ITEM 1"
+            caseSensitivity: Qt.CaseInsensitive
+        },
+        RegExpFilter {
+            property string tag: "RegExpFilter"
+            roleName: "text"
+            pattern: "^item [0-9]+$"
+        },
+        IndexFilter {
+            property string tag: "IndexFilter"
+            minimumIndex: 5
+            maximumIndex: -5
+        }
+    ]
+
+    property list<QtObject> sorters: [
+        RoleSorter {
+            property string tag: "RoleSorterNumber"
+            roleName: "number"
+        },
+        RoleSorter {
+            property string tag: "RoleSorterText"
+            roleName: "text"
+            sortOrder: Qt.DescendingOrder
+        },
+        StringSorter {
+            property string tag: "StringSorter"
+            roleName: "text"
+        }
+    ]
+
+    TestCase {
+        name: "Allocations"
+
+        function init() {
+            if (!allocationCounter.available)
+                skip("Allocations can't be counted on this platform");
+        }
+
+        function cleanup() {
+            testModel.filters = [];
+            testModel.sorters = [];
+        }
+
+        function test_filter_data() {
+            return filters;
+        }
+
+        function test_filter(filter) {
+            testModel.filters = [filter, acceptingFilter];
+            compare(allocationCounter.rowAllocations(testModel), 0);
+        }
+
+        function test_sorter_data() {
+            return sorters;
+        }
+
+        function test_sorter(sorter) {
+            testModel.sorters = [sorter];
+            compare(allocationCounter.rowAllocations(testModel), 0);
+        }
+
+        function test_filterAndSorter() {
+            testModel.filters = [filters[1], acceptingFilter];
+            testModel.sorters = [sorters[0], sorters[2]];
+            compare(allocationCounter.rowAllocations(testModel), 0);
+        }
+    }
+}
@@ -0,0 +1,162 @@
+import QtQuick 2.0
+import QtQml 2.2
+import QtTest 1.1
+import SortFilterProxyModel 0.2
+
+Item {
+    ListModel {
+        id: listModel
+        ListElement { name: "a"; group: 1; score: 1 }
+        ListElement { name: "b"; group: 2; score: 2 }
+        ListElement { name: "c"; group: 1; score: 3 }
+        ListElement { name: "d"; group: 3; score: 4 }
+        ListElement { name: "e"; group: 1; score: 5 }
+        ListElement { name: "f"; group: 2; score: 6 }
+    }
+
+    SortFilterProxyModel {
+        id: testModel
+        sourceModel: listModel
+        indexedRoleNames: ["group"]
+        filters: [
+            ValueFilter {
+                objectName: "groupFilter"
+                roleName: "group"
+                value: 1
+            },
+            AnyOf {
+                objectName: "anyOf"
+                RegExpFilter {
+                    objectName: "nameFilter"
+                    roleName: "name"
+                    pattern: "a"
+                }
+                ExpressionFilter {
+                    objectName: "scoreFilter"
+                    expression: model.score > 4
+                }
+            }
+        ]
+        sorters: [
+            StringSorter {
+                objectName: "disabledSorter"
+                roleName: "name"
+                enabled: false
+            },
+            RoleSorter {
+                objectName: "scoreSorter"
+                roleName: "score"
+                sortOrder: Qt.DescendingOrder
+            }
+        ]
+        proxyRoles: FilterRole {
+            name: "isFirstGroup"
+            ValueFilter {
+                roleName: "group"
+                value: 1
+            }
+        }
+    }
+
+    TestCase {
+        name: "Explain"
+
+        function test_explain() {
+            var plan = testModel.explain();
+            compare(plan.type, "SortFilterProxyModel");
+            compare(plan.sourceRows, 6);
+            compare(plan.rows, 2);
+            compare(plan.indexedRoleNames, ["group"]);
+            verify(plan.baseFilter === undefined);
+
+            compare(plan.filters.length, 2);
+            var groupFilter = plan.filters[0];
+            compare(groupFilter.type, "ValueFilter");
+            compare(groupFilter.order, 0);
+            compare(groupFilter.roleName, "group");
+            compare(groupFilter.cost, "role");
+            compare(groupFilter.access, "rowList");
+            compare(groupFilter.cached, true);
+            verify(groupFilter.rowsIn === undefined);
+
+            var anyOf = plan.filters[1];
+            compare(anyOf.type, "AnyOf");
+            compare(anyOf.order, 1);
+            compare(anyOf.cost, "text");
+            compare(anyOf.access, "rowScan");
+            compare(anyOf.cached, false);
+            compare(anyOf.filters.length, 2);
+            compare(anyOf.filters[0].objectName, "nameFilter");
+            compare(anyOf.filters[0].cost, "text");
+            compare(anyOf.filters[0].literal, true);
+            compare(anyOf.filters[1].objectName, "scoreFilter");
+            compare(anyOf.filters[1].order, 1);
+            // the simple expression is evaluated natively
+            compare(anyOf.filters[1].cost, "role");
+        }
+
+        function test_explainSorters() {
+            var sorters = testModel.explain().sorters;
+            compare(sorters.length, 2);
+            compare(sorters[0].objectName, "scoreSorter");
+            compare(sorters[0].order, 0);
+            compare(sorters[0].sortOrder, "descending");
+            compare(sorters[0].access, "sortKey");
+            compare(sorters[1].objectName, "disabledSorter");
+            compare(sorters[1].enabled, false);
+            compare(sorters[1].cost, "text");
+            verify(sorters[1].order === undefined);
+        }
+
+        function test_explainProxyRoles() {
+            var proxyRoles = testModel.explain().proxyRoles;
+            compare(proxyRoles.length, 1);
+            compare(proxyRoles[0].type, "FilterRole");
+            compare(proxyRoles[0].names, ["isFirstGroup"]);
+            compare(proxyRoles[0].filters.length, 1);
+        }
+
+        function test_analyze() {
+            var plan = testModel.analyze();
+            compare(plan.acceptedRows, 2);
+            compare(testModel.count, 2);
+
+            var groupFilter = plan.filters[0];
+            compare(groupFilter.rowsIn, 6);
+            compare(groupFilter.rowsOut, 3);
+            compare(groupFilter.dataCalls, 6);
+            compare(groupFilter.listedRows, 3);
+            verify(groupFilter.time >= 0);
+
+            var anyOf = plan.filters[1];
+            compare(anyOf.rowsIn, 3);
+            compare(anyOf.rowsOut, 2);
+            compare(anyOf.filters[0].rowsIn, 3);
+            compare(anyOf.filters[0].rowsOut, 1);
+            compare(anyOf.filters[1].rowsIn, 2);
+            compare(anyOf.filters[1].rowsOut, 1);
+
+            compare(plan.sorters[0].comparisons, 1);
+            compare(plan.sorters[0].dataCalls, 2);
+            compare(plan.sorters[1].comparisons, 0);
+
+            compare(plan.proxyRoles[0].rowsIn, 2);
+            compare(plan.proxyRoles[0].filters[0].rowsIn, 2);
+            compare(plan.proxyRoles[0].filters[0].rowsOut, 2);
+        }
+
+        function test_analyzeBaseFilter() {
+            testModel.filterRoleName = "name";
+            testModel.filterPattern = "[a-c]";
+            var plan = testModel.analyze();
+            compare(plan.baseFilter.roleName, "name");
+            compare(plan.baseFilter.cost, "text");
+            compare(plan.baseFilter.rowsIn, 6);
+            compare(plan.baseFilter.rowsOut, 3);
+            compare(plan.filters[0].rowsIn, 3);
+            compare(plan.acceptedRows, 1);
+            testModel.filterPattern = "";
+            testModel.filterRoleName = "";
+        }
+    }
+}
@@ -0,0 +1,127 @@
+import QtQuick 2.0
+import QtQml 2.2
+import QtTest 1.1
+import SortFilterProxyModel 0.2
+
+Item {
+    id: root
+    property int minimum: 2
+    property string dynamicRole: "name"
+
+    ListModel {
+        id: listModel
+        ListElement { name: "a"; value: 3 }
+        ListElement { name: "b"; value: 1 }
+        ListElement { name: "c"; value: 4 }
+        ListElement { name: "d"; value: 2 }
+    }
+
+    SortFilterProxyModel {
+        id: testModel
+        sourceModel: listModel
+        filters: ExpressionFilter {
+            expression: model.value >= root.minimum && doubled > 0
+        }
+        sorters: ExpressionSorter {
+            expression: modelLeft.doubled > modelRight.doubled
+        }
+        proxyRoles: [
+            ExpressionRole {
+                name: "doubled"
+                expression: model.value * 2
+            },
+            ExpressionRole {
+                name: "label"
+                expression: name + ":" + model.doubled + ":" + index
+            },
+            ExpressionRole {
+                name: "summary"
+                expression: Math.round(tripled) + "/" + model[root.dynamicRole]
+            },
+            ExpressionRole {
+                name: "tripled"
+                expression: Math.round(model.value * 3)
+            }
+        ]
+    }
+
+    SortFilterProxyModel {
+        id: modelValuesModel
+        sourceModel: listModel
+        sorters: ExpressionSorter {
+            expression: JSON.parse(JSON.stringify(modelLeft)).value < JSON.parse(JSON.stringify(modelRight)).value
+        }
+        proxyRoles: [
+            ExpressionRole {
+                name: "row"
+                expression: model
+            },
+            ExpressionRole {
+                name: "keys"
+                expression: Object.keys(model).join(",")
+            }
+        ]
+    }
+
+    TestCase {
+        name: "ExpressionContext"
+
+        function test_sharedContext() {
+            compare(testModel.count, 3);
+            compare(testModel.get(0, "name"), "c");
+            compare(testModel.get(1, "name"), "a");
+            compare(testModel.get(2, "name"), "d");
+            compare(testModel.get(0, "label"), "c:8:2");
+            compare(testModel.get(2, "label"), "d:4:3");
+        }
+
+        function test_chainedRoles() {
+            // the roles are read before the context is bound, whichever role is evaluated first
+            compare(testModel.get(0, "summary"), "12/c");
+            compare(testModel.get(1, "tripled"), 9);
+            compare(testModel.get(1, "summary"), "9/a");
+            compare(testModel.get(2, "summary"), "6/d");
+            compare(testModel.get(2, "label"), "d:4:3");
+        }
+
+        function test_dynamicRole() {
+            // model[...] can read any role, all the roles are bound
+            root.dynamicRole = "value";
+            compare(testModel.get(0, "summary"), "12/4");
+            root.dynamicRole = "name";
+            compare(testModel.get(0, "summary"), "12/c");
+        }
+
+        function test_modelValues() {
+            // a model object used as a value holds the data of its own row
+            compare(modelValuesModel.count, 4);
+            var rows = [];
+            for (var i = 0; i < modelValuesModel.count; ++i)
+                rows.push(modelValuesModel.get(i, "row"));
+            for (i = 0; i < rows.length; ++i) {
+                compare(rows[i].name, modelValuesModel.get(i, "name"));
+                compare(rows[i].value, modelValuesModel.get(i, "value"));
+            }
+            compare(rows[0].name, "b");
+            compare(rows[3].name, "c");
+
+            var keys = modelValuesModel.get(0, "keys").split(",");
+            verify(keys.indexOf("name") >= 0);
+            verify(keys.indexOf("value") >= 0);
+            verify(keys.indexOf("index") >= 0);
+            verify(keys.indexOf("objectName") < 0);
+        }
+
+        function test_rebinding() {
+            listModel.setProperty(1, "value", 5);
+            compare(testModel.count, 4);
+            compare(testModel.get(0, "name"), "b");
+            compare(testModel.get(0, "label"), "b:10:1");
+            root.minimum = 4;
+            compare(testModel.count, 2);
+            compare(testModel.get(1, "label"), "c:8:2");
+            root.minimum = 2;
+            listModel.setProperty(1, "value", 1);
+        }
+    }
+}
@@ -0,0 +1,109 @@
+import QtQuick 2.0
+import QtQml 2.2
+import QtTest 1.1
+import SortFilterProxyModel 0.2
+
+Item {
+    ListModel {
+        id: listModel
+        ListElement { value: 1; group: 1 }
+        ListElement { value: 2; group: 2 }
+        ListElement { value: 3; group: 1 }
+        ListElement { value: 4; group: 2 }
+        ListElement { value: 5; group: 1 }
+        ListElement { value: 6; group: 2 }
+    }
+
+    SortFilterProxyModel {
+        id: impureModel
+        sourceModel: listModel
+        filters: [
+            ExpressionFilter {
+                id: impureFilter
+                property var w: ({count : 0}) // wrap count in a js object so modifying it doesn't bind it in the expression
+                expression: {
+                    ++w.count;
+                    return model.value > 2;
+                }
+            },
+            ValueFilter {
+                roleName: "group"
+                value: 1
+            }
+        ]
+    }
+
+    SortFilterProxyModel {
+        id: pureModel
+        sourceModel: listModel
+        filters: [
+            ExpressionFilter {
+                id: pureFilter
+                pure: true
+                property var w: ({count : 0})
+                expression: {
+                    ++w.count;
+                    return model.value > 2;
+                }
+            },
+            ValueFilter {
+                roleName: "group"
+                value: 1
+            }
+        ]
+    }
+
+    SortFilterProxyModel {
+        id: nestedModel
+        sourceModel: listModel
+        filters: AnyOf {
+            ExpressionFilter {
+                id: nestedFilter
+                pure: true
+                property var w: ({count : 0})
+                expression: {
+                    ++w.count;
+                    return model.value > 4;
+                }
+            }
+            ValueFilter {
+                roleName: "group"
+                value: 1
+            }
+        }
+    }
+
+    TestCase {
+        name: "FilterOrder"
+
+        function test_sameRows() {
+            compare(impureModel.count, 2);
+            compare(pureModel.count, 2);
+            for (var i = 0; i < 2; ++i)
+                compare(pureModel.get(i, "value"), impureModel.get(i, "value"));
+            compare(nestedModel.count, 4);
+        }
+
+        function test_cheapFilterFirst() {
+            // the pure expression isn't evaluated for the 3 rows rejected by the ValueFilter declared after it
+            compare(impureFilter.w.count - pureFilter.w.count, 3);
+            // nor for the 3 rows accepted by the ValueFilter in an AnyOf
+            compare(impureFilter.w.count - nestedFilter.w.count, 3);
+        }
+
+        function test_explainOrder() {
+            var impureFilters = impureModel.explain().filters;
+            compare(impureFilters[0].order, 0);
+            compare(impureFilters[1].order, 1);
+
+            var pureFilters = pureModel.explain().filters;
+            compare(pureFilters[0].type, "ExpressionFilter");
+            compare(pureFilters[0].order, 1);
+            compare(pureFilters[1].order, 0);
+
+            var anyOf = nestedModel.explain().filters[0];
+            compare(anyOf.filters[0].order, 1);
+            compare(anyOf.filters[1].order, 0);
+        }
+    }
+}
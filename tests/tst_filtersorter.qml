@@ -25,9 +25,36 @@ Item {
             }
         }
     }
+
+    SortFilterProxyModel {
+        id: countingModel
+        sourceModel: listModel
+
+        sorters: [
+            FilterSorter {
+                ExpressionFilter {
+                    id: countingFilter
+                    property var w: ({count : 0}) // wrap count in a js object so modifying it doesn't bind it in the expression
+                    property bool favoriteValue: true
+                    expression: {
+                        ++w.count;
+                        return model.favorite === favoriteValue;
+                    }
+                }
+            },
+            RoleSorter { roleName: "name"; sortOrder: Qt.DescendingOrder }
+        ]
+    }
+
     TestCase {
         name: "FilterSorter"
 
+        function cleanup() {
+            listModel.setProperty(0, "favorite", true);
+            favoriteFilter.value = true;
+            countingFilter.favoriteValue = true;
+        }
+
         function test_filterSorter() {
             compare(testModel.get(0, "name"), "1");
             compare(testModel.get(1, "name"), "4");
@@ -41,5 +68,22 @@ Item {
             compare(testModel.get(2, "name"), "1");
             compare(testModel.get(3, "name"), "4");
         }
+
+        function test_filterEvaluatedOncePerRow() {
+            countingFilter.w.count = 0;
+            countingFilter.favoriteValue = false;
+
+            compare(countingModel.get(0, "name"), "3");
+            compare(countingModel.get(1, "name"), "2");
+            compare(countingModel.get(2, "name"), "4");
+            compare(countingModel.get(3, "name"), "1");
+            compare(countingFilter.w.count, listModel.count);
+
+            countingFilter.w.count = 0;
+            listModel.setProperty(0, "favorite", false);
+            compare(countingModel.get(0, "name"), "3");
+            compare(countingModel.get(2, "name"), "1");
+            compare(countingFilter.w.count, 1);
+        }
     }
 }
@@ -0,0 +1,68 @@
+import QtQuick 2.0
+import QtQml 2.2
+import QtTest 1.1
+import SortFilterProxyModel 0.2
+
+Item {
+    ListModel {
+        id: listModel
+        ListElement { name: "QSortFilterProxyModel" }
+        ListElement { name: "unrelated" }
+        ListElement { name: "SortFilterProxyModel" }
+        ListElement { name: "ProxyModel" }
+        ListElement { name: "sfpm.cpp" }
+    }
+
+    SortFilterProxyModel {
+        id: testModel
+        sourceModel: listModel
+        filters: FuzzyFilter {
+            id: fuzzyFilter
+            roleName: "name"
+            pattern: "sfpm"
+        }
+        sorters: FuzzySorter { filter: fuzzyFilter }
+        proxyRoles: FuzzyScoreRole {
+            name: "score"
+            filter: fuzzyFilter
+        }
+    }
+
+    TestCase {
+        name: "FuzzyFilter"
+
+        function cleanup() {
+            fuzzyFilter.pattern = "sfpm";
+            fuzzyFilter.caseSensitivity = Qt.CaseInsensitive;
+        }
+
+        function test_fuzzyFilter() {
+            compare(testModel.count, 3);
+            compare(testModel.get(0, "name"), "sfpm.cpp");
+            compare(testModel.get(1, "name"), "SortFilterProxyModel");
+            compare(testModel.get(2, "name"), "QSortFilterProxyModel");
+        }
+
+        function test_score() {
+            verify(testModel.get(0, "score") > testModel.get(1, "score"));
+            verify(testModel.get(1, "score") > testModel.get(2, "score"));
+            verify(testModel.get(2, "score") >= 0);
+        }
+
+        function test_patternChange() {
+            fuzzyFilter.pattern = "prox";
+            compare(testModel.count, 3);
+            compare(testModel.get(0, "name"), "ProxyModel");
+
+            fuzzyFilter.pattern = "";
+            compare(testModel.count, listModel.count);
+            compare(testModel.get(0, "score"), 0);
+        }
+
+        function test_caseSensitivity() {
+            fuzzyFilter.caseSensitivity = Qt.CaseSensitive;
+            compare(testModel.count, 1);
+            compare(testModel.get(0, "name"), "sfpm.cpp");
+        }
+    }
+}
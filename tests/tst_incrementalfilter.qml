@@ -0,0 +1,101 @@
+import QtQuick 2.0
+import QtQml 2.2
+import QtTest 1.1
+import SortFilterProxyModel 0.2
+
+Item {
+    ListModel {
+        id: listModel
+        ListElement { name: "apple" }
+        ListElement { name: "apricot" }
+        ListElement { name: "banana" }
+        ListElement { name: "cherry" }
+        ListElement { name: "grape" }
+        ListElement { name: "pineapple" }
+    }
+
+    SortFilterProxyModel {
+        id: testModel
+        sourceModel: listModel
+        proxyRoles: ExpressionRole {
+            id: countingRole
+            name: "countedName"
+            property var w: ({count : 0}) // wrap count in a js object so modifying it doesn't bind it in the expression
+            expression: {
+                ++w.count;
+                return model.name;
+            }
+        }
+        filters: RegExpFilter {
+            id: regExpFilter
+            roleName: "countedName"
+            syntax: RegExpFilter.FixedString
+        }
+    }
+
+    TestCase {
+        name: "IncrementalFilter"
+
+        function init() {
+            testModel.delayed = false;
+            regExpFilter.pattern = "";
+            countingRole.w.count = 0;
+        }
+
+        function cleanup() {
+            listModel.setProperty(2, "name", "banana");
+        }
+
+        function test_narrowing() {
+            regExpFilter.pattern = "ap";
+            compare(testModel.count, 4);
+            countingRole.w.count = 0;
+
+            regExpFilter.pattern = "app";
+            compare(testModel.count, 2);
+            compare(testModel.get(0, "name"), "apple");
+            compare(testModel.get(1, "name"), "pineapple");
+            compare(countingRole.w.count, 4); // only the rows accepted by "ap" are tested again
+        }
+
+        function test_previousResults() {
+            regExpFilter.pattern = "ap";
+            regExpFilter.pattern = "app";
+            countingRole.w.count = 0;
+
+            regExpFilter.pattern = "ap";
+            compare(testModel.count, 4);
+            compare(countingRole.w.count, 0);
+
+            regExpFilter.pattern = "an";
+            compare(testModel.count, 1);
+            compare(testModel.get(0, "name"), "banana");
+            compare(countingRole.w.count, listModel.count);
+        }
+
+        function test_sourceChange() {
+            regExpFilter.pattern = "ap";
+            regExpFilter.pattern = "app";
+            listModel.setProperty(2, "name", "apbanana");
+            compare(testModel.count, 2);
+
+            regExpFilter.pattern = "ap";
+            compare(testModel.count, 5);
+        }
+
+        function test_delayedNarrowing() {
+            testModel.delayed = true;
+            regExpFilter.pattern = "a";
+            regExpFilter.pattern = "ap";
+            regExpFilter.pattern = "apr";
+            wait(0);
+            compare(testModel.count, 1);
+            compare(testModel.get(0, "name"), "apricot");
+
+            regExpFilter.pattern = "ap";
+            regExpFilter.pattern = "a";
+            wait(0);
+            compare(testModel.count, 5);
+        }
+    }
+}
@@ -84,9 +84,62 @@ Item {
         sourceModel: dataModel
     }
 
+    ListModel {
+        id: pageModel
+        ListElement { value: 1 }
+        ListElement { value: 2 }
+        ListElement { value: 3 }
+        ListElement { value: 4 }
+    }
+
+    SortFilterProxyModel {
+        id: pagedModel
+        sourceModel: pageModel
+        filters: IndexFilter {
+            id: pageFilter
+            minimumIndex: 1
+            maximumIndex: 2
+        }
+    }
+
     TestCase {
         name: "IndexFilterTests"
 
+        function cleanup() {
+            pageModel.clear();
+            for (var i = 1; i <= 4; ++i)
+                pageModel.append({ value: i });
+            pageFilter.minimumIndex = 1;
+            pageFilter.maximumIndex = 2;
+        }
+
+        function pageValues() {
+            var values = [];
+            for (var i = 0; i < pagedModel.count; i++)
+                values.push(pagedModel.get(i, "value"));
+            return values;
+        }
+
+        function test_rowsShiftedIntoSlice() {
+            compare(pageValues(), [2, 3]);
+            pageModel.insert(0, { value: 0 });
+            compare(pageValues(), [1, 2]);
+            pageModel.remove(0, 2);
+            compare(pageValues(), [3, 4]);
+            pageModel.append({ value: 5 });
+            compare(pageValues(), [3, 4]);
+        }
+
+        function test_rowsShiftedFromEnd() {
+            pageFilter.minimumIndex = -2;
+            pageFilter.maximumIndex = undefined;
+            compare(pageValues(), [3, 4]);
+            pageModel.append({ value: 5 });
+            compare(pageValues(), [4, 5]);
+            pageModel.remove(4);
+            compare(pageValues(), [3, 4]);
+        }
+
         function test_minMax_data() {
             return filters;
         }
@@ -0,0 +1,180 @@
+import QtQuick 2.0
+import QtQml 2.2
+import QtTest 1.1
+import SortFilterProxyModel 0.2
+
+Item {
+    id: root
+    property int minimumAge: 18
+    property int offset: 0
+
+    ListModel {
+        id: listModel
+        ListElement { name: "Alice"; age: 34; country: "FR" }
+        ListElement { name: "bob"; age: 17; country: "FR" }
+        ListElement { name: "Carol"; age: 52; country: "BE" }
+        ListElement { name: "dave"; age: 25; country: "US" }
+    }
+
+    SortFilterProxyModel {
+        id: testModel
+        sourceModel: listModel
+        filters: [
+            ExpressionFilter {
+                objectName: "nativeFilter"
+                expression: model.age >= root.minimumAge && country !== "US"
+            },
+            ExpressionFilter {
+                objectName: "scriptFilter"
+                expression: model.name.length > 2
+            }
+        ]
+        proxyRoles: [
+            ExpressionRole {
+                name: "nextAge"
+                expression: age + 1 + root.offset
+            },
+            ExpressionRole {
+                name: "category"
+                expression: model.age > 40 && "senior" || "adult"
+            },
+            ExpressionRole {
+                name: "label"
+                expression: name + " (" + age + ")"
+            }
+        ]
+    }
+
+    ListModel {
+        id: codeListModel
+        ListElement { code: "9"; day: 1 }
+        ListElement { code: "10"; day: 2 }
+        ListElement { code: "x"; day: 3 }
+        ListElement { code: ""; day: 4 }
+    }
+
+    SortFilterProxyModel {
+        id: conversionModel
+        sourceModel: codeListModel
+        proxyRoles: [
+            ExpressionRole {
+                name: "lessThanTen"
+                expression: code < 10
+            },
+            ExpressionRole {
+                name: "isTen"
+                expression: code == 10
+            },
+            ExpressionRole {
+                name: "nullBelowDay"
+                expression: null < day
+            },
+            ExpressionRole {
+                name: "quarter"
+                expression: "" + day / 4
+            },
+            ExpressionRole {
+                name: "date"
+                expression: new Date(2020, 0, day)
+            },
+            ExpressionRole {
+                name: "afterEpoch"
+                expression: date > 0
+            }
+        ]
+    }
+
+    ListModel {
+        id: emptyListModel
+    }
+
+    SortFilterProxyModel {
+        id: emptyModel
+        sourceModel: emptyListModel
+        filters: ExpressionFilter {
+            expression: value > 1
+        }
+        proxyRoles: ExpressionRole {
+            name: "greeting"
+            expression: name + "!"
+        }
+    }
+
+    TestCase {
+        name: "NativeExpression"
+
+        function cleanup() {
+            root.minimumAge = 18;
+            root.offset = 0;
+        }
+
+        function test_lowering() {
+            var plan = testModel.explain();
+            compare(plan.filters[0].cost, "role");
+            compare(plan.filters[1].cost, "script");
+            compare(plan.proxyRoles[0].cost, "role");
+            compare(plan.proxyRoles[1].cost, "role");
+            compare(plan.proxyRoles[2].cost, "role");
+        }
+
+        function test_filter() {
+            compare(testModel.count, 2);
+            compare(testModel.get(0, "name"), "Alice");
+            compare(testModel.get(1, "name"), "Carol");
+            root.minimumAge = 40;
+            compare(testModel.count, 1);
+            compare(testModel.get(0, "name"), "Carol");
+            root.minimumAge = 0;
+            compare(testModel.count, 3);
+        }
+
+        function test_roles() {
+            compare(testModel.get(0, "nextAge"), 35);
+            compare(testModel.get(0, "category"), "adult");
+            compare(testModel.get(1, "category"), "senior");
+            compare(testModel.get(1, "label"), "Carol (52)");
+            root.offset = 10;
+            compare(testModel.get(0, "nextAge"), 45);
+        }
+
+        function test_javaScriptConversions() {
+            compare(conversionModel.explain().proxyRoles[0].cost, "role");
+            compare(conversionModel.get(0, "lessThanTen"), true);
+            compare(conversionModel.get(1, "lessThanTen"), false);
+            compare(conversionModel.get(2, "lessThanTen"), false);
+            compare(conversionModel.get(3, "lessThanTen"), true);
+            compare(conversionModel.get(0, "isTen"), false);
+            compare(conversionModel.get(1, "isTen"), true);
+            compare(conversionModel.get(0, "nullBelowDay"), true);
+            compare(conversionModel.get(0, "quarter"), "0.25");
+            compare(conversionModel.get(3, "quarter"), "1");
+        }
+
+        function test_objectValues() {
+            // a date is converted by JavaScript, the row is evaluated with it
+            compare(conversionModel.explain().proxyRoles[5].cost, "role");
+            compare(conversionModel.get(0, "afterEpoch"), true);
+        }
+
+        function test_rolesAdded() {
+            // the names aren't roles yet, name is the name of the ExpressionRole
+            compare(emptyModel.explain().filters[0].cost, "script");
+            compare(emptyModel.explain().proxyRoles[0].cost, "script");
+            emptyListModel.append({ name: "a", value: 2 });
+            emptyListModel.append({ name: "b", value: 1 });
+            compare(emptyModel.explain().filters[0].cost, "role");
+            compare(emptyModel.explain().proxyRoles[0].cost, "role");
+            compare(emptyModel.count, 1);
+            compare(emptyModel.get(0, "greeting"), "a!");
+            emptyListModel.clear();
+        }
+
+        function test_dataChanged() {
+            listModel.setProperty(1, "age", 20);
+            compare(testModel.count, 3);
+            compare(testModel.get(1, "nextAge"), 21);
+            listModel.setProperty(1, "age", 17);
+            compare(testModel.count, 2);
+        }
+    }
+}
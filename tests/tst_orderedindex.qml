@@ -0,0 +1,105 @@
+import QtQuick 2.0
+import QtQml 2.2
+import QtTest 1.1
+import SortFilterProxyModel 0.2
+
+Item {
+    ListModel {
+        id: listModel
+    }
+
+    SortFilterProxyModel {
+        id: rangeModel
+        sourceModel: listModel
+        orderedIndexedRoleNames: ["price"]
+        filters: RangeFilter {
+            id: rangeFilter
+            roleName: "price"
+        }
+    }
+
+    SortFilterProxyModel {
+        id: prefixModel
+        sourceModel: listModel
+        orderedIndexedRoleNames: ["name"]
+        filters: RegExpFilter {
+            id: prefixFilter
+            roleName: "name"
+        }
+    }
+
+    TestCase {
+        name: "OrderedIndex"
+
+        function init() {
+            listModel.clear();
+            var names = ["apple", "apricot", "banana", "cherry", "grape", "pineapple", "apple pie"];
+            for (var i = 0; i < names.length; ++i)
+                listModel.append({ name: names[i], price: (i * 3) % 7 });
+            rangeFilter.minimumValue = undefined;
+            rangeFilter.maximumValue = undefined;
+            rangeFilter.minimumInclusive = true;
+            rangeFilter.maximumInclusive = true;
+            prefixFilter.pattern = "";
+        }
+
+        function test_range() {
+            // prices are 0, 3, 6, 2, 5, 1, 4
+            compare(rangeModel.count, 7);
+            rangeFilter.minimumValue = 2;
+            compare(rangeModel.count, 5);
+            rangeFilter.maximumValue = 4;
+            compare(rangeModel.count, 3);
+            rangeFilter.minimumInclusive = false;
+            compare(rangeModel.count, 2);
+            rangeFilter.maximumInclusive = false;
+            compare(rangeModel.count, 1);
+            compare(rangeModel.get(0, "price"), 3);
+            rangeFilter.minimumValue = 0;
+            compare(rangeModel.count, 3);
+        }
+
+        function test_fuzzyBounds() {
+            // prices are 0, 0.1 + 0.2, 6, 2, 5, 1, 4, the second one is fuzzily equal to 0.3
+            listModel.setProperty(1, "price", 0.1 + 0.2);
+            rangeFilter.maximumValue = 0.3;
+            compare(rangeModel.count, 2);
+            rangeFilter.maximumInclusive = false;
+            compare(rangeModel.count, 1);
+            rangeFilter.maximumValue = undefined;
+            rangeFilter.minimumValue = 0.3;
+            compare(rangeModel.count, 6);
+            rangeFilter.minimumInclusive = false;
+            compare(rangeModel.count, 5);
+        }
+
+        function test_rangeSourceChanges() {
+            rangeFilter.minimumValue = 2;
+            rangeFilter.maximumValue = 4;
+            compare(rangeModel.count, 3);
+            listModel.setProperty(0, "price", 3);
+            compare(rangeModel.count, 4);
+            listModel.append({ name: "kiwi", price: 2 });
+            compare(rangeModel.count, 5);
+            listModel.remove(1);
+            compare(rangeModel.count, 4);
+            rangeFilter.maximumValue = 3;
+            compare(rangeModel.count, 3);
+        }
+
+        function test_prefix() {
+            prefixFilter.pattern = "^ap";
+            compare(prefixModel.count, 3);
+            prefixFilter.pattern = "^apple";
+            compare(prefixModel.count, 2);
+            compare(prefixModel.get(0, "name"), "apple");
+            compare(prefixModel.get(1, "name"), "apple pie");
+            prefixFilter.pattern = "^b";
+            compare(prefixModel.count, 1);
+            prefixFilter.pattern = "^z";
+            compare(prefixModel.count, 0);
+            prefixFilter.pattern = "apple";
+            compare(prefixModel.count, 3);
+        }
+    }
+}
@@ -0,0 +1,97 @@
+import QtQuick 2.0
+import QtQml 2.2
+import QtTest 1.1
+import SortFilterProxyModel 0.2
+
+Item {
+    id: root
+    property string search: "an"
+    property string order: "FR,BE,US"
+    property var countryNames: ({ "FR": "France", "BE": "Belgium", "US": "United States" })
+    property bool longNames: false
+
+    QtObject { id: shortBound; property int minimum: 4 }
+    QtObject { id: longBound; property int minimum: 5 }
+
+    ListModel {
+        id: listModel
+        ListElement { name: "Anna"; country: "US" }
+        ListElement { name: "Jean"; country: "FR" }
+        ListElement { name: "Marc"; country: "BE" }
+        ListElement { name: "Ana Luisa"; country: "BE" }
+    }
+
+    SortFilterProxyModel {
+        id: testModel
+        sourceModel: listModel
+        filters: ExpressionFilter {
+            prepare: root.search.toLowerCase().split(" ")
+            expression: prepared.every(function(word) { return model.name.toLowerCase().indexOf(word) !== -1; })
+        }
+        sorters: ExpressionSorter {
+            prepare: root.order.split(",")
+            expression: prepared.indexOf(modelLeft.country) < prepared.indexOf(modelRight.country)
+        }
+        proxyRoles: [
+            ExpressionRole {
+                name: "countryName"
+                prepare: root.countryNames
+                expression: prepared[model.country]
+            },
+            ExpressionRole {
+                name: "unprepared"
+                expression: typeof prepared
+            }
+        ]
+    }
+
+    SortFilterProxyModel {
+        id: boundModel
+        sourceModel: listModel
+        filters: ExpressionFilter {
+            prepare: root.longNames ? longBound : shortBound
+            expression: model.name.length >= prepared.minimum
+        }
+    }
+
+    TestCase {
+        name: "Prepare"
+
+        function test_prepared() {
+            compare(testModel.count, 3);
+            compare(testModel.get(0, "name"), "Jean");
+            compare(testModel.get(1, "name"), "Ana Luisa");
+            compare(testModel.get(2, "name"), "Anna");
+            compare(testModel.get(0, "countryName"), "France");
+            compare(testModel.get(2, "countryName"), "United States");
+            compare(testModel.get(0, "unprepared"), "undefined");
+        }
+
+        function test_prepareChanged() {
+            root.search = "AN LU";
+            compare(testModel.count, 1);
+            compare(testModel.get(0, "name"), "Ana Luisa");
+            root.search = "a";
+            compare(testModel.count, 4);
+            root.order = "US,BE,FR";
+            compare(testModel.get(0, "name"), "Anna");
+            compare(testModel.get(3, "name"), "Jean");
+            root.countryNames = { "FR": "République française", "BE": "Belgique", "US": "États-Unis" };
+            compare(testModel.get(0, "countryName"), "États-Unis");
+            root.search = "an";
+            root.order = "FR,BE,US";
+            root.countryNames = { "FR": "France", "BE": "Belgium", "US": "United States" };
+        }
+
+        function test_preparedDependencies() {
+            compare(boundModel.count, 4);
+            root.longNames = true;
+            compare(boundModel.count, 1);
+            // the properties of the new prepared value are tracked
+            longBound.minimum = 4;
+            compare(boundModel.count, 4);
+            longBound.minimum = 5;
+            root.longNames = false;
+        }
+    }
+}
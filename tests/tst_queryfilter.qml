@@ -0,0 +1,147 @@
+import QtQuick 2.0
+import QtQml 2.2
+import QtTest 1.1
+import SortFilterProxyModel 0.2
+
+Item {
+    ListModel {
+        id: listModel
+        ListElement { name: "Alice"; age: 34; country: "FR" }
+        ListElement { name: "bob"; age: 17; country: "FR" }
+        ListElement { name: "Carol"; age: 52; country: "BE" }
+        ListElement { name: "dave"; age: 25; country: "US" }
+        ListElement { name: "Eve"; age: 19; country: "FR" }
+    }
+
+    SortFilterProxyModel {
+        id: testModel
+        sourceModel: listModel
+        filters: QueryFilter {
+            id: queryFilter
+            property int minimumAge: 18
+            property string search: ""
+            query: "age >= $minimumAge && country in ['FR', 'BE'] && name contains $search"
+        }
+    }
+
+    SortFilterProxyModel {
+        id: indexedModel
+        sourceModel: listModel
+        indexedRoleNames: ["country"]
+        orderedIndexedRoleNames: ["age", "name"]
+        filters: QueryFilter {
+            id: indexedFilter
+            query: "country == 'FR' && age > 18"
+        }
+    }
+
+    SortFilterProxyModel {
+        id: errorModel
+        sourceModel: listModel
+        filters: QueryFilter {
+            id: errorFilter
+        }
+    }
+
+    ListModel {
+        id: mixedListModel
+        ListElement { kind: 0 }
+        ListElement { kind: 1 }
+        ListElement { kind: 2 }
+        ListElement { kind: 3 }
+    }
+
+    SortFilterProxyModel {
+        id: mixedModel
+        sourceModel: mixedListModel
+        proxyRoles: ExpressionRole {
+            name: "size"
+            expression: model.kind === 0 ? "unknown" : model.kind * 10
+        }
+        filters: QueryFilter {
+            id: mixedFilter
+        }
+    }
+
+    TestCase {
+        name: "QueryFilter"
+
+        function cleanup() {
+            queryFilter.minimumAge = 18;
+            queryFilter.search = "";
+            queryFilter.caseSensitivity = Qt.CaseSensitive;
+            indexedFilter.query = "country == 'FR' && age > 18";
+        }
+
+        function test_query() {
+            compare(testModel.count, 3);
+            compare(testModel.get(0, "name"), "Alice");
+            compare(testModel.get(1, "name"), "Carol");
+            compare(testModel.get(2, "name"), "Eve");
+        }
+
+        function test_parameters() {
+            queryFilter.minimumAge = 40;
+            compare(testModel.count, 1);
+            compare(testModel.get(0, "name"), "Carol");
+            queryFilter.minimumAge = 0;
+            compare(testModel.count, 4);
+        }
+
+        function test_caseSensitivity() {
+            queryFilter.search = "a";
+            compare(testModel.count, 1);
+            compare(testModel.get(0, "name"), "Carol");
+            queryFilter.caseSensitivity = Qt.CaseInsensitive;
+            compare(testModel.count, 2);
+            compare(testModel.get(0, "name"), "Alice");
+        }
+
+        function test_indexed() {
+            compare(indexedModel.count, 2);
+            compare(indexedModel.get(0, "name"), "Alice");
+            compare(indexedModel.get(1, "name"), "Eve");
+            compare(indexedModel.explain().filters[0].access, "rowList");
+
+            indexedFilter.query = "name startsWith 'C' || age < 18";
+            compare(indexedModel.count, 2);
+            compare(indexedModel.get(0, "name"), "bob");
+            compare(indexedModel.get(1, "name"), "Carol");
+            compare(indexedModel.explain().filters[0].access, "rowList");
+
+            indexedFilter.query = "age * 2 > 60";
+            compare(indexedModel.count, 2);
+            compare(indexedModel.explain().filters[0].access, "rowScan");
+        }
+
+        function test_errors() {
+            ignoreWarning("QueryFilter: unexpected end of query at position 7");
+            errorFilter.query = "age >= ";
+            compare(errorModel.count, 5);
+
+            ignoreWarning("QueryFilter: '==' can't compare a number with a string at position 2");
+            errorFilter.query = "1 == 'x'";
+            compare(errorModel.count, 5);
+
+            ignoreWarning("QueryFilter: unknown role 'size' at position 0");
+            errorFilter.query = "size > 3";
+            compare(errorModel.count, 5);
+
+            errorFilter.query = "age < 20";
+            compare(errorModel.count, 2);
+        }
+
+        function test_rowTypeMismatch() {
+            // the first row tested has a string where the query expects a number, only that row isn't accepted
+            ignoreWarning("QueryFilter: the data of row 0 doesn't have the types expected by the query \"size <= 15\", the row isn't accepted");
+            mixedFilter.query = "size <= 15";
+            compare(mixedModel.count, 1);
+            compare(mixedModel.get(0, "kind"), 1);
+
+            ignoreWarning("QueryFilter: the data of row 0 doesn't have the types expected by the query \"!(size > 15)\", the row isn't accepted");
+            mixedFilter.query = "!(size > 15)";
+            compare(mixedModel.count, 1);
+            compare(mixedModel.get(0, "kind"), 1);
+        }
+    }
+}
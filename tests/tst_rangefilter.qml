@@ -75,6 +75,23 @@ Item {
 
     SortFilterProxyModel { id: testModel }
 
+    ListModel {
+        id: nameModel
+        ListElement { name: "b" }
+        ListElement { name: "10" }
+        ListElement { name: "d" }
+        ListElement { name: "9" }
+    }
+
+    SortFilterProxyModel {
+        id: boundsModel
+        sourceModel: nameModel
+        filters: RangeFilter {
+            id: boundsFilter
+            roleName: "name"
+        }
+    }
+
     TestCase {
         name:"RangeFilterTests"
 
@@ -95,5 +112,27 @@ Item {
                        "Expected testModel value " + filter.expectedValues[i] + ", actual: " + modelValue);
             }
         }
+
+        function test_boundTypes() {
+            // the names are compared as strings to the bounds converted to strings
+            boundsFilter.minimumValue = "a";
+            compare(boundsModel.count, 2);
+            boundsFilter.minimumValue = 9;
+            compare(typeof boundsFilter.minimumValue, "number");
+            compare(boundsModel.count, 3);
+            boundsFilter.minimumValue = "9";
+            compare(typeof boundsFilter.minimumValue, "string");
+            compare(boundsModel.count, 3);
+            boundsFilter.maximumValue = "c";
+            compare(boundsModel.count, 2);
+            boundsFilter.maximumValue = 10;
+            compare(boundsModel.count, 0);
+            boundsFilter.minimumValue = "1";
+            compare(boundsModel.count, 1);
+            compare(boundsModel.get(0, "name"), "10");
+            boundsFilter.minimumValue = undefined;
+            boundsFilter.maximumValue = undefined;
+            compare(boundsModel.count, 4);
+        }
     }
 }
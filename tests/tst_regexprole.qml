@@ -39,6 +39,19 @@ Item {
         ]
     }
 
+    ListModel {
+        id: bigListModel
+    }
+
+    SortFilterProxyModel {
+        id: bigModel
+        sourceModel: bigListModel
+        proxyRoles: RegExpRole {
+            roleName: "compoundRole"
+            pattern: "(?<id>\\d+) - (?<name>.+)"
+        }
+    }
+
             TestCase {
                 name: "RegExpRole"
 
@@ -50,5 +63,34 @@ Item {
                     compare(testModel.get(0, "nameCS"), undefined);
                     compare(testModel.get(0, "nameCIS"), "zero");
                 }
+
+                function test_sourceDataChanged() {
+                    compare(testModel.get(2, "name"), "two");
+                    listModel.setProperty(2, "compoundRole", "22 - twenty-two");
+                    compare(testModel.get(2, "id"), "22");
+                    compare(testModel.get(2, "name"), "twenty-two");
+                    listModel.setProperty(2, "compoundRole", "2 - two");
+                    compare(testModel.get(2, "name"), "two");
+                }
+
+                function test_caseSensitivityChanged() {
+                    compare(testModel.get(1, "nameCS"), undefined);
+                    caseSensitiveRole.caseSensitivity = Qt.CaseInsensitive;
+                    compare(testModel.get(1, "nameCS"), "one");
+                    caseSensitiveRole.caseSensitivity = Qt.CaseSensitive;
+                    compare(testModel.get(1, "nameCS"), undefined);
+                }
+
+                function test_moreRowsThanCachedMatches() {
+                    for (var i = 0; i < 3000; ++i)
+                        bigListModel.append({ compoundRole: i + " - row" + i });
+                    for (var pass = 0; pass < 2; ++pass) {
+                        for (i = 0; i < bigModel.count; ++i) {
+                            compare(bigModel.get(i, "id"), String(i));
+                            compare(bigModel.get(i, "name"), "row" + i);
+                        }
+                    }
+                    bigListModel.clear();
+                }
             }
     }
@@ -0,0 +1,118 @@
+import QtQuick 2.0
+import QtQml 2.2
+import QtTest 1.1
+import SortFilterProxyModel 0.2
+
+Item {
+    ListModel {
+        id: listModel
+        ListElement { identifier: 10; owner: "alice" }
+        ListElement { identifier: 11; owner: "bob" }
+        ListElement { identifier: 12; owner: "alice" }
+        ListElement { identifier: 13; owner: "carol" }
+        ListElement { identifier: 14; owner: "bob" }
+    }
+
+    SortFilterProxyModel {
+        id: testModel
+        sourceModel: listModel
+        indexedRoleNames: ["identifier", "owner"]
+        filters: ValueFilter {
+            id: ownerFilter
+            roleName: "owner"
+        }
+        sorters: RoleSorter { roleName: "identifier"; sortOrder: Qt.DescendingOrder }
+    }
+
+    ListModel {
+        id: mixedModel
+        dynamicRoles: true
+    }
+
+    SortFilterProxyModel {
+        id: mixedTestModel
+        sourceModel: mixedModel
+        indexedRoleNames: ["amount"]
+        filters: ValueFilter {
+            id: amountFilter
+            roleName: "amount"
+        }
+    }
+
+    TestCase {
+        name: "RoleIndex"
+
+        function init() {
+            listModel.clear();
+            var owners = ["alice", "bob", "alice", "carol", "bob"];
+            for (var i = 0; i < owners.length; ++i)
+                listModel.append({ identifier: 10 + i, owner: owners[i] });
+            ownerFilter.value = undefined;
+            ownerFilter.inverted = false;
+        }
+
+        function test_valueFilter() {
+            ownerFilter.value = "alice";
+            compare(testModel.count, 2);
+            compare(testModel.get(0, "identifier"), 12);
+            compare(testModel.get(1, "identifier"), 10);
+
+            ownerFilter.inverted = true;
+            compare(testModel.count, 3);
+
+            ownerFilter.inverted = false;
+            ownerFilter.value = "dave";
+            compare(testModel.count, 0);
+        }
+
+        function test_findRow() {
+            compare(testModel.findRow("identifier", 14), 0);
+            compare(testModel.findRow("identifier", 10), 4);
+            compare(testModel.findRow("identifier", 42), -1);
+            compare(testModel.findRow("owner", "bob"), 0);
+            compare(testModel.findRow("unknownRole", "bob"), -1);
+
+            ownerFilter.value = "alice";
+            compare(testModel.findRow("identifier", 14), -1);
+            compare(testModel.findRow("identifier", 10), 1);
+        }
+
+        function test_sourceChanges() {
+            ownerFilter.value = "alice";
+            compare(testModel.count, 2);
+
+            listModel.setProperty(1, "owner", "alice");
+            compare(testModel.count, 3);
+            listModel.append({ identifier: 15, owner: "alice" });
+            compare(testModel.count, 4);
+            compare(testModel.findRow("identifier", 15), 0);
+
+            listModel.remove(0);
+            compare(testModel.count, 3);
+            compare(testModel.findRow("identifier", 10), -1);
+
+            ownerFilter.value = "bob";
+            compare(testModel.count, 1);
+            ownerFilter.value = "alice";
+            compare(testModel.count, 3);
+            compare(testModel.findRow("identifier", 11), 2);
+        }
+
+        function test_equalValuesOfOtherTypes() {
+            mixedModel.clear();
+            mixedModel.append({ amount: 1 });
+            mixedModel.append({ amount: 0 });
+            mixedModel.append({ amount: 1.5 });
+            amountFilter.value = true;
+            compare(mixedTestModel.count, 1);
+            compare(mixedTestModel.get(0, "amount"), 1);
+            amountFilter.value = 1.5;
+            compare(mixedTestModel.count, 1);
+
+            // the index holds numbers and strings, the rows are compared instead
+            mixedModel.append({ amount: "1.50" });
+            compare(mixedTestModel.count, 2);
+            amountFilter.value = undefined;
+        }
+    }
+}
@@ -0,0 +1,116 @@
+import QtQuick 2.0
+import QtQml 2.2
+import QtTest 1.1
+import SortFilterProxyModel 0.2
+
+Item {
+    ListModel {
+        id: listModel
+        ListElement { name: "a"; group: 1 }
+        ListElement { name: "b"; group: 2 }
+        ListElement { name: "c"; group: 1 }
+        ListElement { name: "d"; group: 3 }
+        ListElement { name: "e"; group: 1 }
+    }
+
+    SortFilterProxyModel {
+        id: testModel
+        sourceModel: listModel
+        statistics.enabled: true
+        filters: [
+            RangeFilter {
+                id: rangeFilter
+                roleName: "group"
+                minimumValue: 0
+                maximumValue: 10
+            },
+            RangeFilter {
+                roleName: "group"
+                minimumValue: 0
+                maximumValue: 20
+            },
+            ExpressionFilter {
+                expression: model.group > 0 && model.name !== ""
+            }
+        ]
+        proxyRoles: SwitchRole {
+            name: "groupName"
+            ValueFilter { roleName: "group"; value: 1; SwitchRole.value: "first" }
+            RangeFilter { roleName: "group"; minimumValue: 2; SwitchRole.value: "other" }
+            defaultValue: "none"
+        }
+    }
+
+    ListModel {
+        id: chainedListModel
+        ListElement { value: 1 }
+        ListElement { value: 2 }
+        ListElement { value: 3 }
+    }
+
+    SortFilterProxyModel {
+        id: chainedModel
+        sourceModel: chainedListModel
+        filters: [
+            RangeFilter {
+                roleName: "b"
+                minimumValue: 0
+            },
+            ExpressionFilter {
+                expression: Math.floor(a) > 3
+            }
+        ]
+        sorters: RoleSorter { roleName: "a"; sortOrder: Qt.DescendingOrder }
+        proxyRoles: [
+            ExpressionRole {
+                name: "a"
+                expression: Math.floor(b) + 1
+            },
+            ExpressionRole {
+                name: "b"
+                expression: Math.floor(model.value) * 2
+            }
+        ]
+    }
+
+    TestCase {
+        name: "RowCache"
+
+        function test_rolesReadOncePerRow() {
+            testModel.statistics.reset();
+            rangeFilter.maximumValue = 9;
+            compare(testModel.count, listModel.count);
+            // the three filters read the group of each row, but it is fetched once per row
+            compare(testModel.statistics.sourceDataCalls().group, listModel.count);
+            compare(testModel.statistics.sourceDataCalls().name, listModel.count);
+            rangeFilter.maximumValue = 10;
+        }
+
+        function test_proxyRoleReadsShared() {
+            testModel.statistics.reset();
+            compare(testModel.get(1, "groupName"), "other");
+            compare(testModel.statistics.sourceDataCalls().group, 1);
+            compare(testModel.get(0, "groupName"), "first");
+            compare(testModel.get(3, "groupName"), "other");
+        }
+
+        function test_chainedProxyRoles() {
+            // the undefined values read while a role is computed aren't kept for the row
+            compare(chainedModel.count, 2);
+            compare(chainedModel.get(0, "a"), 7);
+            compare(chainedModel.get(0, "b"), 6);
+            compare(chainedModel.get(1, "a"), 5);
+            compare(chainedModel.get(1, "b"), 4);
+            chainedListModel.setProperty(0, "value", 4);
+            compare(chainedModel.count, 3);
+            compare(chainedModel.get(0, "a"), 9);
+        }
+
+        function test_changedData() {
+            listModel.setProperty(1, "group", 1);
+            compare(testModel.get(1, "groupName"), "first");
+            listModel.setProperty(1, "group", 2);
+            compare(testModel.get(1, "groupName"), "other");
+        }
+    }
+}
@@ -0,0 +1,139 @@
+import QtQuick 2.0
+import SortFilterProxyModel 0.2
+import QtQml.Models 2.2
+import QtTest 1.1
+
+Item {
+    ListModel {
+        id: dataModel
+        ListElement { name: "e"; group: "b"; value: 2 }
+        ListElement { name: "b"; group: "a"; value: -1.5 }
+        ListElement { name: "d"; group: "b"; value: 10 }
+        ListElement { name: "a"; group: "a"; value: 3 }
+        ListElement { name: "c"; group: "b"; value: 2 }
+        ListElement { name: "f"; group: "a"; value: -20 }
+    }
+
+    ListModel {
+        id: caseModel
+        ListElement { name: "B" }
+        ListElement { name: "a" }
+        ListElement { name: "C" }
+    }
+
+    SortFilterProxyModel {
+        id: chainModel
+        sourceModel: dataModel
+        sorters: [
+            RoleSorter { id: groupSorter; roleName: "group"; priority: 1 },
+            RoleSorter { id: valueSorter; roleName: "value"; sortOrder: Qt.DescendingOrder }
+        ]
+    }
+
+    SortFilterProxyModel {
+        id: sortRoleModel
+        sourceModel: dataModel
+        sortRoleName: "group"
+        ascendingSortOrder: false
+        sorters: RoleSorter { roleName: "value" }
+    }
+
+    SortFilterProxyModel {
+        id: filteredModel
+        sourceModel: dataModel
+        filters: ValueFilter { roleName: "group"; value: "a" }
+        sorters: RoleSorter { roleName: "value" }
+    }
+
+    SortFilterProxyModel {
+        id: collatedModel
+        sourceModel: dataModel
+        sorters: [
+            RoleSorter { roleName: "group"; priority: 1 },
+            StringSorter { roleName: "name"; sortOrder: Qt.DescendingOrder }
+        ]
+    }
+
+    SortFilterProxyModel {
+        id: caseInsensitiveModel
+        sourceModel: caseModel
+        sortRoleName: "name"
+        sortCaseSensitivity: Qt.CaseInsensitive
+    }
+
+    TestCase {
+        name: "SortKeys"
+
+        function cleanup() {
+            dataModel.clear();
+            dataModel.append([
+                { name: "e", group: "b", value: 2 },
+                { name: "b", group: "a", value: -1.5 },
+                { name: "d", group: "b", value: 10 },
+                { name: "a", group: "a", value: 3 },
+                { name: "c", group: "b", value: 2 },
+                { name: "f", group: "a", value: -20 }
+            ]);
+            groupSorter.enabled = true;
+            valueSorter.sortOrder = Qt.DescendingOrder;
+        }
+
+        function names(model) {
+            var result = "";
+            for (var i = 0; i < model.count; ++i)
+                result += model.get(i, "name");
+            return result;
+        }
+
+        function test_sorterChain() {
+            compare(names(chainModel), "abfdec");
+        }
+
+        function test_sorterChainChange() {
+            valueSorter.sortOrder = Qt.AscendingOrder;
+            compare(names(chainModel), "fbaecd");
+            groupSorter.enabled = false;
+            compare(names(chainModel), "fbecad");
+        }
+
+        function test_sortRoleName() {
+            compare(names(sortRoleModel), "ecdfba");
+        }
+
+        function test_partialKeys() {
+            compare(names(collatedModel), "fbaedc");
+        }
+
+        function test_unencodedSortRole() {
+            compare(names(caseInsensitiveModel), "aBC");
+        }
+
+        function test_dataChanged() {
+            dataModel.setProperty(5, "value", 100);
+            compare(names(chainModel), "fabdec");
+            dataModel.setProperty(0, "group", "a");
+            compare(names(chainModel), "faebdc");
+        }
+
+        function test_filteredRows() {
+            compare(names(filteredModel), "fba");
+            // the keys are released after sorting and encoded again for the rows compared
+            wait(0);
+            dataModel.setProperty(0, "group", "a");
+            compare(names(filteredModel), "fbea");
+            dataModel.setProperty(5, "value", 4);
+            compare(names(filteredModel), "beaf");
+        }
+
+        function test_rowsInsertedAndRemoved() {
+            dataModel.append({ name: "g", group: "a", value: 0 });
+            compare(names(chainModel), "agbfdec");
+            dataModel.remove(6);
+            compare(names(chainModel), "abfdec");
+            dataModel.insert(0, { name: "h", group: "b", value: 5 });
+            compare(names(chainModel), "abfdhec");
+            dataModel.remove(0);
+            compare(names(chainModel), "abfdec");
+        }
+    }
+}
@@ -0,0 +1,136 @@
+import QtQuick 2.0
+import QtQml 2.2
+import QtTest 1.1
+import SortFilterProxyModel 0.2
+
+Item {
+    ListModel {
+        id: listModel
+        ListElement { name: "a"; group: 1 }
+        ListElement { name: "b"; group: 2 }
+        ListElement { name: "c"; group: 1 }
+        ListElement { name: "d"; group: 3 }
+        ListElement { name: "e"; group: 1 }
+    }
+
+    SortFilterProxyModel {
+        id: testModel
+        sourceModel: listModel
+        statistics.enabled: true
+        filters: ValueFilter {
+            id: groupFilter
+            objectName: "groupFilter"
+            roleName: "group"
+            value: 1
+        }
+        sorters: RoleSorter {
+            id: nameSorter
+            roleName: "name"
+        }
+        proxyRoles: ExpressionRole {
+            name: "upperName"
+            expression: model.name.toUpperCase()
+        }
+    }
+
+    SortFilterProxyModel {
+        id: removalModel
+        sourceModel: listModel
+        statistics.enabled: true
+        filters: [
+            ValueFilter {
+                id: firstFilter
+                objectName: "firstFilter"
+                roleName: "group"
+                value: 1
+            },
+            ValueFilter {
+                id: secondFilter
+                objectName: "secondFilter"
+                roleName: "name"
+                value: "c"
+                inverted: true
+            }
+        ]
+        sorters: RoleSorter {
+            roleName: "name"
+        }
+    }
+
+    TestCase {
+        name: "Statistics"
+
+        function init() {
+            testModel.statistics.enabled = true;
+            testModel.statistics.reset();
+        }
+
+        function test_filters() {
+            groupFilter.value = 2;
+            compare(testModel.count, 1);
+            var filters = testModel.statistics.filters();
+            compare(filters.length, 1);
+            compare(filters[0].name, "ValueFilter (groupFilter)");
+            compare(filters[0].evaluations, listModel.count);
+            compare(filters[0].accepted, 1);
+            compare(filters[0].selectivity, 1 / listModel.count);
+            verify(filters[0].totalTime >= filters[0].maxTime);
+
+            var invalidations = testModel.statistics.invalidations();
+            compare(invalidations.filter.count, 1);
+            compare(invalidations.sort.count, 0);
+            verify(testModel.statistics.sourceDataCalls().group >= listModel.count);
+            groupFilter.value = 1;
+        }
+
+        function test_sorters() {
+            nameSorter.ascendingOrder = false;
+            compare(testModel.get(0, "name"), "e");
+            var invalidations = testModel.statistics.invalidations();
+            compare(invalidations.sort.count, 1);
+            verify(invalidations.sort.lastComparisons > 0);
+            verify(invalidations.comparisons >= invalidations.sort.comparisons);
+            compare(testModel.statistics.sorters().length, 1);
+            verify(testModel.statistics.sorters()[0].evaluations > 0);
+            nameSorter.ascendingOrder = true;
+        }
+
+        function test_proxyRoles() {
+            compare(testModel.get(0, "upperName"), "A");
+            compare(testModel.get(1, "upperName"), "C");
+            var proxyRoles = testModel.statistics.proxyRoles();
+            compare(proxyRoles.length, 1);
+            compare(proxyRoles[0].name, "ExpressionRole");
+            compare(proxyRoles[0].evaluations, 2);
+        }
+
+        function test_removedComponents() {
+            compare(removalModel.count, 2);
+            compare(removalModel.statistics.filters().length, 2);
+            compare(removalModel.statistics.sorters().length, 1);
+
+            // the statistics of the components removed from the model are dropped
+            removalModel.filters = [firstFilter];
+            compare(removalModel.count, 3);
+            var filters = removalModel.statistics.filters();
+            compare(filters.length, 1);
+            compare(filters[0].name, "ValueFilter (firstFilter)");
+
+            removalModel.sorters = [];
+            compare(removalModel.statistics.sorters().length, 0);
+        }
+
+        function test_disabled() {
+            testModel.statistics.enabled = false;
+            groupFilter.value = 3;
+            compare(testModel.count, 1);
+            compare(testModel.get(0, "upperName"), "D");
+            var report = testModel.statistics.report();
+            compare(report.filters.length, 0);
+            compare(report.proxyRoles.length, 0);
+            compare(report.invalidations.filter.count, 0);
+            compare(Object.keys(report.sourceDataCalls).length, 0);
+            groupFilter.value = 1;
+        }
+    }
+}
@@ -43,6 +43,47 @@ Item {
         }
     }
 
+    ListModel {
+        id: statusModel
+        ListElement { status: "ok" }
+        ListElement { status: "error" }
+        ListElement { status: "unknown" }
+        ListElement { status: "2" }
+    }
+
+    SortFilterProxyModel {
+        id: statusProxyModel
+        sourceModel: statusModel
+
+        proxyRoles: SwitchRole {
+            name: "icon"
+            ValueFilter { roleName: "status"; value: "ok"; SwitchRole.value: "check" }
+            ValueFilter { id: errorFilter; roleName: "status"; value: "error"; SwitchRole.value: "cross" }
+            ValueFilter { roleName: "status"; value: "error"; SwitchRole.value: "unused" }
+            ValueFilter { roleName: "status"; value: 2; SwitchRole.value: "two" }
+            defaultValue: "question"
+        }
+    }
+
+    ListModel {
+        id: amountModel
+        ListElement { amount: "1.50" }
+        ListElement { amount: "2" }
+        ListElement { amount: "3" }
+    }
+
+    SortFilterProxyModel {
+        id: amountProxyModel
+        sourceModel: amountModel
+
+        proxyRoles: SwitchRole {
+            name: "label"
+            ValueFilter { roleName: "amount"; value: 1.5; SwitchRole.value: "one and a half" }
+            ValueFilter { roleName: "amount"; value: 2; SwitchRole.value: "two" }
+            defaultValue: "other"
+        }
+    }
+
     Instantiator {
         id: instantiator
         model: testModel
@@ -95,5 +136,28 @@ Item {
             switchRole.defaultRoleName = "name";
             switchRole.defaultValue = "foo";
         }
+
+        function test_valueTable() {
+            compare(statusProxyModel.get(0, "icon"), "check");
+            compare(statusProxyModel.get(1, "icon"), "cross");
+            compare(statusProxyModel.get(2, "icon"), "question");
+            compare(statusProxyModel.get(3, "icon"), "two");
+
+            errorFilter.value = "unknown";
+            compare(statusProxyModel.get(1, "icon"), "unused");
+            compare(statusProxyModel.get(2, "icon"), "cross");
+            errorFilter.value = "error";
+
+            errorFilter.inverted = true;
+            compare(statusProxyModel.get(1, "icon"), "unused");
+            compare(statusProxyModel.get(2, "icon"), "cross");
+            errorFilter.inverted = false;
+        }
+
+        function test_valueTableOtherTypes() {
+            compare(amountProxyModel.get(0, "label"), "one and a half");
+            compare(amountProxyModel.get(1, "label"), "two");
+            compare(amountProxyModel.get(2, "label"), "other");
+        }
     }
 }
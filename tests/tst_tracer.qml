@@ -0,0 +1,130 @@
+import QtQuick 2.0
+import QtQml 2.2
+import QtTest 1.1
+import SortFilterProxyModel 0.2
+
+Item {
+    ListModel {
+        id: listModel
+        ListElement { name: "a"; group: 1 }
+        ListElement { name: "b"; group: 2 }
+        ListElement { name: "c"; group: 1 }
+    }
+
+    SortFilterProxyModel {
+        id: testModel
+        objectName: "testModel"
+        sourceModel: listModel
+        filters: ValueFilter {
+            id: groupFilter
+            objectName: "groupFilter"
+            roleName: "group"
+            value: 1
+        }
+    }
+
+    SortFilterProxyModel {
+        id: delayedModel
+        objectName: "delayedModel"
+        sourceModel: listModel
+        delayed: true
+        sorters: RoleSorter {
+            id: nameSorter
+            roleName: "name"
+        }
+    }
+
+    TestCase {
+        name: "Tracer"
+
+        function init() {
+            Tracer.enabled = true;
+            Tracer.clear();
+        }
+
+        function cleanup() {
+            Tracer.enabled = false;
+            Tracer.clear();
+            groupFilter.value = 1;
+            nameSorter.ascendingOrder = true;
+        }
+
+        function traceEvents(modelName) {
+            var trace = JSON.parse(Tracer.chromeTrace());
+            var tid = -1;
+            trace.traceEvents.forEach(function(event) {
+                if (event.ph === "M" && event.args.name === modelName)
+                    tid = event.tid;
+            });
+            return trace.traceEvents.filter(function(event) {
+                return event.ph !== "M" && event.tid === tid;
+            });
+        }
+
+        function findEvent(events, name) {
+            for (var i = 0; i < events.length; ++i) {
+                if (events[i].name === name)
+                    return events[i];
+            }
+            return null;
+        }
+
+        function test_invalidation() {
+            groupFilter.value = 2;
+            var events = traceEvents("testModel");
+
+            var queue = findEvent(events, "queueInvalidateFilter");
+            verify(queue);
+            compare(queue.ph, "i");
+            compare(queue.args.decision, "immediate");
+            compare(queue.args.cause, "ValueFilter (groupFilter)::invalidated");
+
+            var invalidation = findEvent(events, "filterInvalidation");
+            verify(invalidation);
+            compare(invalidation.ph, "X");
+            compare(invalidation.args.cause, "ValueFilter (groupFilter)::invalidated");
+            var phase = findEvent(events, "QSortFilterProxyModel::invalidateFilter");
+            verify(phase);
+            verify(phase.ts >= invalidation.ts);
+            verify(phase.ts + phase.dur <= invalidation.ts + invalidation.dur);
+        }
+
+        function test_coalescing() {
+            nameSorter.ascendingOrder = false;
+            nameSorter.ascendingOrder = true;
+            var events = traceEvents("delayedModel");
+            var decisions = events.filter(function(event) { return event.name === "queueInvalidate"; })
+                                  .map(function(event) { return event.args.decision; });
+            compare(decisions, ["queued", "coalesced"]);
+            compare(findEvent(events, "sortInvalidation"), null);
+
+            wait(0);
+            events = traceEvents("delayedModel");
+            verify(findEvent(events, "sortInvalidation"));
+            verify(findEvent(events, "buildSortKeys"));
+        }
+
+        function test_sourceSignal() {
+            listModel.setProperty(0, "name", "d");
+            var sourceSignal = findEvent(traceEvents("testModel"), "sourceSignal");
+            verify(sourceSignal);
+            verify(sourceSignal.args.cause.indexOf("::dataChanged") !== -1);
+            listModel.setProperty(0, "name", "a");
+        }
+
+        function test_disabled() {
+            Tracer.enabled = false;
+            groupFilter.value = 2;
+            compare(Tracer.eventCount(), 0);
+        }
+
+        function test_capacity() {
+            var capacity = Tracer.capacity;
+            Tracer.capacity = 4;
+            for (var i = 0; i < 10; ++i)
+                groupFilter.value = i % 2 + 1;
+            compare(Tracer.eventCount(), 4);
+            Tracer.capacity = capacity;
+        }
+    }
+}
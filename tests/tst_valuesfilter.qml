@@ -0,0 +1,151 @@
+import QtQuick 2.0
+import QtQml 2.2
+import QtTest 1.1
+import SortFilterProxyModel 0.2
+
+Item {
+    ListModel {
+        id: listModel
+        ListElement { name: "apple"; category: "fruit"; stock: 1 }
+        ListElement { name: "carrot"; category: "vegetable"; stock: 2 }
+        ListElement { name: "salmon"; category: "fish"; stock: 3 }
+        ListElement { name: "banana"; category: "fruit"; stock: 4 }
+        ListElement { name: "bread"; category: "bakery"; stock: 5 }
+    }
+
+    SortFilterProxyModel {
+        id: testModel
+        sourceModel: listModel
+        filters: ValuesFilter {
+            id: valuesFilter
+            roleName: "category"
+        }
+    }
+
+    ListModel {
+        id: mixedListModel
+        ListElement { kind: 0 }
+        ListElement { kind: 1 }
+        ListElement { kind: 2 }
+        ListElement { kind: 3 }
+        ListElement { kind: 4 }
+        ListElement { kind: 5 }
+    }
+
+    SortFilterProxyModel {
+        id: mixedModel
+        sourceModel: mixedListModel
+        proxyRoles: ExpressionRole {
+            name: "mixed"
+            expression: [true, 1, "1", Qt.point(1, 2), Qt.point(3, 4), ""][model.kind]
+        }
+        filters: ValuesFilter {
+            id: mixedValuesFilter
+            roleName: "mixed"
+        }
+    }
+
+    SortFilterProxyModel {
+        id: anyOfModel
+        sourceModel: mixedListModel
+        proxyRoles: ExpressionRole {
+            name: "mixed"
+            expression: [true, 1, "1", Qt.point(1, 2), Qt.point(3, 4), ""][model.kind]
+        }
+        filters: AnyOf {
+            ValueFilter {
+                id: firstValueFilter
+                roleName: "mixed"
+            }
+            ValueFilter {
+                id: secondValueFilter
+                roleName: "mixed"
+            }
+        }
+    }
+
+    TestCase {
+        name: "ValuesFilter"
+
+        function init() {
+            valuesFilter.roleName = "category";
+            valuesFilter.values = ["fruit", "fish"];
+            valuesFilter.inverted = false;
+        }
+
+        function test_values() {
+            compare(testModel.count, 3);
+            compare(testModel.get(0, "name"), "apple");
+            compare(testModel.get(1, "name"), "salmon");
+            compare(testModel.get(2, "name"), "banana");
+        }
+
+        function test_emptyValues() {
+            valuesFilter.values = [];
+            compare(testModel.count, 0);
+        }
+
+        function test_valuesChanges() {
+            valuesFilter.values = ["fruit"];
+            compare(testModel.count, 2);
+            valuesFilter.values = ["fruit", "bakery", "vegetable"];
+            compare(testModel.count, 4);
+            valuesFilter.values = ["fish", "vegetable"];
+            compare(testModel.count, 2);
+            compare(testModel.get(0, "name"), "carrot");
+            compare(testModel.get(1, "name"), "salmon");
+        }
+
+        function test_inverted() {
+            valuesFilter.inverted = true;
+            compare(testModel.count, 2);
+            valuesFilter.values = ["fruit"];
+            compare(testModel.count, 3);
+            valuesFilter.values = ["fruit", "bakery", "fish"];
+            compare(testModel.count, 1);
+            compare(testModel.get(0, "name"), "carrot");
+        }
+
+        function test_numbers() {
+            valuesFilter.roleName = "stock";
+            valuesFilter.values = [2, 4, 6];
+            compare(testModel.count, 2);
+            compare(testModel.get(0, "name"), "carrot");
+            compare(testModel.get(1, "name"), "banana");
+        }
+
+        function test_mixedTypes_data() {
+            return [
+                { tag: "bool", values: [true, false] },
+                { tag: "number", values: [1, 5] },
+                { tag: "string", values: ["1", "5"] },
+                { tag: "boolAndString", values: [true, "1"] },
+                { tag: "point", values: [Qt.point(1, 2), Qt.point(5, 6)] },
+                { tag: "pointAndEmptyString", values: [Qt.point(3, 4), ""] }
+            ];
+        }
+
+        function test_mixedTypes(data) {
+            // a ValuesFilter accepts the same rows as an AnyOf of ValueFilters
+            mixedValuesFilter.values = data.values;
+            firstValueFilter.value = data.values[0];
+            secondValueFilter.value = data.values[1];
+            verify(anyOfModel.count > 0);
+            compare(mixedModel.count, anyOfModel.count);
+            for (var i = 0; i < anyOfModel.count; ++i)
+                compare(mixedModel.get(i, "kind"), anyOfModel.get(i, "kind"));
+        }
+
+        function test_valuesOfSameKey() {
+            // values with the same key but not equal still change the accepted rows
+            mixedValuesFilter.values = [Qt.point(1, 2)];
+            compare(mixedModel.count, 1);
+            compare(mixedModel.get(0, "kind"), 3);
+            mixedValuesFilter.values = [Qt.point(3, 4)];
+            compare(mixedModel.count, 1);
+            compare(mixedModel.get(0, "kind"), 4);
+            mixedValuesFilter.values = [Qt.point(3, 4), Qt.point(1, 2)];
+            compare(mixedModel.count, 2);
+        }
+    }
+}
@@ -0,0 +1,97 @@
+import QtQuick 2.0
+import QtQml 2.2
+import QtTest 1.1
+import SortFilterProxyModel 0.2
+
+Item {
+    ListModel {
+        id: listModel
+        ListElement { name: "a"; group: 1 }
+        ListElement { name: "b"; group: 2 }
+    }
+
+    SortFilterProxyModel {
+        id: testModel
+        sourceModel: listModel
+        filters: ValueFilter {
+            id: groupFilter
+            roleName: "group"
+            value: 1
+        }
+    }
+
+    WorkloadRecorder {
+        id: recorder
+        model: testModel
+        fileName: "tst_workloadrecorder.sfpmworkload"
+    }
+
+    SortFilterProxyModel {
+        id: sortedModel
+        sourceModel: listModel
+        sorters: RoleSorter {
+            id: nameSorter
+            roleName: "name"
+        }
+    }
+
+    SortFilterProxyModel {
+        id: layoutModel
+        sourceModel: sortedModel
+    }
+
+    WorkloadRecorder {
+        id: layoutRecorder
+        model: layoutModel
+        fileName: "tst_workloadrecorder_layout.sfpmworkload"
+    }
+
+    WorkloadRecorder {
+        id: modellessRecorder
+        fileName: "tst_workloadrecorder_modelless.sfpmworkload"
+    }
+
+    TestCase {
+        name: "WorkloadRecorder"
+
+        function cleanup() {
+            recorder.recording = false;
+            groupFilter.value = 1;
+        }
+
+        function test_recording() {
+            recorder.recording = true;
+            compare(recorder.recording, true);
+            groupFilter.value = 2;
+            listModel.append({ name: "c", group: 2 });
+            listModel.setProperty(2, "name", "d");
+            listModel.remove(2);
+            compare(testModel.count, 1);
+            recorder.recording = false;
+            compare(recorder.recording, false);
+        }
+
+        function test_fileNameChange() {
+            recorder.recording = true;
+            recorder.fileName = "tst_workloadrecorder_renamed.sfpmworkload";
+            compare(recorder.recording, true);
+            recorder.fileName = "tst_workloadrecorder.sfpmworkload";
+        }
+
+        function test_layoutChange() {
+            // sorting the source model rearranges its rows with a layout change
+            layoutRecorder.recording = true;
+            nameSorter.sortOrder = Qt.DescendingOrder;
+            compare(layoutModel.get(0, "name"), "b");
+            nameSorter.sortOrder = Qt.AscendingOrder;
+            compare(layoutModel.get(0, "name"), "a");
+            compare(layoutRecorder.recording, true);
+            layoutRecorder.recording = false;
+        }
+
+        function test_withoutModel() {
+            modellessRecorder.recording = true;
+            compare(modellessRecorder.recording, false);
+        }
+    }
+}
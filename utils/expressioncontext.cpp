@@ -0,0 +1,321 @@
+#include "expressioncontext.h"
+#include "qqmlsortfilterproxymodel.h"
+#include <QQmlContext>
+#include <QQmlExpression>
+#include <QQmlPropertyMap>
+#include <algorithm>
+
+namespace qqsfpm {
+
+namespace {
+
+bool isNameStart(QChar c)
+{
+    return c.isLetter() || c == QLatin1Char('_') || c == QLatin1Char('$');
+}
+
+bool isNamePart(QChar c)
+{
+    return isNameStart(c) || c.isDigit();
+}
+
+/*
+    Adds the identifiers of an expression to names, a superset of the roles it reads by name.
+    The model objects accessed other than with a dot, like model[roleName], can read any role,
+    and the ones not followed by a dot or a bracket are used as values, they can be stored or iterated.
+*/
+void addUsedNames(const QString& text, QSet<QString>& names, bool& dynamicAccess, bool& valueAccess)
+{
+    const int length = text.size();
+    int i = 0;
+    while (i < length) {
+        if (!isNameStart(text.at(i))) {
+            // skips numbers with their exponent or suffix, they aren't names
+            if (text.at(i).isDigit()) {
+                while (i < length && isNamePart(text.at(i)))
+                    ++i;
+            } else {
+                ++i;
+            }
+            continue;
+        }
+        const int start = i;
+        while (i < length && isNamePart(text.at(i)))
+            ++i;
+        const QString name = text.mid(start, i - start);
+        names.insert(name);
+        if (name == QLatin1String("model") || name == QLatin1String("modelLeft") || name == QLatin1String("modelRight")) {
+            int next = i;
+            while (next < length && text.at(next).isSpace())
+                ++next;
+            if (next == length || text.at(next) != QLatin1Char('.'))
+                dynamicAccess = true;
+            if (next == length || (text.at(next) != QLatin1Char('.') && text.at(next) != QLatin1Char('[')))
+                valueAccess = true;
+        }
+    }
+}
+
+}
+
+ExpressionContext::ExpressionContext(QQmlContext* parentContext, QObject* parent) :
+    QObject(parent),
+    m_context(new QQmlContext(parentContext, this)),
+    m_model(new QQmlPropertyMap(this)),
+    m_modelLeft(new QQmlPropertyMap(this)),
+    m_modelRight(new QQmlPropertyMap(this))
+{
+    m_context->setContextProperty(QStringLiteral("model"), m_model);
+    bindPrepared(m_context, m_prepared);
+    setSortModels(false);
+}
+
+// the expression of owner in this context, created again when its script changes
+QQmlExpression* ExpressionContext::expression(const QObject* owner, const QQmlScriptString& scriptString)
+{
+    auto it = m_expressions.find(owner);
+    if (it != m_expressions.end()) {
+        if (it->scriptString == scriptString)
+            return it->expression;
+        delete it->expression;
+        m_expressions.erase(it);
+    } else {
+        connect(owner, &QObject::destroyed, this, [this, owner] {
+            auto destroyed = m_expressions.find(owner);
+            if (destroyed != m_expressions.end()) {
+                delete destroyed->expression;
+                m_expressions.erase(destroyed);
+            }
+        });
+    }
+    QQmlExpression* expression = new QQmlExpression(scriptString, m_context, 0, this);
+    m_expressions.insert(owner, {scriptString, expression});
+    updateUsedNames();
+    return expression;
+}
+
+/*
+    Binds prepared to the prepared value of the component whose expression is evaluated next.
+    It must be set after binding the rows, which can evaluate the expressions of proxy roles with their own prepared values.
+    The property is only set again when it changes, the components sharing the context usually don't all have one.
+*/
+void ExpressionContext::setPrepared(const QJSValue& prepared)
+{
+    if (prepared.strictlyEquals(m_prepared))
+        return;
+
+    m_prepared = prepared;
+    bindPrepared(m_context, m_prepared);
+}
+
+/*
+    Sets the prepare property of a component, returns false if it didn't change.
+    The context in which the component's expression is evaluated once to track its dependencies, if it has one, reads prepared as well.
+*/
+bool ExpressionContext::setPrepare(QJSValue& prepare, const QJSValue& value, QQmlContext* trackingContext)
+{
+    if (prepare.strictlyEquals(value))
+        return false;
+
+    prepare = value;
+    if (trackingContext)
+        bindPrepared(trackingContext, prepare);
+    return true;
+}
+
+void ExpressionContext::bindPrepared(QQmlContext* context, const QJSValue& prepared)
+{
+    context->setContextProperty(QStringLiteral("prepared"), QVariant::fromValue(prepared));
+}
+
+/*
+    Binds model and the role names to the data of a row, and index to its number.
+
+    All the values are read before any property is written: reading a proxy role can evaluate the expression of an ExpressionRole,
+    binding this context to the same or another row in between. The properties are then only written when they differ from the bound ones,
+    consecutive expressions evaluating the same row don't write anything.
+
+    When an expression uses model as a value, each row gets its own map instead of the shared property map,
+    a stored model keeps the data of its row.
+*/
+void ExpressionContext::bindRow(const QModelIndex& sourceIndex, const QQmlSortFilterProxyModel& proxyModel)
+{
+    Values values;
+    readRow(sourceIndex, proxyModel, values);
+    bool changed = false;
+    for (int i = 0; i < values.size(); ++i) {
+        if (sameValue(values.at(i), m_boundValues.at(i)))
+            continue;
+        const QString& name = boundName(i);
+        m_context->setContextProperty(name, values.at(i));
+        if (!m_modelsAsValues)
+            m_model->insert(name, values.at(i));
+        m_boundValues[i] = values.at(i);
+        changed = true;
+    }
+    if (m_modelsAsValues && changed)
+        m_context->setContextProperty(QStringLiteral("model"), modelMap(values));
+}
+
+// binds modelLeft and modelRight to the data of two rows, for the expressions of sorters
+void ExpressionContext::bindRows(const QModelIndex& sourceLeft, const QModelIndex& sourceRight, const QQmlSortFilterProxyModel& proxyModel)
+{
+    Values leftValues;
+    Values rightValues;
+    int version;
+    // reading the right row can create the expression of a proxy role, the left row is then read again with its roles
+    do {
+        readRow(sourceLeft, proxyModel, leftValues);
+        version = m_rolesVersion;
+        readRow(sourceRight, proxyModel, rightValues);
+    } while (version != m_rolesVersion);
+
+    if (m_modelsAsValues) {
+        m_modelLeftMap = modelMap(leftValues);
+        m_modelRightMap = modelMap(rightValues);
+        setSortModels(false);
+        return;
+    }
+    fillModel(m_modelLeft, m_modelLeftValues, leftValues);
+    fillModel(m_modelRight, m_modelRightValues, rightValues);
+    if (m_sortModelsSwapped)
+        setSortModels(false);
+}
+
+// exchanges modelLeft and modelRight, to compare the rows the other way round
+void ExpressionContext::swapRows()
+{
+    setSortModels(!m_sortModelsSwapped);
+}
+
+void ExpressionContext::updateUsedNames()
+{
+    m_usedNames.clear();
+    m_allRolesUsed = false;
+    m_modelsAsValues = false;
+    for (const Expression& expression : m_expressions) {
+        // without its text, an expression can read any role and use the model objects in any way
+        const QString text = expression.expression->expression();
+        if (text.isEmpty()) {
+            m_allRolesUsed = true;
+            m_modelsAsValues = true;
+        } else {
+            addUsedNames(text, m_usedNames, m_allRolesUsed, m_modelsAsValues);
+        }
+    }
+    m_rolesValid = false;
+}
+
+// the roles bound are the ones named in the expressions, the properties of the other roles aren't written for every row
+void ExpressionContext::updateRoles(const QQmlSortFilterProxyModel& proxyModel)
+{
+    const QHash<int, QByteArray> roleNames = proxyModel.roleNames();
+    if (m_rolesValid && roleNames == m_roleNames)
+        return;
+
+    m_rolesValid = true;
+    ++m_rolesVersion;
+    m_roleNames = roleNames;
+    m_roles.clear();
+    for (auto it = roleNames.cbegin(); it != roleNames.cend(); ++it) {
+        const QString name = QString::fromUtf8(it.value());
+        if (m_allRolesUsed || m_usedNames.contains(name))
+            m_roles.append({it.key(), name});
+    }
+    std::sort(m_roles.begin(), m_roles.end(), [] (const Role& left, const Role& right) {
+        return left.role < right.role;
+    });
+
+    // the roles are declared before the first row is bound, an expression reading an undefined role doesn't throw
+    for (const Role& role : m_roles) {
+        m_context->setContextProperty(role.name, QVariant());
+        m_model->insert(role.name, QVariant());
+        m_modelLeft->insert(role.name, QVariant());
+        m_modelRight->insert(role.name, QVariant());
+    }
+    const QVariant noIndex(-1);
+    m_context->setContextProperty(QStringLiteral("index"), noIndex);
+    m_model->insert(QStringLiteral("index"), noIndex);
+    m_modelLeft->insert(QStringLiteral("index"), noIndex);
+    m_modelRight->insert(QStringLiteral("index"), noIndex);
+
+    m_boundValues.fill(QVariant(), m_roles.size());
+    m_boundValues.append(noIndex);
+    m_modelLeftValues = m_boundValues;
+    m_modelRightValues = m_boundValues;
+
+    // the maps of the rows are bound with the first row
+    if (m_modelsAsValues) {
+        m_modelLeftMap.clear();
+        m_modelRightMap.clear();
+        m_context->setContextProperty(QStringLiteral("model"), QVariantMap());
+    } else {
+        m_context->setContextProperty(QStringLiteral("model"), m_model);
+    }
+    setSortModels(m_sortModelsSwapped);
+}
+
+/*
+    Reads the values of the bound roles of a row. Reading a proxy role can create the expression of an ExpressionRole,
+    the row is then read again with the roles it uses.
+*/
+void ExpressionContext::readRow(const QModelIndex& sourceIndex, const QQmlSortFilterProxyModel& proxyModel, Values& values)
+{
+    int version;
+    do {
+        updateRoles(proxyModel);
+        version = m_rolesVersion;
+        values.clear();
+        for (int i = 0; i < m_roles.size() && version == m_rolesVersion; ++i)
+            values.append(proxyModel.sourceData(sourceIndex, m_roles.at(i).role));
+        values.append(sourceIndex.row());
+    } while (version != m_rolesVersion || !m_rolesValid);
+}
+
+const QString& ExpressionContext::boundName(int value) const
+{
+    static const QString index = QStringLiteral("index");
+    return value < m_roles.size() ? m_roles.at(value).name : index;
+}
+
+void ExpressionContext::fillModel(QQmlPropertyMap* model, QVector<QVariant>& boundValues, const Values& values)
+{
+    for (int i = 0; i < values.size(); ++i) {
+        if (sameValue(values.at(i), boundValues.at(i)))
+            continue;
+        model->insert(boundName(i), values.at(i));
+        boundValues[i] = values.at(i);
+    }
+}
+
+QVariantMap ExpressionContext::modelMap(const Values& values) const
+{
+    QVariantMap map;
+    for (int i = 0; i < values.size(); ++i)
+        map.insert(boundName(i), values.at(i));
+    return map;
+}
+
+void ExpressionContext::setSortModels(bool swapped)
+{
+    if (m_modelsAsValues) {
+        m_context->setContextProperty(QStringLiteral("modelLeft"), swapped ? m_modelRightMap : m_modelLeftMap);
+        m_context->setContextProperty(QStringLiteral("modelRight"), swapped ? m_modelLeftMap : m_modelRightMap);
+    } else {
+        m_context->setContextProperty(QStringLiteral("modelLeft"), swapped ? m_modelRight : m_modelLeft);
+        m_context->setContextProperty(QStringLiteral("modelRight"), swapped ? m_modelLeft : m_modelRight);
+    }
+    m_sortModelsSwapped = swapped;
+}
+
+// QVariant compares numbers of different types and floating point numbers fuzzily, a bound value is only kept if it is identical
+bool ExpressionContext::sameValue(const QVariant& left, const QVariant& right)
+{
+    if (left.userType() != right.userType())
+        return false;
+    if (left.userType() == QMetaType::Double)
+        return left.toDouble() == right.toDouble();
+    return left == right;
+}
+
+}
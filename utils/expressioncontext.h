@@ -0,0 +1,97 @@
+#ifndef EXPRESSIONCONTEXT_H
+#define EXPRESSIONCONTEXT_H
+
+#include <QObject>
+#include <QHash>
+#include <QSet>
+#include <QVector>
+#include <QVarLengthArray>
+#include <QVariantMap>
+#include <QModelIndex>
+#include <QQmlScriptString>
+#include <QJSValue>
+
+class QQmlContext;
+class QQmlExpression;
+class QQmlPropertyMap;
+
+namespace qqsfpm {
+
+class QQmlSortFilterProxyModel;
+
+/*
+    The QML context in which the expressions of the filters, sorters and proxy roles of a proxy model are evaluated.
+    A single context, with its model objects and an expression per component, is reused for every row and every expression
+    declared in the same QML context, instead of being created for each evaluation.
+
+    Only the roles named in the expressions are bound, and only the properties whose value differs from the previous row are written.
+    The model objects are property maps shared by all the rows, unless an expression uses one as a value: each row then gets its own map.
+*/
+class ExpressionContext : public QObject
+{
+    Q_OBJECT
+
+public:
+    ExpressionContext(QQmlContext* parentContext, QObject* parent);
+
+    QQmlExpression* expression(const QObject* owner, const QQmlScriptString& scriptString);
+
+    void setPrepared(const QJSValue& prepared);
+    static bool setPrepare(QJSValue& prepare, const QJSValue& value, QQmlContext* trackingContext);
+    static void bindPrepared(QQmlContext* context, const QJSValue& prepared);
+    void bindRow(const QModelIndex& sourceIndex, const QQmlSortFilterProxyModel& proxyModel);
+    void bindRows(const QModelIndex& sourceLeft, const QModelIndex& sourceRight, const QQmlSortFilterProxyModel& proxyModel);
+    void swapRows();
+
+private:
+    struct Role {
+        int role;
+        QString name;
+    };
+
+    using Values = QVarLengthArray<QVariant, 32>;
+
+    void updateUsedNames();
+    void updateRoles(const QQmlSortFilterProxyModel& proxyModel);
+    void readRow(const QModelIndex& sourceIndex, const QQmlSortFilterProxyModel& proxyModel, Values& values);
+    const QString& boundName(int value) const;
+    void fillModel(QQmlPropertyMap* model, QVector<QVariant>& boundValues, const Values& values);
+    QVariantMap modelMap(const Values& values) const;
+    void setSortModels(bool swapped);
+
+    static bool sameValue(const QVariant& left, const QVariant& right);
+
+    struct Expression {
+        QQmlScriptString scriptString;
+        QQmlExpression* expression;
+    };
+
+    QQmlContext* m_context;
+    QQmlPropertyMap* m_model;
+    QQmlPropertyMap* m_modelLeft;
+    QQmlPropertyMap* m_modelRight;
+    bool m_sortModelsSwapped = false;
+    QJSValue m_prepared;
+    QHash<const QObject*, Expression> m_expressions;
+
+    // the names used by the expressions, all the roles are bound if one of them accesses the model objects dynamically
+    QSet<QString> m_usedNames;
+    bool m_allRolesUsed = false;
+    // an expression storing or iterating a model object needs a map per row, the shared property maps would change under it
+    bool m_modelsAsValues = false;
+    QVariantMap m_modelLeftMap;
+    QVariantMap m_modelRightMap;
+    bool m_rolesValid = false;
+    int m_rolesVersion = 0;
+    QHash<int, QByteArray> m_roleNames;
+    QVector<Role> m_roles;
+
+    // the values currently bound to the context and the model objects, one per role followed by the index
+    QVector<QVariant> m_boundValues;
+    QVector<QVariant> m_modelLeftValues;
+    QVector<QVariant> m_modelRightValues;
+};
+
+}
+
+#endif // EXPRESSIONCONTEXT_H
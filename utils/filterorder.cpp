@@ -0,0 +1,91 @@
+#include "filterorder.h"
+#include "filters/filter.h"
+#include <algorithm>
+#include <numeric>
+
+namespace qqsfpm {
+
+namespace {
+
+// the estimated time of an evaluation before any measure, in nanoseconds
+double estimatedNsecs(CostClass costClass)
+{
+    switch (costClass) {
+    case CostClass::Constant:
+        return 10;
+    case CostClass::Role:
+        return 100;
+    case CostClass::Text:
+        return 400;
+    case CostClass::Script:
+        return 5000;
+    }
+    return 100;
+}
+
+}
+
+// the current evaluation order, as indexes in the filters of the container
+QVector<int> FilterOrder::order(int filterCount) const
+{
+    if (m_order.size() == filterCount)
+        return m_order;
+    QVector<int> order(filterCount);
+    std::iota(order.begin(), order.end(), 0);
+    return order;
+}
+
+// to be called when the filters of the container change, the declaration order is used until new measures are taken
+void FilterOrder::reset()
+{
+    m_order.clear();
+    m_measures.clear();
+    m_rows = 0;
+}
+
+void FilterOrder::rebuild(const QList<Filter*>& filters)
+{
+    m_order.resize(filters.size());
+    std::iota(m_order.begin(), m_order.end(), 0);
+    m_measures = QVector<FilterMeasures>(filters.size());
+    m_ranks.resize(filters.size());
+    m_rows = 0;
+    reorder(filters);
+}
+
+/*
+    Sorts each run of consecutive pure filters by their expected cost per decided row:
+    the average time of an evaluation divided by the probability that it decides the row.
+    Both start from the estimate of the cost class of the filter and an even probability, and converge to the measures.
+    It happens while the rows are filtered, so it doesn't allocate: the ranks are kept between reorderings,
+    and the runs are insertion sorted, a container having a few filters.
+*/
+void FilterOrder::reorder(const QList<Filter*>& filters)
+{
+    const int count = filters.size();
+    QVector<double>& ranks = m_ranks;
+    for (int i = 0; i < count; ++i) {
+        const FilterMeasures& measures = m_measures.at(i);
+        const double nsecs = (estimatedNsecs(filters.at(i)->costClass()) + measures.nsecs) / (1 + measures.timedEvaluations);
+        const double decisionRate = (measures.decisions + 1.0) / (measures.evaluations + 2.0);
+        ranks[i] = nsecs / decisionRate;
+    }
+
+    // the declaration order, with the pure filters sorted between the impure ones
+    std::iota(m_order.begin(), m_order.end(), 0);
+    auto runStart = m_order.begin();
+    while (runStart != m_order.end()) {
+        auto runEnd = std::find_if(runStart, m_order.end(), [&filters] (int index) {
+            return !filters.at(index)->isPure();
+        });
+        for (auto it = runStart; it != runEnd; ++it) {
+            auto position = std::upper_bound(runStart, it, *it, [&ranks] (int left, int right) {
+                return ranks.at(left) < ranks.at(right);
+            });
+            std::rotate(position, it, it + 1);
+        }
+        runStart = runEnd == m_order.end() ? runEnd : runEnd + 1;
+    }
+}
+
+}
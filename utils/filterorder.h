@@ -0,0 +1,86 @@
+#ifndef FILTERORDER_H
+#define FILTERORDER_H
+
+#include <QList>
+#include <QVector>
+#include <QElapsedTimer>
+
+namespace qqsfpm {
+
+class Filter;
+
+/*
+    The order in which the filters of a container are evaluated, adapted to their measured cost and selectivity.
+    A row is decided by the first filter returning the stop result (false for all the filters to accept, true for any),
+    so the filters cheapest to evaluate and most likely to decide the row are evaluated first.
+    Filters that aren't pure keep their position, and pure filters are never moved across them,
+    so that the evaluations with side effects happen exactly like in declaration order.
+*/
+class FilterOrder
+{
+public:
+    template <typename Predicate>
+    bool evaluate(const QList<Filter*>& filters, bool stopResult, Predicate predicate);
+
+    QVector<int> order(int filterCount) const;
+    void reset();
+
+private:
+    struct FilterMeasures {
+        qint64 evaluations = 0;
+        qint64 decisions = 0;
+        qint64 timedEvaluations = 0;
+        qint64 nsecs = 0;
+    };
+
+    void rebuild(const QList<Filter*>& filters);
+    void reorder(const QList<Filter*>& filters);
+
+    QVector<int> m_order;
+    QVector<FilterMeasures> m_measures;
+    QVector<double> m_ranks;
+    int m_rows = 0;
+};
+
+namespace FilterOrderPrivate {
+// one row out of TimingInterval is timed, the order is adapted every ReorderInterval rows
+const int TimingInterval = 16;
+const int ReorderInterval = 256;
+}
+
+// returns stopResult if a filter returned it, !stopResult otherwise
+template <typename Predicate>
+bool FilterOrder::evaluate(const QList<Filter*>& filters, bool stopResult, Predicate predicate)
+{
+    if (m_order.size() != filters.size())
+        rebuild(filters);
+    if (filters.size() < 2)
+        return filters.isEmpty() ? !stopResult : predicate(filters.first());
+
+    if (++m_rows % FilterOrderPrivate::ReorderInterval == 0)
+        reorder(filters);
+    const bool timed = m_rows % FilterOrderPrivate::TimingInterval == 0;
+    QElapsedTimer timer;
+    for (int index : m_order) {
+        FilterMeasures& measures = m_measures[index];
+        ++measures.evaluations;
+        bool result;
+        if (Q_UNLIKELY(timed)) {
+            timer.start();
+            result = predicate(filters.at(index));
+            measures.nsecs += timer.nsecsElapsed();
+            ++measures.timedEvaluations;
+        } else {
+            result = predicate(filters.at(index));
+        }
+        if (result == stopResult) {
+            ++measures.decisions;
+            return stopResult;
+        }
+    }
+    return !stopResult;
+}
+
+}
+
+#endif // FILTERORDER_H
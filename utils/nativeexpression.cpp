@@ -0,0 +1,96 @@
+#include "nativeexpression.h"
+#include <QQmlContext>
+#include <QQmlExpression>
+#include <QQmlEngine>
+
+namespace qqsfpm {
+
+NativeExpression::~NativeExpression()
+{
+    clear();
+}
+
+// the roles that the expression can read, like the context properties of the rows
+void NativeExpression::setRoleNames(const QStringList& roleNames)
+{
+    m_roleNames = roleNames;
+}
+
+/*
+    Compiles the script of an expression declared on scope, returns false if it isn't in the supported subset
+    or if its external values can't be evaluated, the expression then has to be evaluated with JavaScript.
+    changed is called when an external value changes, after it has been evaluated again.
+    The expression has to be compiled again when the role names change.
+*/
+bool NativeExpression::compile(const QString& script, QObject* scope, const std::function<void()>& changed)
+{
+    clear();
+    QQmlContext* context = qmlContext(scope);
+    if (!context || !m_query.parse(script, Query::JavaScriptSyntax, m_roleNames) || m_query.isEmpty())
+        return false;
+
+    // a property of scope, like the name of an ExpressionRole, is hidden by a role of the same name in JavaScript
+    for (const QString& name : m_query.parameterNames()) {
+        const QString firstName = name.section(QLatin1Char('.'), 0, 0);
+        if (scope->metaObject()->indexOfProperty(firstName.toUtf8().constData()) >= 0)
+            return false;
+    }
+
+    for (const QString& name : m_query.parameterNames()) {
+        QQmlExpression* external = new QQmlExpression(context, scope, name, scope);
+        external->setNotifyOnValueChanged(true);
+        QObject::connect(external, &QQmlExpression::valueChanged, scope, [this, changed] {
+            update();
+            changed();
+        });
+        m_externals.append(external);
+    }
+    update();
+
+    for (QQmlExpression* external : m_externals) {
+        if (external->hasError()) {
+            clear();
+            return false;
+        }
+    }
+    // the roles can hold any type, but the literals and external values must be usable with their operators
+    if (!m_query.check()) {
+        clear();
+        return false;
+    }
+    m_compiled = true;
+    return true;
+}
+
+void NativeExpression::clear()
+{
+    qDeleteAll(m_externals);
+    m_externals.clear();
+    m_compiled = false;
+}
+
+bool NativeExpression::isCompiled() const
+{
+    return m_compiled;
+}
+
+// returns false if the row has values that only JavaScript converts, it then has to be evaluated with JavaScript
+bool NativeExpression::matches(const QModelIndex& sourceIndex, const QQmlSortFilterProxyModel& proxyModel, bool& accepted) const
+{
+    accepted = m_query.matches(sourceIndex, proxyModel);
+    return !m_query.hasUnsupportedValue();
+}
+
+bool NativeExpression::evaluate(const QModelIndex& sourceIndex, const QQmlSortFilterProxyModel& proxyModel, QVariant& result) const
+{
+    result = m_query.evaluate(sourceIndex, proxyModel);
+    return !m_query.hasUnsupportedValue();
+}
+
+void NativeExpression::update()
+{
+    for (int i = 0; i < m_externals.size(); ++i)
+        m_query.setParameterValue(i, m_externals.at(i)->evaluate());
+}
+
+}
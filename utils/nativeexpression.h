@@ -0,0 +1,46 @@
+#ifndef NATIVEEXPRESSION_H
+#define NATIVEEXPRESSION_H
+
+#include "utils/query.h"
+#include <QList>
+#include <functional>
+
+class QObject;
+class QQmlExpression;
+
+namespace qqsfpm {
+
+/*
+    The expression of an ExpressionFilter or an ExpressionRole, evaluated natively when it is simple enough:
+    made of roles (model.name or a bare role name), literals, external values (like root.minimum),
+    comparisons, logical and arithmetic operators.
+    Only the external values are evaluated with JavaScript, once when one of the properties they depend on changes,
+    instead of the whole expression for each row.
+    The operators convert their operands like JavaScript, a row with values that JavaScript converts as objects,
+    like dates or lists, has to be evaluated with JavaScript.
+*/
+class NativeExpression
+{
+public:
+    ~NativeExpression();
+
+    void setRoleNames(const QStringList& roleNames);
+    bool compile(const QString& script, QObject* scope, const std::function<void()>& changed);
+    void clear();
+    bool isCompiled() const;
+
+    bool matches(const QModelIndex& sourceIndex, const QQmlSortFilterProxyModel& proxyModel, bool& accepted) const;
+    bool evaluate(const QModelIndex& sourceIndex, const QQmlSortFilterProxyModel& proxyModel, QVariant& result) const;
+
+private:
+    void update();
+
+    QStringList m_roleNames;
+    Query m_query;
+    QList<QQmlExpression*> m_externals;
+    bool m_compiled = false;
+};
+
+}
+
+#endif // NATIVEEXPRESSION_H
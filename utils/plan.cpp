@@ -0,0 +1,95 @@
+#include "plan.h"
+#include "filters/filter.h"
+#include <QMetaObject>
+#include <algorithm>
+
+namespace qqsfpm {
+
+QString Plan::costClassName(CostClass costClass)
+{
+    switch (costClass) {
+    case CostClass::Constant:
+        return QStringLiteral("constant");
+    case CostClass::Role:
+        return QStringLiteral("role");
+    case CostClass::Text:
+        return QStringLiteral("text");
+    case CostClass::Script:
+        return QStringLiteral("script");
+    }
+    return QString();
+}
+
+// the name of the QML type of an object, types declared in QML files are subclasses named like Type_QML_12
+QString Plan::qmlTypeName(const QObject* object)
+{
+    const QMetaObject* metaObject = object->metaObject();
+    while (metaObject->superClass() && QByteArray(metaObject->className()).contains("_QML_"))
+        metaObject = metaObject->superClass();
+    QString name = QString::fromLatin1(metaObject->className()).remove(QStringLiteral("qqsfpm::"));
+    if (name == QLatin1String("QQmlSortFilterProxyModel"))
+        return QStringLiteral("SortFilterProxyModel");
+    if (name == QLatin1String("AnyOfFilter"))
+        return QStringLiteral("AnyOf");
+    if (name == QLatin1String("AllOfFilter"))
+        return QStringLiteral("AllOf");
+    return name;
+}
+
+// the cost of the most expensive enabled filter
+CostClass Plan::filtersCostClass(const QList<Filter*>& filters)
+{
+    CostClass costClass = CostClass::Constant;
+    for (Filter* filter : filters) {
+        if (filter->enabled())
+            costClass = std::max(costClass, filter->costClass());
+    }
+    return costClass;
+}
+
+// the filters in declaration order, each with its position in the evaluation order (the declaration order if order is empty)
+QVariantList Plan::explainFilters(const QList<Filter*>& filters, const QQmlSortFilterProxyModel& proxyModel, const PlanAnalysis* analysis,
+                                  const QVector<int>& order)
+{
+    QVariantList plans;
+    for (int i = 0; i < filters.size(); ++i) {
+        QVariantMap plan = filters.at(i)->explain(proxyModel, analysis);
+        plan.insert(QStringLiteral("order"), order.isEmpty() ? i : order.indexOf(i));
+        plans.append(plan);
+    }
+    return plans;
+}
+
+void PlanAnalysis::record(const void* node, bool accepted, qint64 nsecs, qint64 dataCalls)
+{
+    Node& measures = m_nodes[node];
+    ++measures.rowsIn;
+    if (accepted)
+        ++measures.rowsOut;
+    measures.nsecs += nsecs;
+    measures.dataCalls += dataCalls;
+}
+
+void PlanAnalysis::recordListing(const void* node, int rows, qint64 nsecs)
+{
+    Node& measures = m_nodes[node];
+    measures.listedRows = rows;
+    measures.listingNsecs = nsecs;
+}
+
+// adds the measurements of a node to its plan, its time includes the time of its children
+void PlanAnalysis::annotate(QVariantMap& plan, const void* node, const QString& rowsInName, bool withRowsOut) const
+{
+    const Node measures = m_nodes.value(node);
+    plan.insert(rowsInName, measures.rowsIn);
+    if (withRowsOut)
+        plan.insert(QStringLiteral("rowsOut"), measures.rowsOut);
+    plan.insert(QStringLiteral("time"), measures.nsecs / 1000000.0);
+    plan.insert(QStringLiteral("dataCalls"), measures.dataCalls);
+    if (measures.listedRows != -1) {
+        plan.insert(QStringLiteral("listedRows"), measures.listedRows);
+        plan.insert(QStringLiteral("listingTime"), measures.listingNsecs / 1000000.0);
+    }
+}
+
+}
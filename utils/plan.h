@@ -0,0 +1,58 @@
+#ifndef PLAN_H
+#define PLAN_H
+
+#include <QHash>
+#include <QVariant>
+#include <QVector>
+
+namespace qqsfpm {
+
+class Filter;
+class QQmlSortFilterProxyModel;
+class PlanAnalysis;
+
+// the estimated cost of evaluating a filter, sorter or proxy role for a row, from the cheapest to the most expensive
+enum class CostClass {
+    Constant,   // doesn't read the row, like an IndexFilter
+    Role,       // compares role values
+    Text,       // matches strings, with a regular expression, a collator or fuzzily
+    Script      // evaluates a JavaScript expression
+};
+
+// helpers for SortFilterProxyModel::explain() and analyze()
+class Plan
+{
+public:
+    static QString costClassName(CostClass costClass);
+    static QString qmlTypeName(const QObject* object);
+    static CostClass filtersCostClass(const QList<Filter*>& filters);
+    static QVariantList explainFilters(const QList<Filter*>& filters, const QQmlSortFilterProxyModel& proxyModel, const PlanAnalysis* analysis,
+                                       const QVector<int>& order = QVector<int>());
+};
+
+// the measurements of SortFilterProxyModel::analyze(), for each node of the plan
+class PlanAnalysis
+{
+public:
+    void record(const void* node, bool accepted, qint64 nsecs, qint64 dataCalls);
+    void recordListing(const void* node, int rows, qint64 nsecs);
+    void annotate(QVariantMap& plan, const void* node, const QString& rowsInName, bool withRowsOut) const;
+
+    qint64 dataCalls = 0;
+
+private:
+    struct Node {
+        qint64 rowsIn = 0;
+        qint64 rowsOut = 0;
+        qint64 nsecs = 0;
+        qint64 dataCalls = 0;
+        int listedRows = -1;
+        qint64 listingNsecs = 0;
+    };
+
+    QHash<const void*, Node> m_nodes;
+};
+
+}
+
+#endif // PLAN_H
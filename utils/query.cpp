@@ -0,0 +1,1334 @@
+#include "query.h"
+#include "qqmlsortfilterproxymodel.h"
+#include <QBitArray>
+#include <QJSValue>
+#include <QLocale>
+#include <qnumeric.h>
+#include <cmath>
+#include <limits>
+
+namespace qqsfpm {
+
+namespace {
+
+// the types of the values that the JavaScript syntax converts like JavaScript, the other values are objects in JavaScript
+enum class JavaScriptType { Undefined, Null, Boolean, Number, String, Object };
+
+JavaScriptType javaScriptType(const QVariant& value)
+{
+    switch (value.userType()) {
+    case QMetaType::UnknownType:
+        return JavaScriptType::Undefined;
+    case QMetaType::Nullptr:
+        return JavaScriptType::Null;
+    case QMetaType::Bool:
+        return JavaScriptType::Boolean;
+    case QMetaType::Int:
+    case QMetaType::UInt:
+    case QMetaType::LongLong:
+    case QMetaType::ULongLong:
+    case QMetaType::Double:
+    case QMetaType::Float:
+        return JavaScriptType::Number;
+    case QMetaType::QString:
+        return JavaScriptType::String;
+    case QMetaType::QObjectStar:
+        return value.value<QObject*>() ? JavaScriptType::Object : JavaScriptType::Null;
+    default:
+        return JavaScriptType::Object;
+    }
+}
+
+int digitValue(QChar c)
+{
+    const ushort unicode = c.unicode();
+    if (unicode >= '0' && unicode <= '9')
+        return unicode - '0';
+    if (unicode >= 'a' && unicode <= 'z')
+        return unicode - 'a' + 10;
+    if (unicode >= 'A' && unicode <= 'Z')
+        return unicode - 'A' + 10;
+    return -1;
+}
+
+/*
+    Converts a string like JavaScript's Number(): surrounded by white space, empty being 0,
+    a decimal number, Infinity, or a hexadecimal, octal or binary integer. Anything else is NaN.
+*/
+double stringToNumber(const QString& string)
+{
+    const QString text = string.trimmed();
+    if (text.isEmpty())
+        return 0;
+
+    if (text.size() > 2 && text.at(0) == QLatin1Char('0')) {
+        const QChar prefix = text.at(1).toLower();
+        const int base = prefix == QLatin1Char('x') ? 16 : (prefix == QLatin1Char('o') ? 8 : (prefix == QLatin1Char('b') ? 2 : 0));
+        if (base) {
+            double result = 0;
+            for (int i = 2; i < text.size(); ++i) {
+                const int digit = digitValue(text.at(i));
+                if (digit < 0 || digit >= base)
+                    return qQNaN();
+                result = result * base + digit;
+            }
+            return result;
+        }
+    }
+
+    int i = 0;
+    const bool negative = text.at(0) == QLatin1Char('-');
+    if (negative || text.at(0) == QLatin1Char('+'))
+        ++i;
+    if (text.midRef(i) == QLatin1String("Infinity"))
+        return negative ? -qInf() : qInf();
+
+    // the number is rewritten in the form accepted by QLocale, like 0.5 for .5
+    auto digits = [&] {
+        const int start = i;
+        while (i < text.size() && text.at(i).unicode() >= '0' && text.at(i).unicode() <= '9')
+            ++i;
+        return text.mid(start, i - start);
+    };
+    const QString integerPart = digits();
+    QString fractionPart;
+    if (i < text.size() && text.at(i) == QLatin1Char('.')) {
+        ++i;
+        fractionPart = digits();
+    }
+    if (integerPart.isEmpty() && fractionPart.isEmpty())
+        return qQNaN();
+    QString number = negative ? QStringLiteral("-") : QString();
+    number += integerPart.isEmpty() ? QStringLiteral("0") : integerPart;
+    if (!fractionPart.isEmpty())
+        number += QLatin1Char('.') + fractionPart;
+    if (i < text.size() && (text.at(i) == QLatin1Char('e') || text.at(i) == QLatin1Char('E'))) {
+        ++i;
+        QString exponentSign;
+        if (i < text.size() && (text.at(i) == QLatin1Char('-') || text.at(i) == QLatin1Char('+')))
+            exponentSign = text.at(i++);
+        const QString exponent = digits();
+        if (exponent.isEmpty())
+            return qQNaN();
+        number += QLatin1Char('e') + exponentSign + exponent;
+    }
+    if (i != text.size())
+        return qQNaN();
+
+    bool ok = false;
+    const double result = QLocale::c().toDouble(number, &ok);
+    return ok || qIsInf(result) ? result : qQNaN();
+}
+
+// converts a number like JavaScript's String(), with the shortest digits identifying it
+QString numberToString(double number)
+{
+    if (qIsNaN(number))
+        return QStringLiteral("NaN");
+    if (number == 0)
+        return QStringLiteral("0");
+    if (number < 0)
+        return QLatin1Char('-') + numberToString(-number);
+    if (qIsInf(number))
+        return QStringLiteral("Infinity");
+
+    // the k digits and the exponent n of the number being 0.digits * 10^n
+    const QString scientific = QString::number(number, 'e', QLocale::FloatingPointShortest);
+    const int exponentPosition = scientific.indexOf(QLatin1Char('e'));
+    QString digits = scientific.left(exponentPosition);
+    digits.remove(QLatin1Char('.'));
+    const int k = digits.size();
+    const int n = scientific.midRef(exponentPosition + 1).toInt() + 1;
+
+    if (k <= n && n <= 21)
+        return digits + QString(n - k, QLatin1Char('0'));
+    if (0 < n && n <= 21)
+        return digits.left(n) + QLatin1Char('.') + digits.mid(n);
+    if (-6 < n && n <= 0)
+        return QStringLiteral("0.") + QString(-n, QLatin1Char('0')) + digits;
+    const QString exponent = (n - 1 < 0 ? QStringLiteral("e-") : QStringLiteral("e+")) + QString::number(qAbs(n - 1));
+    if (k == 1)
+        return digits + exponent;
+    return digits.left(1) + QLatin1Char('.') + digits.mid(1) + exponent;
+}
+
+double javaScriptNumber(const QVariant& value)
+{
+    switch (javaScriptType(value)) {
+    case JavaScriptType::Null:
+        return 0;
+    case JavaScriptType::Boolean:
+        return value.toBool() ? 1 : 0;
+    case JavaScriptType::Number:
+        return value.toDouble();
+    case JavaScriptType::String:
+        return stringToNumber(*static_cast<const QString*>(value.constData()));
+    default:
+        return qQNaN();
+    }
+}
+
+QString javaScriptString(const QVariant& value)
+{
+    switch (javaScriptType(value)) {
+    case JavaScriptType::Undefined:
+        return QStringLiteral("undefined");
+    case JavaScriptType::Null:
+        return QStringLiteral("null");
+    case JavaScriptType::Boolean:
+        return value.toBool() ? QStringLiteral("true") : QStringLiteral("false");
+    case JavaScriptType::Number:
+        return numberToString(value.toDouble());
+    default:
+        return value.toString();
+    }
+}
+
+// like the JavaScript engine, an integral number is an int when it fits in one
+QVariant numberValue(double number)
+{
+    if (number >= std::numeric_limits<int>::min() && number <= std::numeric_limits<int>::max()
+            && number == std::floor(number) && !(number == 0 && std::signbit(number)))
+        return static_cast<int>(number);
+    return number;
+}
+
+// the === of JavaScript for two values of the same primitive type
+bool strictEquals(JavaScriptType type, const QVariant& left, const QVariant& right)
+{
+    switch (type) {
+    case JavaScriptType::Boolean:
+        return left.toBool() == right.toBool();
+    case JavaScriptType::Number:
+        return left.toDouble() == right.toDouble();
+    case JavaScriptType::String:
+        return *static_cast<const QString*>(left.constData()) == *static_cast<const QString*>(right.constData());
+    default:
+        return true;
+    }
+}
+
+}
+
+/*
+    A recursive descent parser adding the nodes of a query to it, from the lowest precedence to the highest:
+    ||, &&, the comparisons (not associative), + and -, *, / and %, the unary ! and -, and the operands.
+    With the JavaScript syntax, the names are resolved to roles or to external values, and anything else fails to parse.
+*/
+class Query::Parser
+{
+public:
+    Parser(const QString& text, const QStringList& roleNames, Query& query);
+
+    bool parse();
+
+private:
+    enum TokenType { EndToken, NumberToken, StringToken, NameToken, ParameterToken, SymbolToken };
+    enum Level { OrLevel, AndLevel, ComparisonLevel, AdditiveLevel, MultiplicativeLevel, UnaryLevel };
+
+    bool lex();
+    bool isSymbol(const char* symbol) const;
+    bool isName(const char* name) const;
+    bool binaryOperator(int level, Operator& op) const;
+    int parseLevel(int level);
+    int parseUnary();
+    int parseOperand();
+    int parseJavaScriptName();
+    int parseList();
+    int unexpected();
+    int fail(int position, const QString& message);
+
+    const QString& m_text;
+    const QStringList& m_roleNames;
+    Query& m_query;
+    const bool m_javaScript;
+    int m_position = 0;
+    TokenType m_tokenType = EndToken;
+    int m_tokenPosition = 0;
+    QString m_token; // the text of a name, parameter or symbol, or the value of a string
+    double m_number = 0;
+};
+
+Query::Parser::Parser(const QString& text, const QStringList& roleNames, Query& query) :
+    m_text(text),
+    m_roleNames(roleNames),
+    m_query(query),
+    m_javaScript(query.m_syntax == JavaScriptSyntax)
+{
+}
+
+bool Query::Parser::parse()
+{
+    if (!lex())
+        return false;
+    if (m_tokenType == EndToken)
+        return true;
+
+    int root = parseLevel(OrLevel);
+    if (root < 0)
+        return false;
+    if (m_javaScript && isSymbol(";") && !lex())
+        return false;
+    if (m_tokenType != EndToken)
+        return unexpected() >= 0;
+    m_query.m_root = root;
+    return true;
+}
+
+bool Query::Parser::lex()
+{
+    const int length = m_text.size();
+    while (m_position < length && m_text.at(m_position).isSpace())
+        ++m_position;
+    m_tokenPosition = m_position;
+    m_token.clear();
+    if (m_position == length) {
+        m_tokenType = EndToken;
+        return true;
+    }
+
+    auto isDigitAt = [&] (int i) { return i < length && m_text.at(i).isDigit(); };
+    auto isNameAt = [&] (int i, bool first) {
+        if (i >= length)
+            return false;
+        QChar c = m_text.at(i);
+        return c.isLetter() || c == QLatin1Char('_') || (m_javaScript && c == QLatin1Char('$')) || (!first && c.isDigit());
+    };
+
+    const QChar c = m_text.at(m_position);
+    if (c.isDigit() || (c == QLatin1Char('.') && isDigitAt(m_position + 1))) {
+        int end = m_position;
+        while (isDigitAt(end) || (end < length && m_text.at(end) == QLatin1Char('.')))
+            ++end;
+        if (end < length && (m_text.at(end) == QLatin1Char('e') || m_text.at(end) == QLatin1Char('E'))) {
+            int exponent = end + 1;
+            if (exponent < length && (m_text.at(exponent) == QLatin1Char('+') || m_text.at(exponent) == QLatin1Char('-')))
+                ++exponent;
+            if (isDigitAt(exponent)) {
+                end = exponent;
+                while (isDigitAt(end))
+                    ++end;
+            }
+        }
+        bool ok = false;
+        m_number = m_text.midRef(m_position, end - m_position).toDouble(&ok);
+        if (!ok)
+            return fail(m_position, QStringLiteral("invalid number")) >= 0;
+        m_position = end;
+        m_tokenType = NumberToken;
+        return true;
+    }
+
+    if (c == QLatin1Char('"') || c == QLatin1Char('\'')) {
+        int i = m_position + 1;
+        while (i < length && m_text.at(i) != c) {
+            QChar character = m_text.at(i++);
+            if (character == QLatin1Char('\\') && i < length) {
+                character = m_text.at(i++);
+                if (character == QLatin1Char('n'))
+                    character = QLatin1Char('\n');
+                else if (character == QLatin1Char('t'))
+                    character = QLatin1Char('\t');
+            }
+            m_token.append(character);
+        }
+        if (i == length)
+            return fail(m_position, QStringLiteral("unterminated string")) >= 0;
+        m_position = i + 1;
+        m_tokenType = StringToken;
+        return true;
+    }
+
+    const bool parameter = !m_javaScript && c == QLatin1Char('$');
+    if (isNameAt(m_position + (parameter ? 1 : 0), true)) {
+        int start = m_position + (parameter ? 1 : 0);
+        int end = start + 1;
+        while (isNameAt(end, false))
+            ++end;
+        m_token = m_text.mid(start, end - start);
+        m_position = end;
+        m_tokenType = parameter ? ParameterToken : NameToken;
+        return true;
+    }
+
+    // the JavaScript increments are only lexed to be rejected
+    static const char* const symbols[] = { "===", "!==", "&&", "||", "==", "!=", "<=", ">=", "++", "--",
+                                           "(", ")", "[", "]", ",", ".", ";", "!", "<", ">", "+", "-", "*", "/", "%" };
+    for (const char* symbol : symbols) {
+        const QLatin1String latin1Symbol(symbol);
+        if (m_text.midRef(m_position, latin1Symbol.size()) == latin1Symbol) {
+            m_token = latin1Symbol;
+            m_position += latin1Symbol.size();
+            m_tokenType = SymbolToken;
+            return true;
+        }
+    }
+    return fail(m_position, QStringLiteral("unexpected character '%1'").arg(c)) >= 0;
+}
+
+bool Query::Parser::isSymbol(const char* symbol) const
+{
+    return m_tokenType == SymbolToken && m_token == QLatin1String(symbol);
+}
+
+bool Query::Parser::isName(const char* name) const
+{
+    return m_tokenType == NameToken && m_token == QLatin1String(name);
+}
+
+bool Query::Parser::binaryOperator(int level, Operator& op) const
+{
+    struct BinaryOperator {
+        int level;
+        const char* token;
+        Operator op;
+    };
+    static const BinaryOperator operators[] = {
+        {OrLevel, "||", Or}, {AndLevel, "&&", And},
+        {ComparisonLevel, "==", Equal}, {ComparisonLevel, "!=", NotEqual},
+        {ComparisonLevel, "===", StrictEqual}, {ComparisonLevel, "!==", StrictNotEqual},
+        {ComparisonLevel, "<", Less}, {ComparisonLevel, "<=", LessOrEqual},
+        {ComparisonLevel, ">", Greater}, {ComparisonLevel, ">=", GreaterOrEqual},
+        {ComparisonLevel, "in", In}, {ComparisonLevel, "contains", Contains},
+        {ComparisonLevel, "startsWith", StartsWith}, {ComparisonLevel, "endsWith", EndsWith},
+        {AdditiveLevel, "+", Add}, {AdditiveLevel, "-", Subtract},
+        {MultiplicativeLevel, "*", Multiply}, {MultiplicativeLevel, "/", Divide}, {MultiplicativeLevel, "%", Modulo}
+    };
+    for (const BinaryOperator& binaryOperator : operators) {
+        if (binaryOperator.level == level && (isSymbol(binaryOperator.token) || (!m_javaScript && isName(binaryOperator.token)))) {
+            op = binaryOperator.op;
+            // the strict comparisons are aliases in queries, where the types of the operands are checked
+            if (!m_javaScript && (op == StrictEqual || op == StrictNotEqual))
+                op = op == StrictEqual ? Equal : NotEqual;
+            return true;
+        }
+    }
+    return false;
+}
+
+int Query::Parser::parseLevel(int level)
+{
+    if (level == UnaryLevel)
+        return parseUnary();
+
+    int left = parseLevel(level + 1);
+    Operator op;
+    while (left >= 0 && binaryOperator(level, op)) {
+        const int position = m_tokenPosition;
+        if (!lex())
+            return -1;
+        int right = parseLevel(level + 1);
+        if (right < 0)
+            return -1;
+        left = m_query.addNode(op, position, left, right);
+        if (op == Contains || op == StartsWith || op == EndsWith)
+            m_query.m_matchesText = true;
+        if (level == ComparisonLevel)
+            break;
+    }
+    return left;
+}
+
+int Query::Parser::parseUnary()
+{
+    const int position = m_tokenPosition;
+    if (isSymbol("!") || isSymbol("-")) {
+        const Operator op = isSymbol("!") ? Not : Negate;
+        if (!lex())
+            return -1;
+        int operand = parseUnary();
+        return operand < 0 ? -1 : m_query.addNode(op, position, operand);
+    }
+    return parseOperand();
+}
+
+int Query::Parser::parseOperand()
+{
+    const int position = m_tokenPosition;
+    int node = -1;
+    switch (m_tokenType) {
+    case NumberToken:
+        node = m_query.addNode(Constant, position);
+        m_query.m_nodes[node].value = m_number;
+        break;
+    case StringToken:
+        node = m_query.addNode(Constant, position);
+        m_query.m_nodes[node].value = m_token;
+        break;
+    case ParameterToken: {
+        node = m_query.addNode(Parameter, position);
+        int slot = m_query.m_parameterNames.indexOf(m_token);
+        if (slot < 0) {
+            slot = m_query.m_parameterNames.size();
+            m_query.m_parameterNames.append(m_token);
+            m_query.m_parameterValues.append(QVariant());
+        }
+        m_query.m_nodes[node].slot = slot;
+        break;
+    }
+    case NameToken:
+        if (isName("true") || isName("false") || isName("null") || (m_javaScript && isName("undefined"))) {
+            node = m_query.addNode(Constant, position);
+            if (isName("true") || isName("false"))
+                m_query.m_nodes[node].value = isName("true");
+            else if (m_javaScript && isName("null"))
+                m_query.m_nodes[node].value = QVariant::fromValue(nullptr);
+        } else if (m_javaScript) {
+            return parseJavaScriptName();
+        } else if (isName("in") || isName("contains") || isName("startsWith") || isName("endsWith")) {
+            return unexpected();
+        } else {
+            node = m_query.addNode(Role, position);
+            int slot = m_query.m_roleNames.indexOf(m_token);
+            if (slot < 0) {
+                slot = m_query.m_roleNames.size();
+                m_query.m_roleNames.append(m_token);
+            }
+            m_query.m_nodes[node].slot = slot;
+        }
+        break;
+    case SymbolToken:
+        if (isSymbol("(")) {
+            if (!lex())
+                return -1;
+            node = parseLevel(OrLevel);
+            if (node < 0)
+                return -1;
+            if (!isSymbol(")"))
+                return unexpected();
+        } else if (isSymbol("[") && !m_javaScript) {
+            node = parseList();
+            if (node < 0)
+                return -1;
+        } else {
+            return unexpected();
+        }
+        break;
+    case EndToken:
+        return unexpected();
+    }
+    return lex() ? node : -1;
+}
+
+/*
+    model.name and the bare names of roles read the row, the other names and their properties, like root.minimum,
+    are external values which don't depend on the row. Other uses of the row, like index or a property of a role, aren't supported.
+*/
+int Query::Parser::parseJavaScriptName()
+{
+    const int position = m_tokenPosition;
+    QStringList path { m_token };
+    if (!lex())
+        return -1;
+    while (isSymbol(".")) {
+        if (!lex())
+            return -1;
+        if (m_tokenType != NameToken)
+            return unexpected();
+        path.append(m_token);
+        if (!lex())
+            return -1;
+    }
+    if (isSymbol("(") || isSymbol("["))
+        return unexpected();
+
+    const QString& name = path.first();
+    const bool model = name == QLatin1String("model");
+    if ((model && path.size() == 2 && m_roleNames.contains(path.last())) || (path.size() == 1 && m_roleNames.contains(name))) {
+        const int node = m_query.addNode(Role, position);
+        int slot = m_query.m_roleNames.indexOf(path.last());
+        if (slot < 0) {
+            slot = m_query.m_roleNames.size();
+            m_query.m_roleNames.append(path.last());
+        }
+        m_query.m_nodes[node].slot = slot;
+        return node;
+    }
+    if (model || m_roleNames.contains(name) || name == QLatin1String("index")
+            || name == QLatin1String("modelLeft") || name == QLatin1String("modelRight"))
+        return fail(position, QStringLiteral("unsupported use of the row"));
+    if (name == QLatin1String("prepared"))
+        return fail(position, QStringLiteral("unsupported use of the prepared value"));
+
+    const int node = m_query.addNode(Parameter, position);
+    const QString externalName = path.join(QLatin1Char('.'));
+    int slot = m_query.m_parameterNames.indexOf(externalName);
+    if (slot < 0) {
+        slot = m_query.m_parameterNames.size();
+        m_query.m_parameterNames.append(externalName);
+        m_query.m_parameterValues.append(QVariant());
+    }
+    m_query.m_nodes[node].slot = slot;
+    return node;
+}
+
+// a list whose items are all constants is folded into a constant
+int Query::Parser::parseList()
+{
+    const int node = m_query.addNode(List, m_tokenPosition);
+    if (!lex())
+        return -1;
+    QVector<int> items;
+    while (!isSymbol("]")) {
+        if (!items.isEmpty()) {
+            if (!isSymbol(","))
+                return unexpected();
+            if (!lex())
+                return -1;
+        }
+        int item = parseLevel(OrLevel);
+        if (item < 0)
+            return -1;
+        items.append(item);
+    }
+
+    QVariantList values;
+    for (int item : items) {
+        if (m_query.m_nodes.at(item).op != Constant)
+            break;
+        values.append(m_query.m_nodes.at(item).value);
+    }
+    if (values.size() == items.size()) {
+        m_query.m_nodes[node].op = Constant;
+        m_query.m_nodes[node].value = values;
+    } else {
+        m_query.m_nodes[node].items = items;
+    }
+    return node;
+}
+
+int Query::Parser::unexpected()
+{
+    if (m_tokenType == EndToken)
+        return fail(m_tokenPosition, QStringLiteral("unexpected end of query"));
+    return fail(m_tokenPosition, QStringLiteral("unexpected '%1'").arg(m_text.mid(m_tokenPosition, m_position - m_tokenPosition)));
+}
+
+int Query::Parser::fail(int position, const QString& message)
+{
+    m_query.m_errorString = QStringLiteral("%1 at position %2").arg(message).arg(position);
+    return -1;
+}
+
+/*
+    Parses text, returns false and sets the error string if it isn't a valid query.
+    An empty query is valid and matches every row.
+    With the JavaScript syntax, roleNames are the names of the roles the expression can read.
+*/
+bool Query::parse(const QString& text, Syntax syntax, const QStringList& roleNames)
+{
+    m_syntax = syntax;
+    m_nodes.clear();
+    m_root = -1;
+    m_roleNames.clear();
+    m_parameterNames.clear();
+    m_parameterValues.clear();
+    m_errorString.clear();
+    m_matchesText = false;
+
+    Parser parser(text, roleNames, *this);
+    if (parser.parse())
+        return true;
+
+    m_nodes.clear();
+    m_root = -1;
+    m_roleNames.clear();
+    m_parameterNames.clear();
+    m_parameterValues.clear();
+    return false;
+}
+
+/*
+    Checks that the operators of the query are applied to operands of the right types, the types of the roles being those of their data in sourceIndex
+    (an invalid index only checks that the roles exist), and the types of the parameters those of their current values.
+    Returns false and sets the error string if they aren't.
+*/
+bool Query::check(const QModelIndex& sourceIndex, const QQmlSortFilterProxyModel& proxyModel)
+{
+    return checkRoot(sourceIndex, &proxyModel);
+}
+
+// checks the query without reading a row, the roles having any type
+bool Query::check()
+{
+    return checkRoot(QModelIndex(), nullptr);
+}
+
+bool Query::checkRoot(const QModelIndex& sourceIndex, const QQmlSortFilterProxyModel* proxyModel)
+{
+    m_errorString.clear();
+    if (m_root < 0)
+        return true;
+
+    Type type = checkNode(m_root, sourceIndex, proxyModel);
+    if (type == ErrorType)
+        return false;
+    // a JavaScript expression is converted to a boolean, or is the value of a role
+    if (m_syntax == QuerySyntax && type != BooleanType && type != AnyType) {
+        fail(m_root, QStringLiteral("the query is %1, not a condition").arg(typeName(type)));
+        return false;
+    }
+    return true;
+}
+
+const QString& Query::errorString() const
+{
+    return m_errorString;
+}
+
+bool Query::isEmpty() const
+{
+    return m_root < 0;
+}
+
+const QStringList& Query::roleNames() const
+{
+    return m_roleNames;
+}
+
+const QStringList& Query::parameterNames() const
+{
+    return m_parameterNames;
+}
+
+const QVariantList& Query::parameterValues() const
+{
+    return m_parameterValues;
+}
+
+// values coming from JavaScript, like arrays, are converted to their QVariant equivalent
+void Query::setParameterValue(int parameter, const QVariant& value)
+{
+    if (value.userType() == qMetaTypeId<QJSValue>())
+        m_parameterValues[parameter] = value.value<QJSValue>().toVariant();
+    else
+        m_parameterValues[parameter] = value;
+}
+
+// the case sensitivity of contains, startsWith and endsWith
+void Query::setCaseSensitivity(Qt::CaseSensitivity caseSensitivity)
+{
+    m_caseSensitivity = caseSensitivity;
+}
+
+// returns true if the query uses contains, startsWith or endsWith
+bool Query::matchesText() const
+{
+    return m_matchesText;
+}
+
+// a row whose data has the wrong type for an operator of the query syntax doesn't match, see hasTypeMismatch()
+bool Query::matches(const QModelIndex& sourceIndex, const QQmlSortFilterProxyModel& proxyModel) const
+{
+    m_unsupportedValue = false;
+    m_typeMismatch = false;
+    if (m_root < 0)
+        return true;
+    const bool result = truth(m_root, sourceIndex, proxyModel);
+    return result && !m_typeMismatch;
+}
+
+QVariant Query::evaluate(const QModelIndex& sourceIndex, const QQmlSortFilterProxyModel& proxyModel) const
+{
+    m_unsupportedValue = false;
+    m_typeMismatch = false;
+    return m_root < 0 ? QVariant() : value(m_root, sourceIndex, proxyModel);
+}
+
+/*
+    Returns true if the last row matched or evaluated with the JavaScript syntax had values that JavaScript converts as objects,
+    like dates or lists, which the query doesn't convert like it. The result is then meaningless, the row has to be evaluated with JavaScript.
+*/
+bool Query::hasUnsupportedValue() const
+{
+    return m_unsupportedValue;
+}
+
+/*
+    Returns true if the last row matched with the query syntax had data of a type that an operator doesn't accept,
+    like a string role compared to a number. The query is checked with the types of the constants and parameters only,
+    the types of the roles can differ from row to row.
+*/
+bool Query::hasTypeMismatch() const
+{
+    return m_typeMismatch;
+}
+
+/*
+    Sets the bits of the source rows that can match the query, found in the role indexes of the proxy model
+    from the comparisons of a role to a constant or a parameter, without testing every row.
+    Returns false if no part of the query restricting the rows can be answered by an index.
+    The candidate rows still have to be tested with matches().
+*/
+bool Query::candidateRows(const QQmlSortFilterProxyModel& proxyModel, QBitArray& rows) const
+{
+    return m_root >= 0 && nodeCandidateRows(m_root, proxyModel, rows);
+}
+
+int Query::addNode(Operator op, int position, int left, int right)
+{
+    Node node;
+    node.op = op;
+    node.position = position;
+    node.left = left;
+    node.right = right;
+    node.slot = -1;
+    m_nodes.append(node);
+    return m_nodes.size() - 1;
+}
+
+QVariant Query::value(int index, const QModelIndex& sourceIndex, const QQmlSortFilterProxyModel& proxyModel) const
+{
+    const Node& node = m_nodes.at(index);
+    switch (node.op) {
+    case Constant:
+        return node.value;
+    case Role:
+        return proxyModel.sourceData(sourceIndex, m_roleNames.at(node.slot));
+    case Parameter:
+        return m_parameterValues.at(node.slot);
+    case List: {
+        QVariantList list;
+        list.reserve(node.items.size());
+        for (int item : node.items)
+            list.append(value(item, sourceIndex, proxyModel));
+        return list;
+    }
+    case And:
+    case Or:
+        // like in JavaScript, the operand deciding the result is returned
+        if (m_syntax == JavaScriptSyntax) {
+            const QVariant left = value(node.left, sourceIndex, proxyModel);
+            if (javaScriptTruth(left) == (node.op == Or))
+                return left;
+            return value(node.right, sourceIndex, proxyModel);
+        }
+        return truth(index, sourceIndex, proxyModel);
+    case Not:
+        return truth(index, sourceIndex, proxyModel);
+    case Negate: {
+        // -x is -1 * x for every number, like -0 for 0
+        if (m_syntax == JavaScriptSyntax)
+            return javaScriptValue(Multiply, -1, value(node.left, sourceIndex, proxyModel));
+        const QVariant operand = value(node.left, sourceIndex, proxyModel);
+        if (operatorType(Negate, typeOf(operand), AnyType, nullptr) == ErrorType) {
+            m_typeMismatch = true;
+            return QVariant();
+        }
+        return -number(operand);
+    }
+    default:
+        break;
+    }
+
+    const QVariant left = value(node.left, sourceIndex, proxyModel);
+    const QVariant right = value(node.right, sourceIndex, proxyModel);
+    if (m_syntax == JavaScriptSyntax)
+        return javaScriptValue(node.op, left, right);
+    // the types of the roles are only known for each row, the operator is not applied to data of the wrong type
+    if (operatorType(node.op, typeOf(left), typeOf(right), nullptr) == ErrorType) {
+        m_typeMismatch = true;
+        return QVariant();
+    }
+    const bool ordered = left.isValid() && right.isValid();
+    switch (node.op) {
+    case Equal:
+        return equals(left, right);
+    case NotEqual:
+        return !equals(left, right);
+    case StrictEqual:
+        return typeOf(left) == typeOf(right) && equals(left, right);
+    case StrictNotEqual:
+        return typeOf(left) != typeOf(right) || !equals(left, right);
+    case Less:
+        return ordered && compare(left, right) < 0;
+    case LessOrEqual:
+        return ordered && compare(left, right) <= 0;
+    case Greater:
+        return ordered && compare(left, right) > 0;
+    case GreaterOrEqual:
+        return ordered && compare(left, right) >= 0;
+    case In:
+        if (typeOf(right) != ListType)
+            return false;
+        for (const QVariant& item : right.toList()) {
+            if (equals(left, item))
+                return true;
+        }
+        return false;
+    case Contains:
+        if (typeOf(left) == ListType) {
+            for (const QVariant& item : left.toList()) {
+                if (equals(item, right))
+                    return true;
+            }
+            return false;
+        }
+        return ordered && left.toString().contains(right.toString(), m_caseSensitivity);
+    case StartsWith:
+        return ordered && left.toString().startsWith(right.toString(), m_caseSensitivity);
+    case EndsWith:
+        return ordered && left.toString().endsWith(right.toString(), m_caseSensitivity);
+    case Add:
+        if (left.userType() == QMetaType::QString || right.userType() == QMetaType::QString)
+            return left.toString() + right.toString();
+        return number(left) + number(right);
+    case Subtract:
+        return number(left) - number(right);
+    case Multiply:
+        return number(left) * number(right);
+    case Divide:
+        return number(left) / number(right);
+    case Modulo:
+        return std::fmod(number(left), number(right));
+    default:
+        return QVariant();
+    }
+}
+
+// the logical operators are evaluated without building intermediate QVariants, values are converted like in JavaScript
+bool Query::truth(int index, const QModelIndex& sourceIndex, const QQmlSortFilterProxyModel& proxyModel) const
+{
+    const Node& node = m_nodes.at(index);
+    switch (node.op) {
+    case Not:
+        return !truth(node.left, sourceIndex, proxyModel);
+    case And:
+        return truth(node.left, sourceIndex, proxyModel) && truth(node.right, sourceIndex, proxyModel);
+    case Or:
+        return truth(node.left, sourceIndex, proxyModel) || truth(node.right, sourceIndex, proxyModel);
+    default:
+        break;
+    }
+
+    const QVariant result = value(index, sourceIndex, proxyModel);
+    if (m_syntax == JavaScriptSyntax)
+        return javaScriptTruth(result);
+    // the logical operators and the query itself expect booleans
+    if (!m_typeMismatch && operatorType(Not, typeOf(result), AnyType, nullptr) == ErrorType)
+        m_typeMismatch = true;
+    return !m_typeMismatch && truthValue(result);
+}
+
+/*
+    Applies a binary operator of the JavaScript syntax, converting the operands like JavaScript:
+    == converts booleans and strings compared to numbers, the comparisons and arithmetic operators convert to numbers unless both operands,
+    or one for +, are strings. JavaScript converts objects with their own methods and compares them by identity, these aren't evaluated.
+*/
+QVariant Query::javaScriptValue(Operator op, const QVariant& left, const QVariant& right) const
+{
+    const JavaScriptType leftType = javaScriptType(left);
+    const JavaScriptType rightType = javaScriptType(right);
+    const bool leftMissing = leftType == JavaScriptType::Undefined || leftType == JavaScriptType::Null;
+    const bool rightMissing = rightType == JavaScriptType::Undefined || rightType == JavaScriptType::Null;
+    const bool objects = leftType == JavaScriptType::Object || rightType == JavaScriptType::Object;
+
+    switch (op) {
+    case StrictEqual:
+    case StrictNotEqual:
+        if (leftType != rightType)
+            return op == StrictNotEqual;
+        if (objects)
+            break;
+        return strictEquals(leftType, left, right) == (op == StrictEqual);
+    case Equal:
+    case NotEqual:
+        // undefined and null are only equal to each other
+        if (leftMissing || rightMissing)
+            return (leftMissing && rightMissing) == (op == Equal);
+        if (objects)
+            break;
+        if (leftType == rightType)
+            return strictEquals(leftType, left, right) == (op == Equal);
+        return (javaScriptNumber(left) == javaScriptNumber(right)) == (op == Equal);
+    case Less:
+    case LessOrEqual:
+    case Greater:
+    case GreaterOrEqual: {
+        if (objects)
+            break;
+        int comparison;
+        if (leftType == JavaScriptType::String && rightType == JavaScriptType::String) {
+            comparison = QString::compare(*static_cast<const QString*>(left.constData()), *static_cast<const QString*>(right.constData()));
+        } else {
+            const double leftNumber = javaScriptNumber(left);
+            const double rightNumber = javaScriptNumber(right);
+            if (qIsNaN(leftNumber) || qIsNaN(rightNumber))
+                return false;
+            comparison = leftNumber < rightNumber ? -1 : (rightNumber < leftNumber ? 1 : 0);
+        }
+        switch (op) {
+        case Less:
+            return comparison < 0;
+        case LessOrEqual:
+            return comparison <= 0;
+        case Greater:
+            return comparison > 0;
+        default:
+            return comparison >= 0;
+        }
+    }
+    case Add:
+        if (objects)
+            break;
+        if (leftType == JavaScriptType::String || rightType == JavaScriptType::String)
+            return javaScriptString(left) + javaScriptString(right);
+        return numberValue(javaScriptNumber(left) + javaScriptNumber(right));
+    case Subtract:
+    case Multiply:
+    case Divide:
+    case Modulo: {
+        if (objects)
+            break;
+        const double leftNumber = javaScriptNumber(left);
+        const double rightNumber = javaScriptNumber(right);
+        switch (op) {
+        case Subtract:
+            return numberValue(leftNumber - rightNumber);
+        case Multiply:
+            return numberValue(leftNumber * rightNumber);
+        case Divide:
+            return numberValue(leftNumber / rightNumber);
+        default:
+            return numberValue(std::fmod(leftNumber, rightNumber));
+        }
+    }
+    default:
+        return QVariant();
+    }
+    m_unsupportedValue = true;
+    return QVariant();
+}
+
+// converts a value to a boolean like JavaScript, the values that are objects in JavaScript, or numbers of other types, aren't converted
+bool Query::javaScriptTruth(const QVariant& value) const
+{
+    switch (javaScriptType(value)) {
+    case JavaScriptType::Undefined:
+    case JavaScriptType::Null:
+        return false;
+    case JavaScriptType::Object:
+        m_unsupportedValue = true;
+        return false;
+    default:
+        return truthValue(value);
+    }
+}
+
+int Query::compare(const QVariant& left, const QVariant& right) const
+{
+    if (typeOf(left) == NumberType && typeOf(right) == NumberType) {
+        double leftNumber = left.toDouble();
+        double rightNumber = right.toDouble();
+        return leftNumber < rightNumber ? -1 : (rightNumber < leftNumber ? 1 : 0);
+    }
+    return m_comparator.compare(left, right);
+}
+
+bool Query::rowIndependentValue(int index, QVariant& value) const
+{
+    const Node& node = m_nodes.at(index);
+    if (node.op == Constant)
+        value = node.value;
+    else if (node.op == Parameter)
+        value = m_parameterValues.at(node.slot);
+    else
+        return false;
+    return value.isValid();
+}
+
+bool Query::nodeCandidateRows(int index, const QQmlSortFilterProxyModel& proxyModel, QBitArray& rows) const
+{
+    const Node& node = m_nodes.at(index);
+    if (node.op == And) {
+        // the rows matching both operands are among the candidates of either
+        QBitArray rightRows;
+        const bool hasLeft = nodeCandidateRows(node.left, proxyModel, rows);
+        const bool hasRight = nodeCandidateRows(node.right, proxyModel, hasLeft ? rightRows : rows);
+        if (hasLeft && hasRight)
+            rows &= rightRows;
+        return hasLeft || hasRight;
+    }
+    if (node.op == Or) {
+        QBitArray rightRows;
+        if (!nodeCandidateRows(node.left, proxyModel, rows) || !nodeCandidateRows(node.right, proxyModel, rightRows))
+            return false;
+        rows |= rightRows;
+        return true;
+    }
+    if (node.left < 0 || node.right < 0)
+        return false;
+
+    // a role compared to a constant or a parameter, the role being on the left
+    Operator op = node.op;
+    int roleNode = node.left;
+    int valueNode = node.right;
+    if (m_nodes.at(roleNode).op != Role) {
+        qSwap(roleNode, valueNode);
+        switch (op) {
+        case Less: op = Greater; break;
+        case LessOrEqual: op = GreaterOrEqual; break;
+        case Greater: op = Less; break;
+        case GreaterOrEqual: op = LessOrEqual; break;
+        case Equal: break;
+        default: return false;
+        }
+    }
+    QVariant value;
+    if (m_nodes.at(roleNode).op != Role || !rowIndependentValue(valueNode, value))
+        return false;
+
+    const QString& roleName = m_roleNames.at(m_nodes.at(roleNode).slot);
+    const QAbstractItemModel& sourceModel = *proxyModel.sourceModel();
+    switch (op) {
+    case Equal:
+    case In: {
+        HashRoleIndex* roleIndex = proxyModel.hashIndex(roleName);
+        if (!roleIndex || (op == In && typeOf(value) != ListType))
+            return false;
+        const QVariantList values = op == In ? value.toList() : QVariantList { value };
+        for (const QVariant& item : values) {
+            if (!roleIndex->canFind(item, sourceModel))
+                return false;
+        }
+        rows.fill(false, sourceModel.rowCount());
+        for (const QVariant& item : values) {
+            for (int row : roleIndex->sourceRows(HashRoleIndex::key(item), sourceModel))
+                rows.setBit(row);
+        }
+        return true;
+    }
+    case Less:
+    case LessOrEqual:
+    case Greater:
+    case GreaterOrEqual: {
+        OrderedRoleIndex* roleIndex = proxyModel.orderedIndex(roleName);
+        if (!roleIndex)
+            return false;
+        if (op == Less || op == LessOrEqual)
+            return roleIndex->rangeSourceRows(sourceModel, QVariant(), false, value, op == LessOrEqual, rows);
+        return roleIndex->rangeSourceRows(sourceModel, value, op == GreaterOrEqual, QVariant(), false, rows);
+    }
+    case StartsWith: {
+        OrderedRoleIndex* roleIndex = proxyModel.orderedIndex(roleName);
+        return roleIndex && m_caseSensitivity == Qt::CaseSensitive && value.userType() == QMetaType::QString
+               && roleIndex->prefixSourceRows(sourceModel, value.toString(), rows);
+    }
+    default:
+        return false;
+    }
+}
+
+Query::Type Query::checkNode(int index, const QModelIndex& sourceIndex, const QQmlSortFilterProxyModel* proxyModel)
+{
+    const Node node = m_nodes.at(index);
+    switch (node.op) {
+    case Constant:
+        return typeOf(node.value);
+    case Role: {
+        const QString& roleName = m_roleNames.at(node.slot);
+        if (!proxyModel)
+            return AnyType;
+        if (proxyModel->roleNames().key(roleName.toUtf8(), -1) == -1)
+            return fail(index, QStringLiteral("unknown role '%1'").arg(roleName));
+        return sourceIndex.isValid() ? typeOf(proxyModel->sourceData(sourceIndex, roleName)) : AnyType;
+    }
+    case Parameter:
+        return typeOf(m_parameterValues.at(node.slot));
+    case List:
+        for (int item : node.items) {
+            if (checkNode(item, sourceIndex, proxyModel) == ErrorType)
+                return ErrorType;
+        }
+        return ListType;
+    default:
+        break;
+    }
+
+    const Type left = checkNode(node.left, sourceIndex, proxyModel);
+    if (left == ErrorType)
+        return ErrorType;
+    Type right = AnyType;
+    if (node.right >= 0) {
+        right = checkNode(node.right, sourceIndex, proxyModel);
+        if (right == ErrorType)
+            return ErrorType;
+    }
+
+    // JavaScript converts the operands of its operators, the types of the roles are only known for each row
+    if (m_syntax == JavaScriptSyntax) {
+        switch (node.op) {
+        case Not:
+            return BooleanType;
+        case And:
+        case Or:
+            // JavaScript's && and || return one of their operands
+            return left == right ? left : AnyType;
+        case Add:
+            if (left == StringType || right == StringType)
+                return StringType;
+            return left == NumberType && right == NumberType ? NumberType : AnyType;
+        case Negate:
+        case Subtract:
+        case Multiply:
+        case Divide:
+        case Modulo:
+            return NumberType;
+        default:
+            return BooleanType;
+        }
+    }
+
+    QString message;
+    const Type type = operatorType(node.op, left, right, &message);
+    return type == ErrorType ? fail(index, message) : type;
+}
+
+/*
+    Returns the type of the result of an operator of the query syntax applied to operands of the given types,
+    or ErrorType with the reason in message, if it isn't null, when the operator can't be applied to them.
+*/
+Query::Type Query::operatorType(Operator op, Type left, Type right, QString* message)
+{
+    // values of unknown types, like invalid data or dates, are accepted by every operator
+    auto is = [] (Type type, Type expected) { return type == AnyType || type == expected; };
+    static const char* const operatorNames[] = {
+        "", "", "", "", "!", "-", "&&", "||", "==", "!=", "===", "!==", "<", "<=", ">", ">=", "in", "contains", "startsWith", "endsWith", "+", "-", "*", "/", "%"
+    };
+    const QLatin1String operatorName(operatorNames[op]);
+
+    switch (op) {
+    case Not:
+    case And:
+    case Or:
+        if (is(left, BooleanType) && is(right, BooleanType))
+            return BooleanType;
+        if (message)
+            *message = QStringLiteral("'%1' expects booleans, not %2").arg(QString(operatorName), typeName(is(left, BooleanType) ? right : left));
+        return ErrorType;
+    case StrictEqual:
+    case StrictNotEqual:
+        return BooleanType;
+    case Equal:
+    case NotEqual:
+    case Less:
+    case LessOrEqual:
+    case Greater:
+    case GreaterOrEqual: {
+        const bool ordering = op != Equal && op != NotEqual;
+        if (ordering && (left == BooleanType || left == ListType || right == BooleanType || right == ListType)) {
+            if (message)
+                *message = QStringLiteral("'%1' can't order %2").arg(QString(operatorName), typeName(left == BooleanType || left == ListType ? left : right));
+            return ErrorType;
+        }
+        if (left != AnyType && right != AnyType && left != right) {
+            if (message)
+                *message = QStringLiteral("'%1' can't compare %2 with %3").arg(QString(operatorName), typeName(left), typeName(right));
+            return ErrorType;
+        }
+        return BooleanType;
+    }
+    case In:
+        if (is(right, ListType))
+            return BooleanType;
+        if (message)
+            *message = QStringLiteral("'in' expects a list, not %1").arg(typeName(right));
+        return ErrorType;
+    case Contains:
+    case StartsWith:
+    case EndsWith:
+        if ((op == Contains && left == ListType) || (is(left, StringType) && is(right, StringType)))
+            return BooleanType;
+        if (message)
+            *message = QStringLiteral("'%1' expects strings, not %2").arg(QString(operatorName), typeName(is(left, StringType) ? right : left));
+        return ErrorType;
+    default:
+        if (op == Add && (left == StringType || right == StringType))
+            return StringType;
+        if (is(left, NumberType) && is(right, NumberType))
+            return NumberType;
+        if (message)
+            *message = QStringLiteral("'%1' expects numbers, not %2").arg(QString(operatorName), typeName(is(left, NumberType) ? right : left));
+        return ErrorType;
+    }
+}
+
+Query::Type Query::fail(int node, const QString& message)
+{
+    m_errorString = QStringLiteral("%1 at position %2").arg(message).arg(m_nodes.at(node).position);
+    return ErrorType;
+}
+
+Query::Type Query::typeOf(const QVariant& value)
+{
+    switch (value.userType()) {
+    case QMetaType::Bool:
+        return BooleanType;
+    case QMetaType::Int:
+    case QMetaType::UInt:
+    case QMetaType::LongLong:
+    case QMetaType::ULongLong:
+    case QMetaType::Double:
+    case QMetaType::Float:
+        return NumberType;
+    case QMetaType::QString:
+        return StringType;
+    case QMetaType::QVariantList:
+    case QMetaType::QStringList:
+        return ListType;
+    default:
+        return AnyType;
+    }
+}
+
+QString Query::typeName(Type type)
+{
+    switch (type) {
+    case BooleanType:
+        return QStringLiteral("a boolean");
+    case NumberType:
+        return QStringLiteral("a number");
+    case StringType:
+        return QStringLiteral("a string");
+    case ListType:
+        return QStringLiteral("a list");
+    default:
+        return QStringLiteral("a value");
+    }
+}
+
+bool Query::truthValue(const QVariant& value)
+{
+    switch (typeOf(value)) {
+    case BooleanType:
+        return value.toBool();
+    case NumberType: {
+        double number = value.toDouble();
+        return number != 0 && !qIsNaN(number);
+    }
+    case StringType:
+        return !static_cast<const QString*>(value.constData())->isEmpty();
+    default:
+        return value.isValid();
+    }
+}
+
+// converts value like JavaScript's Number(), invalid values and strings that aren't numbers being NaN
+double Query::number(const QVariant& value)
+{
+    if (value.userType() == QMetaType::Bool)
+        return value.toBool() ? 1 : 0;
+    bool ok = false;
+    double result = value.toDouble(&ok);
+    return ok ? result : qQNaN();
+}
+
+// numbers are equal whatever their types, like 1 and 1.0
+bool Query::equals(const QVariant& left, const QVariant& right)
+{
+    if (typeOf(left) == NumberType && typeOf(right) == NumberType)
+        return left.toDouble() == right.toDouble();
+    return left == right;
+}
+
+}
@@ -0,0 +1,107 @@
+#ifndef QUERY_H
+#define QUERY_H
+
+#include <QVariant>
+#include <QVector>
+#include <QStringList>
+#include "utils/variantcomparator.h"
+
+class QBitArray;
+
+namespace qqsfpm {
+
+class QQmlSortFilterProxyModel;
+
+/*
+    A predicate on the roles of a row, written in a small expression language (see QueryFilter for its syntax).
+    The query is parsed once into a tree of nodes, checked against the types of the roles of a row,
+    then evaluated natively for each row, reading the roles through the proxy model.
+
+    With the JavaScript syntax, the text is a JavaScript expression of an ExpressionFilter or an ExpressionRole
+    in the subset that the query nodes evaluate like the JavaScript engine (see NativeExpression).
+*/
+class Query
+{
+public:
+    enum Syntax { QuerySyntax, JavaScriptSyntax };
+
+    bool parse(const QString& text, Syntax syntax = QuerySyntax, const QStringList& roleNames = QStringList());
+    bool check(const QModelIndex& sourceIndex, const QQmlSortFilterProxyModel& proxyModel);
+    bool check();
+    const QString& errorString() const;
+    bool isEmpty() const;
+
+    const QStringList& roleNames() const;
+    const QStringList& parameterNames() const;
+    const QVariantList& parameterValues() const;
+    void setParameterValue(int parameter, const QVariant& value);
+    void setCaseSensitivity(Qt::CaseSensitivity caseSensitivity);
+    bool matchesText() const;
+
+    bool matches(const QModelIndex& sourceIndex, const QQmlSortFilterProxyModel& proxyModel) const;
+    QVariant evaluate(const QModelIndex& sourceIndex, const QQmlSortFilterProxyModel& proxyModel) const;
+    bool hasUnsupportedValue() const;
+    bool hasTypeMismatch() const;
+    bool candidateRows(const QQmlSortFilterProxyModel& proxyModel, QBitArray& rows) const;
+
+private:
+    class Parser;
+    friend class Parser;
+
+    enum Operator {
+        Constant, Role, Parameter, List,
+        Not, Negate, And, Or,
+        Equal, NotEqual, StrictEqual, StrictNotEqual, Less, LessOrEqual, Greater, GreaterOrEqual,
+        In, Contains, StartsWith, EndsWith,
+        Add, Subtract, Multiply, Divide, Modulo
+    };
+
+    enum Type { ErrorType = -1, AnyType, BooleanType, NumberType, StringType, ListType };
+
+    struct Node {
+        Operator op;
+        int position;    // in the query text, for error messages
+        int left;        // the operands, -1 when unused
+        int right;
+        int slot;        // the index of a role or parameter name
+        QVariant value;  // a constant
+        QVector<int> items;
+    };
+
+    int addNode(Operator op, int position, int left = -1, int right = -1);
+    QVariant value(int node, const QModelIndex& sourceIndex, const QQmlSortFilterProxyModel& proxyModel) const;
+    bool truth(int node, const QModelIndex& sourceIndex, const QQmlSortFilterProxyModel& proxyModel) const;
+    int compare(const QVariant& left, const QVariant& right) const;
+    QVariant javaScriptValue(Operator op, const QVariant& left, const QVariant& right) const;
+    bool javaScriptTruth(const QVariant& value) const;
+    bool rowIndependentValue(int node, QVariant& value) const;
+    bool nodeCandidateRows(int node, const QQmlSortFilterProxyModel& proxyModel, QBitArray& rows) const;
+    bool checkRoot(const QModelIndex& sourceIndex, const QQmlSortFilterProxyModel* proxyModel);
+    Type checkNode(int node, const QModelIndex& sourceIndex, const QQmlSortFilterProxyModel* proxyModel);
+    Type fail(int node, const QString& message);
+
+    static Type operatorType(Operator op, Type left, Type right, QString* message);
+
+    static Type typeOf(const QVariant& value);
+    static QString typeName(Type type);
+    static bool equals(const QVariant& left, const QVariant& right);
+    static bool truthValue(const QVariant& value);
+    static double number(const QVariant& value);
+
+    Syntax m_syntax = QuerySyntax;
+    QVector<Node> m_nodes;
+    int m_root = -1;
+    QStringList m_roleNames;
+    QStringList m_parameterNames;
+    QVariantList m_parameterValues;
+    QString m_errorString;
+    Qt::CaseSensitivity m_caseSensitivity = Qt::CaseSensitive;
+    bool m_matchesText = false;
+    mutable bool m_unsupportedValue = false;
+    mutable bool m_typeMismatch = false;
+    VariantComparator m_comparator;
+};
+
+}
+
+#endif // QUERY_H
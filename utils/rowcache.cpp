@@ -0,0 +1,30 @@
+#include "rowcache.h"
+
+namespace qqsfpm {
+
+// a scope nested in an active one, for the same row or another, leaves the cache to the outer scope
+RowCache::Scope::Scope(RowCache& cache, const QModelIndex& index) :
+    m_cache(cache.m_active ? nullptr : &cache)
+{
+    if (!m_cache)
+        return;
+    m_cache->m_active = true;
+    m_cache->m_index = index;
+}
+
+RowCache::Scope::~Scope()
+{
+    if (!m_cache)
+        return;
+    m_cache->m_active = false;
+    m_cache->m_index = QModelIndex();
+    m_cache->m_values.resize(0);
+}
+
+// forgets the values read so far, for when the source data changes while a row is evaluated
+void RowCache::clear()
+{
+    m_values.resize(0);
+}
+
+}
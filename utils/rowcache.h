@@ -0,0 +1,68 @@
+#ifndef ROWCACHE_H
+#define ROWCACHE_H
+
+#include <QModelIndex>
+#include <QVariant>
+#include <QVarLengthArray>
+#include <QPair>
+
+namespace qqsfpm {
+
+/*
+    Memoizes the data of the source row being evaluated, so that the filters, sorters and proxy roles
+    reading the same role of a row fetch it once from the source model, or compute it once for a proxy role.
+    The cache only holds values inside a Scope, and is emptied when the outermost scope ends.
+*/
+class RowCache
+{
+public:
+    class Scope
+    {
+    public:
+        Scope(RowCache& cache, const QModelIndex& index);
+        ~Scope();
+
+    private:
+        RowCache* m_cache;
+    };
+
+    bool lookup(const QModelIndex& index, int role, QVariant& value) const;
+    void store(const QModelIndex& index, int role, const QVariant& value);
+    void clear();
+
+private:
+    bool m_active = false;
+    QModelIndex m_index;
+    // a row has a few roles, a linear search is faster than hashing them
+    QVarLengthArray<QPair<int, QVariant>, 16> m_values;
+};
+
+inline bool RowCache::lookup(const QModelIndex& index, int role, QVariant& value) const
+{
+    if (Q_LIKELY(!m_active) || index != m_index)
+        return false;
+    for (const QPair<int, QVariant>& entry : m_values) {
+        if (entry.first == role) {
+            value = entry.second;
+            return true;
+        }
+    }
+    return false;
+}
+
+inline void RowCache::store(const QModelIndex& index, int role, const QVariant& value)
+{
+    if (Q_LIKELY(!m_active) || index != m_index)
+        return;
+    for (QPair<int, QVariant>& entry : m_values) {
+        if (entry.first == role) {
+            entry.second = value;
+            return;
+        }
+    }
+    m_values.append(qMakePair(role, value));
+}
+
+}
+
+#endif // ROWCACHE_H
@@ -0,0 +1,158 @@
+#include "sortkey.h"
+#include <QVariant>
+#include <QDateTime>
+#include <QtEndian>
+#include <qnumeric.h>
+#include <cstring>
+
+namespace qqsfpm {
+
+namespace {
+
+// the first byte of each encoded value, values with different tags can't be compared
+enum Tag : char {
+    InvalidTag = 0x01,
+    FlagTag = 0x02,
+    BoolTag = 0x03,
+    SignedTag = 0x04,
+    UnsignedTag = 0x05,
+    DoubleTag = 0x06,
+    StringTag = 0x07,
+    DateTimeTag = 0x08
+};
+
+void appendUInt64(QByteArray& key, quint64 value)
+{
+    uchar bytes[sizeof(quint64)];
+    qToBigEndian(value, bytes);
+    key.append(reinterpret_cast<const char*>(bytes), sizeof(bytes));
+}
+
+void appendInt64(QByteArray& key, qint64 value)
+{
+    // flipping the sign bit makes negative numbers sort before positive ones
+    appendUInt64(key, static_cast<quint64>(value) ^ (Q_UINT64_C(1) << 63));
+}
+
+void appendDouble(QByteArray& key, double value)
+{
+    if (value == 0)
+        value = 0; // -0.0 compares equal to 0.0
+    quint64 bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    // positive numbers get their sign bit set, negative ones are fully inverted so that bigger magnitudes sort first
+    bits = (bits & (Q_UINT64_C(1) << 63)) ? ~bits : bits | (Q_UINT64_C(1) << 63);
+    appendUInt64(key, bits);
+}
+
+/*
+    Each UTF-16 code unit is encoded with 1 to 3 bytes whose first byte tells the length,
+    preserving the order of code units (that of QString::compare()).
+    The string is terminated by two null bytes, lower than any encoded code unit,
+    so that a string sorts before the strings it is a prefix of and the encoding stays prefix free.
+*/
+void appendString(QByteArray& key, const QString& string)
+{
+    key.reserve(key.size() + string.size() + 2);
+    for (QChar c : string) {
+        ushort unit = c.unicode();
+        if (unit == 0) {
+            key.append('\0');
+            key.append('\1');
+        } else if (unit < 0x80) {
+            key.append(static_cast<char>(unit));
+        } else if (unit < 0x4000) {
+            key.append(static_cast<char>(0x80 | (unit >> 8)));
+            key.append(static_cast<char>(unit & 0xFF));
+        } else {
+            key.append(static_cast<char>(0xC0));
+            key.append(static_cast<char>(unit >> 8));
+            key.append(static_cast<char>(unit & 0xFF));
+        }
+    }
+    key.append('\0');
+    key.append('\0');
+}
+
+}
+
+/*
+    Builds sort keys: byte arrays which compare with memcmp() like the values encoded in them.
+    Each encoded value starts with a tag byte identifying its type, and is prefix free,
+    so that several values can be concatenated and the order of a value can be reversed by inverting its bytes.
+*/
+bool SortKey::appendValue(QByteArray& key, const QVariant& value)
+{
+    switch (value.userType()) {
+    case QMetaType::UnknownType:
+        key.append(InvalidTag);
+        return true;
+    case QMetaType::Bool:
+        key.append(BoolTag);
+        key.append(value.toBool() ? '\1' : '\0');
+        return true;
+    case QMetaType::Int:
+    case QMetaType::LongLong:
+        key.append(SignedTag);
+        appendInt64(key, value.toLongLong());
+        return true;
+    case QMetaType::UInt:
+    case QMetaType::ULongLong:
+        key.append(UnsignedTag);
+        appendUInt64(key, value.toULongLong());
+        return true;
+    case QMetaType::Float:
+    case QMetaType::Double: {
+        double number = value.toDouble();
+        if (qIsNaN(number))
+            return false;
+        key.append(DoubleTag);
+        appendDouble(key, number);
+        return true;
+    }
+    case QMetaType::QString:
+        key.append(StringTag);
+        appendString(key, value.toString());
+        return true;
+    case QMetaType::QDateTime: {
+        QDateTime dateTime = value.toDateTime();
+        if (!dateTime.isValid())
+            return false;
+        key.append(DateTimeTag);
+        appendInt64(key, dateTime.toMSecsSinceEpoch());
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+void SortKey::appendFlag(QByteArray& key, bool flag)
+{
+    key.append(FlagTag);
+    key.append(flag ? '\1' : '\0');
+}
+
+void SortKey::appendRow(QByteArray& key, int row)
+{
+    uchar bytes[sizeof(quint32)];
+    qToBigEndian(static_cast<quint32>(row), bytes);
+    key.append(reinterpret_cast<const char*>(bytes), sizeof(bytes));
+}
+
+void SortKey::invert(QByteArray& key, int from)
+{
+    char* data = key.data();
+    for (int i = from, size = key.size(); i < size; ++i)
+        data[i] = ~data[i];
+}
+
+int SortKey::compare(const char* left, int leftSize, const char* right, int rightSize)
+{
+    int comparison = std::memcmp(left, right, qMin(leftSize, rightSize));
+    if (comparison != 0)
+        return comparison;
+    return leftSize - rightSize;
+}
+
+}
@@ -0,0 +1,22 @@
+#ifndef SORTKEY_H
+#define SORTKEY_H
+
+#include <QByteArray>
+
+class QVariant;
+
+namespace qqsfpm {
+
+class SortKey
+{
+public:
+    static bool appendValue(QByteArray& key, const QVariant& value);
+    static void appendFlag(QByteArray& key, bool flag);
+    static void appendRow(QByteArray& key, int row);
+    static void invert(QByteArray& key, int from);
+    static int compare(const char* left, int leftSize, const char* right, int rightSize);
+};
+
+}
+
+#endif // SORTKEY_H
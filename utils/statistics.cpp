@@ -0,0 +1,340 @@
+#include "statistics.h"
+#include "utils/plan.h"
+#include <QAbstractItemModel>
+
+namespace qqsfpm {
+
+namespace {
+
+double milliseconds(qint64 nsecs)
+{
+    return nsecs / 1000000.0;
+}
+
+// the name of the QML type of an object, followed by its objectName if it has one
+QString displayName(const QObject* object)
+{
+    QString name = Plan::qmlTypeName(object);
+    if (!object->objectName().isEmpty())
+        name += QStringLiteral(" (%1)").arg(object->objectName());
+    return name;
+}
+
+}
+
+/*!
+    \qmltype Statistics
+    \inqmlmodule SortFilterProxyModel
+    \ingroup SortFilterProxyModel
+    \brief Measures the work done by the filters, sorters and proxy roles of a \l SortFilterProxyModel.
+
+    A Statistics object can't be created, each \l SortFilterProxyModel has one in its \l {SortFilterProxyModel::statistics} {statistics} property.
+    It collects nothing until it is \l enabled.
+
+    In the following example, the statistics of a model are printed after some time:
+
+    \code
+    SortFilterProxyModel {
+       id: proxyModel
+       sourceModel: contactModel
+       statistics.enabled: true
+       filters: RegExpFilter { roleName: "name"; pattern: searchField.text }
+    }
+
+    Timer {
+        interval: 10000
+        running: true
+        onTriggered: console.log(JSON.stringify(proxyModel.statistics.report(), null, 2))
+    }
+    \endcode
+*/
+Statistics::Statistics(QAbstractItemModel* model) :
+    QObject(model),
+    m_model(model)
+{
+}
+
+/*!
+    \qmlproperty bool Statistics::enabled
+
+    This property holds whether the statistics are collected.
+    Collecting them times each evaluation of a filter, sorter or proxy role, which slows the model down.
+    Disabling them keeps the statistics collected so far.
+
+    By default, statistics are disabled.
+*/
+void Statistics::setEnabled(bool enabled)
+{
+    if (m_enabled == enabled)
+        return;
+
+    m_enabled = enabled;
+    Q_EMIT enabledChanged();
+}
+
+/*!
+    \qmlmethod Statistics::reset()
+
+    Clears the statistics collected so far.
+*/
+void Statistics::reset()
+{
+    m_filters = EvaluationTable();
+    m_sorters = EvaluationTable();
+    m_proxyRoles = EvaluationTable();
+    for (Invalidations& invalidations : m_invalidations)
+        invalidations = Invalidations();
+    m_comparisons = 0;
+    m_sourceDataCalls.clear();
+}
+
+/*!
+    \qmlmethod list Statistics::filters()
+
+    Returns the statistics of the top level filters of the model, as a list of objects with the following properties:
+    \list
+    \li \c name: the type of the filter, followed by its \c objectName if it has one
+    \li \c evaluations: the number of rows the filter tested
+    \li \c accepted: the number of rows the filter accepted
+    \li \c selectivity: the ratio of accepted rows, between 0 and 1
+    \li \c totalTime: the cumulated time spent in the filter, in milliseconds
+    \li \c maxTime: the longest time spent testing a single row, in milliseconds
+    \endlist
+
+    The rows a filter finds without testing them, from a role index or the cached results of previous filterings, are not counted.
+*/
+QVariantList Statistics::filters() const
+{
+    return m_filters.toList(true);
+}
+
+/*!
+    \qmlmethod list Statistics::sorters()
+
+    Returns the statistics of the sorters of the model, as a list of objects with the same properties as \l filters() except \c accepted and \c selectivity.
+    The evaluations of a sorter are the comparisons of two rows and the computations of the sort key of a row.
+*/
+QVariantList Statistics::sorters() const
+{
+    return m_sorters.toList(false);
+}
+
+/*!
+    \qmlmethod list Statistics::proxyRoles()
+
+    Returns the statistics of the proxy roles of the model, as a list of objects with the same properties as \l sorters().
+    The evaluations of a proxy role are the reads of its data.
+*/
+QVariantList Statistics::proxyRoles() const
+{
+    return m_proxyRoles.toList(false);
+}
+
+/*!
+    \qmlmethod object Statistics::invalidations()
+
+    Returns the statistics of the invalidations of the model, with a \c filter, a \c sort and a \c proxyRole property.
+    The \c sort invalidations filter and sort the model again, the \c filter ones only filter it again
+    and the \c proxyRole ones notify the views that the proxy roles changed.
+    Each of them is an object with the following properties:
+    \list
+    \li \c count: the number of invalidations
+    \li \c totalTime: their cumulated time, in milliseconds
+    \li \c maxTime: the time of the longest one, in milliseconds
+    \li \c comparisons: the number of comparisons of rows they made
+    \li \c lastComparisons: the number of comparisons of rows made by the last one
+    \endlist
+
+    The returned object also has a \c comparisons property with the total number of comparisons of rows,
+    including those made outside invalidations, when rows are inserted or changed in the source model.
+*/
+QVariantMap Statistics::invalidations() const
+{
+    static const char* const names[] = { "filter", "sort", "proxyRole" };
+    QVariantMap map;
+    for (int type = FilterInvalidation; type <= ProxyRoleInvalidation; ++type) {
+        const Invalidations& invalidations = m_invalidations[type];
+        map.insert(QString::fromLatin1(names[type]), QVariantMap {
+            {QStringLiteral("count"), invalidations.count},
+            {QStringLiteral("totalTime"), milliseconds(invalidations.totalNsecs)},
+            {QStringLiteral("maxTime"), milliseconds(invalidations.maxNsecs)},
+            {QStringLiteral("comparisons"), invalidations.comparisons},
+            {QStringLiteral("lastComparisons"), invalidations.lastComparisons}
+        });
+    }
+    map.insert(QStringLiteral("comparisons"), m_comparisons);
+    return map;
+}
+
+/*!
+    \qmlmethod object Statistics::sourceDataCalls()
+
+    Returns the number of reads of the source model data done by the model, its filters, sorters and proxy roles,
+    as an object with a property per role name.
+*/
+QVariantMap Statistics::sourceDataCalls() const
+{
+    const QHash<int, QByteArray> roleNames = m_model->roleNames();
+    QVariantMap map;
+    for (auto it = m_sourceDataCalls.cbegin(); it != m_sourceDataCalls.cend(); ++it) {
+        QString roleName = roleNames.contains(it.key()) ? QString::fromUtf8(roleNames.value(it.key())) : QString::number(it.key());
+        map.insert(roleName, it.value());
+    }
+    return map;
+}
+
+/*!
+    \qmlmethod object Statistics::report()
+
+    Returns all the statistics in a single object, with a \c filters, \c sorters, \c proxyRoles, \c invalidations
+    and \c sourceDataCalls property holding the results of the methods of the same name.
+*/
+QVariantMap Statistics::report() const
+{
+    return {
+        {QStringLiteral("filters"), filters()},
+        {QStringLiteral("sorters"), sorters()},
+        {QStringLiteral("proxyRoles"), proxyRoles()},
+        {QStringLiteral("invalidations"), invalidations()},
+        {QStringLiteral("sourceDataCalls"), sourceDataCalls()}
+    };
+}
+
+void Statistics::recordFilter(const QObject* filter, bool accepted, qint64 nsecs)
+{
+    Evaluations& evaluations = m_filters.entry(filter);
+    ++evaluations.count;
+    if (accepted)
+        ++evaluations.accepted;
+    evaluations.totalNsecs += nsecs;
+    evaluations.maxNsecs = qMax(evaluations.maxNsecs, nsecs);
+}
+
+void Statistics::recordSorter(const QObject* sorter, qint64 nsecs)
+{
+    Evaluations& evaluations = m_sorters.entry(sorter);
+    ++evaluations.count;
+    evaluations.totalNsecs += nsecs;
+    evaluations.maxNsecs = qMax(evaluations.maxNsecs, nsecs);
+}
+
+void Statistics::recordProxyRole(const QObject* proxyRole, qint64 nsecs)
+{
+    Evaluations& evaluations = m_proxyRoles.entry(proxyRole);
+    ++evaluations.count;
+    evaluations.totalNsecs += nsecs;
+    evaluations.maxNsecs = qMax(evaluations.maxNsecs, nsecs);
+}
+
+// the statistics of the objects removed from the model are dropped, a new object can be allocated at the same address
+void Statistics::removeFilter(const QObject* filter)
+{
+    m_filters.remove(filter);
+}
+
+void Statistics::removeSorter(const QObject* sorter)
+{
+    m_sorters.remove(sorter);
+}
+
+void Statistics::removeProxyRole(const QObject* proxyRole)
+{
+    m_proxyRoles.remove(proxyRole);
+}
+
+void Statistics::clearFilters()
+{
+    m_filters = EvaluationTable();
+}
+
+void Statistics::clearSorters()
+{
+    m_sorters = EvaluationTable();
+}
+
+void Statistics::clearProxyRoles()
+{
+    m_proxyRoles = EvaluationTable();
+}
+
+void Statistics::recordComparison()
+{
+    ++m_comparisons;
+}
+
+void Statistics::recordSourceData(int role)
+{
+    ++m_sourceDataCalls[role];
+}
+
+void Statistics::recordInvalidation(InvalidationType type, qint64 nsecs, qint64 comparisons)
+{
+    Invalidations& invalidations = m_invalidations[type];
+    ++invalidations.count;
+    invalidations.totalNsecs += nsecs;
+    invalidations.maxNsecs = qMax(invalidations.maxNsecs, nsecs);
+    invalidations.comparisons += comparisons;
+    invalidations.lastComparisons = comparisons;
+}
+
+Statistics::Evaluations& Statistics::EvaluationTable::entry(const QObject* object)
+{
+    auto it = indexes.constFind(object);
+    if (it != indexes.constEnd())
+        return entries[it.value()];
+    indexes.insert(object, entries.size());
+    entries.append(Evaluations());
+    entries.last().name = displayName(object);
+    return entries.last();
+}
+
+void Statistics::EvaluationTable::remove(const QObject* object)
+{
+    auto it = indexes.find(object);
+    if (it == indexes.end())
+        return;
+    const int index = it.value();
+    indexes.erase(it);
+    entries.remove(index);
+    for (auto indexIt = indexes.begin(); indexIt != indexes.end(); ++indexIt) {
+        if (indexIt.value() > index)
+            --indexIt.value();
+    }
+}
+
+QVariantList Statistics::EvaluationTable::toList(bool withSelectivity) const
+{
+    QVariantList list;
+    for (const Evaluations& evaluations : entries) {
+        QVariantMap map {
+            {QStringLiteral("name"), evaluations.name},
+            {QStringLiteral("evaluations"), evaluations.count},
+            {QStringLiteral("totalTime"), milliseconds(evaluations.totalNsecs)},
+            {QStringLiteral("maxTime"), milliseconds(evaluations.maxNsecs)}
+        };
+        if (withSelectivity) {
+            map.insert(QStringLiteral("accepted"), evaluations.accepted);
+            map.insert(QStringLiteral("selectivity"), evaluations.count > 0 ? double(evaluations.accepted) / evaluations.count : 0.0);
+        }
+        list.append(map);
+    }
+    return list;
+}
+
+Statistics::InvalidationRecorder::InvalidationRecorder(Statistics* statistics, InvalidationType type) :
+    m_statistics(statistics->enabled() ? statistics : nullptr),
+    m_type(type)
+{
+    if (m_statistics) {
+        m_comparisons = m_statistics->m_comparisons;
+        m_timer.start();
+    }
+}
+
+Statistics::InvalidationRecorder::~InvalidationRecorder()
+{
+    if (m_statistics)
+        m_statistics->recordInvalidation(m_type, m_timer.nsecsElapsed(), m_statistics->m_comparisons - m_comparisons);
+}
+
+}
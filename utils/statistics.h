@@ -0,0 +1,110 @@
+#ifndef STATISTICS_H
+#define STATISTICS_H
+
+#include <QObject>
+#include <QHash>
+#include <QVector>
+#include <QVariant>
+#include <QElapsedTimer>
+
+class QAbstractItemModel;
+
+namespace qqsfpm {
+
+class Statistics : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(bool enabled READ enabled WRITE setEnabled NOTIFY enabledChanged)
+
+public:
+    enum InvalidationType {
+        FilterInvalidation,
+        SortInvalidation,
+        ProxyRoleInvalidation
+    };
+
+    // times an invalidation of the proxy model from its construction to its destruction
+    class InvalidationRecorder
+    {
+    public:
+        InvalidationRecorder(Statistics* statistics, InvalidationType type);
+        ~InvalidationRecorder();
+
+    private:
+        Statistics* m_statistics;
+        InvalidationType m_type;
+        qint64 m_comparisons = 0;
+        QElapsedTimer m_timer;
+    };
+
+    explicit Statistics(QAbstractItemModel* model);
+
+    // inline as it is checked before each recording, which is all the cost of disabled statistics
+    bool enabled() const { return m_enabled; }
+    void setEnabled(bool enabled);
+
+    Q_INVOKABLE void reset();
+    Q_INVOKABLE QVariantList filters() const;
+    Q_INVOKABLE QVariantList sorters() const;
+    Q_INVOKABLE QVariantList proxyRoles() const;
+    Q_INVOKABLE QVariantMap invalidations() const;
+    Q_INVOKABLE QVariantMap sourceDataCalls() const;
+    Q_INVOKABLE QVariantMap report() const;
+
+    void recordFilter(const QObject* filter, bool accepted, qint64 nsecs);
+    void recordSorter(const QObject* sorter, qint64 nsecs);
+    void recordProxyRole(const QObject* proxyRole, qint64 nsecs);
+    void removeFilter(const QObject* filter);
+    void removeSorter(const QObject* sorter);
+    void removeProxyRole(const QObject* proxyRole);
+    void clearFilters();
+    void clearSorters();
+    void clearProxyRoles();
+    void recordComparison();
+    void recordSourceData(int role);
+
+Q_SIGNALS:
+    void enabledChanged();
+
+private:
+    struct Evaluations {
+        QString name;
+        qint64 count = 0;
+        qint64 accepted = 0;
+        qint64 totalNsecs = 0;
+        qint64 maxNsecs = 0;
+    };
+
+    // the evaluations of each object, in the order they were first recorded
+    struct EvaluationTable {
+        QHash<const QObject*, int> indexes;
+        QVector<Evaluations> entries;
+
+        Evaluations& entry(const QObject* object);
+        void remove(const QObject* object);
+        QVariantList toList(bool withSelectivity) const;
+    };
+
+    struct Invalidations {
+        qint64 count = 0;
+        qint64 totalNsecs = 0;
+        qint64 maxNsecs = 0;
+        qint64 comparisons = 0;
+        qint64 lastComparisons = 0;
+    };
+
+    void recordInvalidation(InvalidationType type, qint64 nsecs, qint64 comparisons);
+
+    QAbstractItemModel* m_model;
+    bool m_enabled = false;
+    EvaluationTable m_filters;
+    EvaluationTable m_sorters;
+    EvaluationTable m_proxyRoles;
+    Invalidations m_invalidations[ProxyRoleInvalidation + 1];
+    qint64 m_comparisons = 0;
+    QHash<int, qint64> m_sourceDataCalls;
+};
+
+}
+
+#endif // STATISTICS_H
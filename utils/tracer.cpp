@@ -0,0 +1,305 @@
+#include "tracer.h"
+#include <QCoreApplication>
+#include <QThread>
+#include <QMutexLocker>
+#include <QMetaMethod>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonDocument>
+#include <QLoggingCategory>
+#include <QFile>
+#include <QHash>
+#include <chrono>
+
+namespace qqsfpm {
+
+namespace {
+
+Q_LOGGING_CATEGORY(lcTrace, "sortfilterproxymodel.trace", QtWarningMsg)
+
+void saveTraceFile()
+{
+    QString fileName = QString::fromLocal8Bit(qgetenv("SFPM_TRACE_FILE"));
+    if (!Tracer::instance()->save(fileName))
+        qWarning("SortFilterProxyModel: could not write the trace to %s", qPrintable(fileName));
+}
+
+}
+
+std::atomic<bool> Tracer::s_enabled(false);
+
+/*!
+    \qmltype Tracer
+    \inqmlmodule SortFilterProxyModel
+    \ingroup SortFilterProxyModel
+    \brief Records what the \l SortFilterProxyModel instances do and why, to be viewed in a trace viewer.
+
+    Tracer is a singleton recording trace events for all the \l SortFilterProxyModel of the application:
+    \list
+    \li the filter, sort and proxy role invalidations, with their cause and their duration,
+        along with the duration of their phases (building sort keys, filtering and sorting, notifying the views)
+    \li the decision taken for each request of invalidation: done immediately, queued for a \l {SortFilterProxyModel::delayed} {delayed} model,
+        or coalesced with an invalidation already queued
+    \li the signals received from the source models
+    \endlist
+
+    The cause of an invalidation is the object and the signal that requested it, like \c {ValueFilter (statusFilter)::invalidated}.
+
+    The events are kept in a ring buffer of \l capacity events and can be exported with \l chromeTrace() or \l save()
+    in the Chrome trace format, readable by \c chrome://tracing or \l {https://ui.perfetto.dev} {Perfetto}.
+    The timestamps come from the monotonic clock, like those of the Qt Quick scene graph and of most system profilers,
+    so the proxy model work can be lined up with the rendering of frames.
+    The events are also logged in the \c sortfilterproxymodel.trace logging category when its debug messages are enabled.
+
+    The tracer can be enabled before the application starts by setting the \c SFPM_TRACE environment variable,
+    its value being the capacity if it's a number. If the \c SFPM_TRACE_FILE environment variable is set too,
+    the trace is saved to that file when the application exits.
+
+    \code
+    import SortFilterProxyModel 0.2
+
+    Button {
+        text: "Save trace"
+        onClicked: Tracer.save("/tmp/sfpm-trace.json")
+    }
+    \endcode
+*/
+Tracer::Tracer()
+{
+    if (qEnvironmentVariableIsSet("SFPM_TRACE")) {
+        bool isNumber = false;
+        int capacity = qEnvironmentVariableIntValue("SFPM_TRACE", &isNumber);
+        if (isNumber && capacity > 0)
+            m_capacity = capacity;
+        s_enabled = true;
+        if (qEnvironmentVariableIsSet("SFPM_TRACE_FILE"))
+            qAddPostRoutine(saveTraceFile);
+    }
+}
+
+Tracer* Tracer::instance()
+{
+    static Tracer tracer;
+    return &tracer;
+}
+
+/*!
+    \qmlproperty bool Tracer::enabled
+
+    This property holds whether events are recorded.
+
+    By default, the tracer is disabled unless the \c SFPM_TRACE environment variable is set.
+*/
+bool Tracer::enabled() const
+{
+    return isEnabled();
+}
+
+void Tracer::setEnabled(bool enabled)
+{
+    if (s_enabled == enabled)
+        return;
+
+    s_enabled = enabled;
+    Q_EMIT enabledChanged();
+}
+
+/*!
+    \qmlproperty int Tracer::capacity
+
+    This property holds the maximum number of events kept, the oldest ones are dropped once it's reached.
+    Changing it clears the events.
+
+    By default, the last 65536 events are kept.
+*/
+int Tracer::capacity() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_capacity;
+}
+
+void Tracer::setCapacity(int capacity)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_capacity == capacity || capacity <= 0)
+            return;
+        m_capacity = capacity;
+        m_events.clear();
+        m_next = 0;
+    }
+    Q_EMIT capacityChanged();
+}
+
+/*!
+    \qmlmethod int Tracer::eventCount()
+
+    Returns the number of events currently kept.
+*/
+int Tracer::eventCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_events.size();
+}
+
+/*!
+    \qmlmethod Tracer::clear()
+
+    Drops all the events recorded so far.
+*/
+void Tracer::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_events.clear();
+    m_next = 0;
+}
+
+/*!
+    \qmlmethod string Tracer::chromeTrace()
+
+    Returns the events recorded so far as a Chrome trace JSON document,
+    with a track per \l SortFilterProxyModel named after its \c objectName.
+*/
+QString Tracer::chromeTrace() const
+{
+    const qint64 pid = QCoreApplication::applicationPid();
+    QHash<QString, int> tracks;
+    QJsonArray traceEvents;
+    for (const Event& event : events()) {
+        int track = tracks.value(event.model, -1);
+        if (track == -1) {
+            track = tracks.size() + 1;
+            tracks.insert(event.model, track);
+            traceEvents.append(QJsonObject {
+                {QStringLiteral("name"), QStringLiteral("thread_name")},
+                {QStringLiteral("ph"), QStringLiteral("M")},
+                {QStringLiteral("pid"), pid},
+                {QStringLiteral("tid"), track},
+                {QStringLiteral("args"), QJsonObject { {QStringLiteral("name"), event.model} }}
+            });
+        }
+
+        QJsonObject args { {QStringLiteral("thread"), event.thread} };
+        if (!event.cause.isEmpty())
+            args.insert(QStringLiteral("cause"), event.cause);
+        if (event.decision)
+            args.insert(QStringLiteral("decision"), QString::fromLatin1(event.decision));
+
+        QJsonObject traceEvent {
+            {QStringLiteral("name"), QString::fromLatin1(event.name)},
+            {QStringLiteral("cat"), QString::fromLatin1(event.category)},
+            {QStringLiteral("ph"), QString(QLatin1Char(event.phase))},
+            {QStringLiteral("ts"), event.timestamp / 1000.0},
+            {QStringLiteral("pid"), pid},
+            {QStringLiteral("tid"), track},
+            {QStringLiteral("args"), args}
+        };
+        if (event.phase == 'X')
+            traceEvent.insert(QStringLiteral("dur"), event.duration / 1000.0);
+        else
+            traceEvent.insert(QStringLiteral("s"), QStringLiteral("t"));
+        traceEvents.append(traceEvent);
+    }
+
+    QJsonObject trace {
+        {QStringLiteral("traceEvents"), traceEvents},
+        {QStringLiteral("displayTimeUnit"), QStringLiteral("ms")}
+    };
+    return QString::fromUtf8(QJsonDocument(trace).toJson(QJsonDocument::Compact));
+}
+
+/*!
+    \qmlmethod bool Tracer::save(string fileName)
+
+    Writes the \l chromeTrace() to the file \a fileName, returns \c false if it could not be written.
+*/
+bool Tracer::save(const QString& fileName) const
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+    return file.write(chromeTrace().toUtf8()) != -1;
+}
+
+void Tracer::instant(const QObject* model, const char* category, const char* name, const QString& cause, const char* decision)
+{
+    if (!isEnabled())
+        return;
+    instance()->append({category, name, decision, 'i', now(), 0, modelLabel(model), cause, 0});
+}
+
+// the object and the signal that caused a call, like "ValueFilter (statusFilter)::invalidated"
+QString Tracer::describe(const QObject* sender, int signalIndex)
+{
+    if (!sender)
+        return QString();
+    const QMetaObject* metaObject = sender->metaObject();
+    // types declared in QML files are subclasses named like Type_QML_12
+    while (metaObject->superClass() && QByteArray(metaObject->className()).contains("_QML_"))
+        metaObject = metaObject->superClass();
+    QString description = QString::fromLatin1(metaObject->className()).remove(QStringLiteral("qqsfpm::"));
+    if (!sender->objectName().isEmpty())
+        description += QStringLiteral(" (%1)").arg(sender->objectName());
+    if (signalIndex >= 0)
+        description += QStringLiteral("::") + QString::fromLatin1(sender->metaObject()->method(signalIndex).name());
+    return description;
+}
+
+qint64 Tracer::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+QString Tracer::modelLabel(const QObject* model)
+{
+    if (!model->objectName().isEmpty())
+        return model->objectName();
+    return QStringLiteral("SortFilterProxyModel 0x%1").arg(reinterpret_cast<quintptr>(model), 0, 16);
+}
+
+void Tracer::append(Event event)
+{
+    event.thread = reinterpret_cast<qint64>(QThread::currentThreadId());
+    qCDebug(lcTrace).noquote() << event.model << event.name << event.cause << (event.decision ? event.decision : "")
+                               << (event.phase == 'X' ? QStringLiteral("%1 ms").arg(event.duration / 1000000.0) : QString());
+
+    QMutexLocker locker(&m_mutex);
+    if (m_events.size() < m_capacity) {
+        m_events.append(event);
+    } else {
+        m_events[m_next] = event;
+        m_next = (m_next + 1) % m_capacity;
+    }
+}
+
+// the events in chronological order, starting from the oldest one still kept
+QVector<Tracer::Event> Tracer::events() const
+{
+    QMutexLocker locker(&m_mutex);
+    QVector<Event> events;
+    events.reserve(m_events.size());
+    for (int i = m_next; i < m_events.size(); ++i)
+        events.append(m_events.at(i));
+    for (int i = 0; i < m_next; ++i)
+        events.append(m_events.at(i));
+    return events;
+}
+
+Tracer::Scope::Scope(const QObject* model, const char* name, const QString& cause) :
+    m_model(isEnabled() ? model : nullptr),
+    m_name(name),
+    m_start(0)
+{
+    if (m_model) {
+        m_cause = cause;
+        m_start = now();
+    }
+}
+
+Tracer::Scope::~Scope()
+{
+    if (m_model)
+        instance()->append({"invalidation", m_name, nullptr, 'X', m_start, now() - m_start, modelLabel(m_model), m_cause, 0});
+}
+
+}
@@ -0,0 +1,84 @@
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <QObject>
+#include <QMutex>
+#include <QVector>
+#include <atomic>
+
+namespace qqsfpm {
+
+class Tracer : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(bool enabled READ enabled WRITE setEnabled NOTIFY enabledChanged)
+    Q_PROPERTY(int capacity READ capacity WRITE setCapacity NOTIFY capacityChanged)
+
+public:
+    // records a complete event from its construction to its destruction
+    class Scope
+    {
+    public:
+        Scope(const QObject* model, const char* name, const QString& cause = QString());
+        ~Scope();
+
+    private:
+        const QObject* m_model;
+        const char* m_name;
+        QString m_cause;
+        qint64 m_start;
+    };
+
+    static Tracer* instance();
+
+    // inline as it is checked before recording each event, which is all the cost of a disabled tracer
+    static bool isEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+    bool enabled() const;
+    void setEnabled(bool enabled);
+
+    int capacity() const;
+    void setCapacity(int capacity);
+
+    Q_INVOKABLE int eventCount() const;
+    Q_INVOKABLE void clear();
+    Q_INVOKABLE QString chromeTrace() const;
+    Q_INVOKABLE bool save(const QString& fileName) const;
+
+    static void instant(const QObject* model, const char* category, const char* name, const QString& cause, const char* decision = nullptr);
+    static QString describe(const QObject* sender, int signalIndex);
+
+Q_SIGNALS:
+    void enabledChanged();
+    void capacityChanged();
+
+private:
+    struct Event {
+        const char* category;
+        const char* name;
+        const char* decision;
+        char phase;
+        qint64 timestamp;
+        qint64 duration;
+        QString model;
+        QString cause;
+        qint64 thread;
+    };
+
+    Tracer();
+
+    static qint64 now();
+    static QString modelLabel(const QObject* model);
+    void append(Event event);
+    QVector<Event> events() const;
+
+    static std::atomic<bool> s_enabled;
+    mutable QMutex m_mutex;
+    QVector<Event> m_events;
+    int m_capacity = 65536;
+    int m_next = 0;
+};
+
+}
+
+#endif // TRACER_H
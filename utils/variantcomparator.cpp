@@ -0,0 +1,159 @@
+#include "variantcomparator.h"
+#include <QDateTime>
+
+namespace qqsfpm {
+
+namespace {
+
+template<typename T>
+int compareValues(const T& left, const T& right)
+{
+    if (left < right)
+        return -1;
+    if (right < left)
+        return 1;
+    return 0;
+}
+
+/*
+    Floating point numbers are ordered exactly, unlike QVariant's fuzzy comparison which isn't transitive,
+    so that sorting and binary searches get a strict weak ordering.
+    NaN is ordered after the other numbers.
+*/
+template<>
+int compareValues<double>(const double& left, const double& right)
+{
+    if (left < right)
+        return -1;
+    if (right < left)
+        return 1;
+    const bool leftNaN = qIsNaN(left);
+    const bool rightNaN = qIsNaN(right);
+    return leftNaN == rightNaN ? 0 : (leftNaN ? 1 : -1);
+}
+
+template<>
+int compareValues<QString>(const QString& left, const QString& right)
+{
+    int comparison = QString::compare(left, right);
+    return comparison < 0 ? -1 : (comparison > 0 ? 1 : 0);
+}
+
+// reads the values in place, the caller has checked that both variants hold a T
+template<typename T>
+int compareAs(const QVariant& left, const QVariant& right)
+{
+    return compareValues(*static_cast<const T*>(left.constData()), *static_cast<const T*>(right.constData()));
+}
+
+}
+
+/*
+    Compares two QVariants like QVariant's comparison operators do,
+    but without inspecting and converting their types on each call when they hold the same common type.
+
+    The type of the left value is remembered with the matching comparison function,
+    so comparing many values of the same type (like the data of a role) only costs an integer comparison and an indirect call.
+    Values of different or unsupported types fall back to QVariant's comparison operators.
+*/
+int VariantComparator::compare(const QVariant& left, const QVariant& right) const
+{
+    const int type = left.userType();
+    if (type != m_type) {
+        m_type = type;
+        m_compare = compareFunction(type);
+    }
+    if (m_compare && right.userType() == type)
+        return m_compare(left, right);
+    return genericCompare(left, right);
+}
+
+/*
+    Compares a value to a bound like compare(), except that floating point numbers fuzzily equal to the bound are equal to it,
+    like with QVariant's comparison. Only the bounds of a range are compared fuzzily, see fuzzyEquals().
+*/
+int VariantComparator::compareToBound(const QVariant& value, const QVariant& bound) const
+{
+    const int comparison = compare(value, bound);
+    return comparison != 0 && fuzzyEquals(value, bound) ? 0 : comparison;
+}
+
+bool VariantComparator::fuzzyEquals(const QVariant& left, const QVariant& right)
+{
+    return left.userType() == QMetaType::Double && right.userType() == QMetaType::Double
+            && qFuzzyCompare(*static_cast<const double*>(left.constData()), *static_cast<const double*>(right.constData()));
+}
+
+/*
+    Compares two values of the same supported type, or two numbers of any type, without QVariant's comparison operators.
+    Returns false if they aren't such values, their order is then unknown.
+*/
+bool VariantComparator::strictCompare(const QVariant& left, const QVariant& right, int& comparison)
+{
+    const int type = left.userType();
+    if (type == right.userType()) {
+        if (CompareFunction compare = compareFunction(type)) {
+            comparison = compare(left, right);
+            return true;
+        }
+        return false;
+    }
+    auto isNumber = [] (int numberType) {
+        return numberType == QMetaType::Int || numberType == QMetaType::UInt || numberType == QMetaType::LongLong
+                || numberType == QMetaType::ULongLong || numberType == QMetaType::Double || numberType == QMetaType::Float;
+    };
+    if (!isNumber(type) || !isNumber(right.userType()))
+        return false;
+    comparison = compareValues(left.toDouble(), right.toDouble());
+    return true;
+}
+
+/*
+    Returns value converted to type if this can be done without changing how it compares to other values,
+    or value unchanged otherwise. This is used to convert constant operands, like filter bounds, once to the type of the data.
+*/
+QVariant VariantComparator::convertedValue(const QVariant& value, int type)
+{
+    if (!value.isValid() || value.userType() == type || !compareFunction(type))
+        return value;
+
+    QVariant converted = value;
+    if (converted.convert(type) && converted == value)
+        return converted;
+    return value;
+}
+
+VariantComparator::CompareFunction VariantComparator::compareFunction(int type)
+{
+    switch (type) {
+    case QMetaType::Int:
+        return &compareAs<int>;
+    case QMetaType::UInt:
+        return &compareAs<uint>;
+    case QMetaType::LongLong:
+        return &compareAs<qlonglong>;
+    case QMetaType::ULongLong:
+        return &compareAs<qulonglong>;
+    case QMetaType::Double:
+        return &compareAs<double>;
+    case QMetaType::Bool:
+        return &compareAs<bool>;
+    case QMetaType::QString:
+        return &compareAs<QString>;
+    case QMetaType::QDateTime:
+        return &compareAs<QDateTime>;
+    default:
+        return nullptr;
+    }
+}
+
+int VariantComparator::genericCompare(const QVariant& left, const QVariant& right)
+{
+    if (left < right)
+        return -1;
+    if (left > right)
+        return 1;
+    return 0;
+}
+
+}
@@ -0,0 +1,31 @@
+#ifndef VARIANTCOMPARATOR_H
+#define VARIANTCOMPARATOR_H
+
+#include <QVariant>
+
+namespace qqsfpm {
+
+class VariantComparator
+{
+public:
+    int compare(const QVariant& left, const QVariant& right) const;
+    int compareToBound(const QVariant& value, const QVariant& bound) const;
+
+    static bool fuzzyEquals(const QVariant& left, const QVariant& right);
+    static bool strictCompare(const QVariant& left, const QVariant& right, int& comparison);
+
+    static QVariant convertedValue(const QVariant& value, int type);
+
+private:
+    using CompareFunction = int (*)(const QVariant& left, const QVariant& right);
+
+    static CompareFunction compareFunction(int type);
+    static int genericCompare(const QVariant& left, const QVariant& right);
+
+    mutable int m_type = QMetaType::UnknownType;
+    mutable CompareFunction m_compare = nullptr;
+};
+
+}
+
+#endif // VARIANTCOMPARATOR_H
@@ -0,0 +1,478 @@
+#include "workloadrecorder.h"
+#include "qqmlsortfilterproxymodel.h"
+#include "filters/filter.h"
+#include "sorters/sorter.h"
+#include "proxyroles/proxyrole.h"
+#include "plan.h"
+#include <QMetaProperty>
+#include <QJSValue>
+#include <algorithm>
+
+namespace qqsfpm {
+
+namespace {
+
+// object properties, lists and scripts (like the expressions) can't be written to a file
+bool isRecordable(const QMetaProperty& property)
+{
+    if (!property.isReadable() || !property.isWritable())
+        return false;
+    if (property.isEnumType())
+        return true;
+    const int type = property.userType();
+    return type < QMetaType::User && type != QMetaType::QObjectStar && type != QMetaType::VoidStar;
+}
+
+QString childPath(const QString& path, const QString& child)
+{
+    return path.isEmpty() ? child : path + QLatin1Char('/') + child;
+}
+
+}
+
+const QByteArray WorkloadRecorder::Magic = QByteArrayLiteral("SFPMWORKLOAD1");
+
+/*!
+    \qmltype WorkloadRecorder
+    \inqmlmodule SortFilterProxyModel
+    \ingroup SortFilterProxyModel
+    \brief Records the workload of a \l SortFilterProxyModel to a file, to be replayed away from the application.
+
+    A WorkloadRecorder writes to \l fileName everything needed to reproduce the work done by a \l SortFilterProxyModel:
+    \list
+    \li its configuration: the types and properties of the model, its filters, sorters and proxy roles
+    \li the contents of its source model, when the recording starts and when the source model is reset
+    \li the changes of the source model: inserted, removed and moved rows, changed data, and the rows rearranged by a layout change
+    \li the changes of the properties of the model, its filters, sorters and proxy roles
+    \endlist
+
+    Every record is timestamped, so the workload can be replayed at full speed or in real time
+    with the \c sfpm-replay tool of the \c tests/replay directory.
+
+    Only values that can be stored are recorded: the expressions of the expression based types, the attached properties
+    and the properties referencing other objects are not. Filters, sorters and proxy roles added after the start of the recording
+    are not recorded either.
+
+    \code
+    SortFilterProxyModel {
+        id: contactsProxyModel
+        sourceModel: contactModel
+        filters: RegExpFilter { roleName: "name"; pattern: searchField.text }
+    }
+
+    WorkloadRecorder {
+        model: contactsProxyModel
+        fileName: "/tmp/contacts.sfpmworkload"
+        recording: recordCheckBox.checked
+    }
+    \endcode
+*/
+WorkloadRecorder::WorkloadRecorder(QObject* parent) : QObject(parent)
+{
+}
+
+WorkloadRecorder::~WorkloadRecorder()
+{
+    stop();
+}
+
+/*!
+    \qmlproperty SortFilterProxyModel WorkloadRecorder::model
+
+    This property holds the model whose workload is recorded.
+*/
+QQmlSortFilterProxyModel* WorkloadRecorder::model() const
+{
+    return m_model;
+}
+
+void WorkloadRecorder::setModel(QQmlSortFilterProxyModel* model)
+{
+    if (m_model == model)
+        return;
+
+    bool recording = m_recording;
+    setRecording(false);
+    m_model = model;
+    Q_EMIT modelChanged();
+    setRecording(recording);
+}
+
+/*!
+    \qmlproperty string WorkloadRecorder::fileName
+
+    This property holds the path of the file the workload is written to. It is overwritten when a recording starts.
+*/
+const QString& WorkloadRecorder::fileName() const
+{
+    return m_fileName;
+}
+
+void WorkloadRecorder::setFileName(const QString& fileName)
+{
+    if (m_fileName == fileName)
+        return;
+
+    bool recording = m_recording;
+    setRecording(false);
+    m_fileName = fileName;
+    Q_EMIT fileNameChanged();
+    setRecording(recording);
+}
+
+/*!
+    \qmlproperty bool WorkloadRecorder::recording
+
+    This property holds whether the workload is being recorded.
+    It stays \c false if the file can't be written or if no model is set.
+
+    By default, nothing is recorded.
+*/
+bool WorkloadRecorder::recording() const
+{
+    return m_recording;
+}
+
+void WorkloadRecorder::setRecording(bool recording)
+{
+    if (m_recording == recording)
+        return;
+
+    // in QML, the recording starts once all the properties are set
+    if (m_completed) {
+        if (recording) {
+            if (!start())
+                return;
+        } else {
+            stop();
+        }
+    }
+    m_recording = recording;
+    Q_EMIT recordingChanged();
+}
+
+void WorkloadRecorder::classBegin()
+{
+    m_completed = false;
+}
+
+void WorkloadRecorder::componentComplete()
+{
+    m_completed = true;
+    if (m_recording && !start()) {
+        m_recording = false;
+        Q_EMIT recordingChanged();
+    }
+}
+
+// the filters, sorters and proxy roles of an object, with their path relative to it, like "filters/0"
+QList<QPair<QString, QObject*>> WorkloadRecorder::children(QObject* object)
+{
+    QList<QPair<QString, QObject*>> children;
+    if (FilterContainer* container = qobject_cast<FilterContainer*>(object)) {
+        const QList<Filter*> filters = container->filters();
+        for (int i = 0; i < filters.size(); ++i)
+            children.append({QStringLiteral("filters/%1").arg(i), filters.at(i)});
+    }
+    if (SorterContainer* container = qobject_cast<SorterContainer*>(object)) {
+        const QList<Sorter*> sorters = container->sorters();
+        for (int i = 0; i < sorters.size(); ++i)
+            children.append({QStringLiteral("sorters/%1").arg(i), sorters.at(i)});
+    }
+    if (ProxyRoleContainer* container = qobject_cast<ProxyRoleContainer*>(object)) {
+        const QList<ProxyRole*> proxyRoles = container->proxyRoles();
+        for (int i = 0; i < proxyRoles.size(); ++i)
+            children.append({QStringLiteral("proxyRoles/%1").arg(i), proxyRoles.at(i)});
+    }
+    return children;
+}
+
+QObject* WorkloadRecorder::objectAt(QObject* root, const QString& path)
+{
+    QObject* object = root;
+    const QStringList segments = path.split(QLatin1Char('/'), QString::SkipEmptyParts);
+    for (int i = 0; object && i + 1 < segments.size(); i += 2) {
+        const QString child = segments.at(i) + QLatin1Char('/') + segments.at(i + 1);
+        QObject* found = nullptr;
+        for (const auto& pair : children(object)) {
+            if (pair.first == child)
+                found = pair.second;
+        }
+        object = found;
+    }
+    return object;
+}
+
+void WorkloadRecorder::onPropertyChanged()
+{
+    auto it = m_watchedObjects.constFind(sender());
+    if (it == m_watchedObjects.constEnd())
+        return;
+
+    const QMetaObject* metaObject = sender()->metaObject();
+    for (int propertyIndex : it->properties.values(senderSignalIndex())) {
+        QMetaProperty property = metaObject->property(propertyIndex);
+        QVariant value = property.read(sender());
+        beginRecord(PropertyRecord);
+        m_stream << it->path << QString::fromLatin1(property.name())
+                 << (property.isEnumType() ? QVariant(value.toInt()) : recordableValue(value));
+    }
+}
+
+void WorkloadRecorder::onSourceModelChanged()
+{
+    for (const auto& connection : m_sourceConnections)
+        disconnect(connection);
+    m_sourceConnections.clear();
+
+    QAbstractItemModel* sourceModel = m_model->sourceModel();
+    if (sourceModel) {
+        m_sourceConnections = {
+            connect(sourceModel, &QAbstractItemModel::rowsInserted, this, &WorkloadRecorder::onRowsInserted),
+            connect(sourceModel, &QAbstractItemModel::rowsRemoved, this, &WorkloadRecorder::onRowsRemoved),
+            connect(sourceModel, &QAbstractItemModel::rowsMoved, this, &WorkloadRecorder::onRowsMoved),
+            connect(sourceModel, &QAbstractItemModel::dataChanged, this, &WorkloadRecorder::onDataChanged),
+            connect(sourceModel, &QAbstractItemModel::layoutAboutToBeChanged, this, &WorkloadRecorder::onLayoutAboutToBeChanged),
+            connect(sourceModel, &QAbstractItemModel::layoutChanged, this, &WorkloadRecorder::onLayoutChanged),
+            connect(sourceModel, &QAbstractItemModel::modelReset, this, &WorkloadRecorder::onModelReset)
+        };
+    }
+    writeSnapshot();
+}
+
+void WorkloadRecorder::onRowsInserted(const QModelIndex& parent, int first, int last)
+{
+    if (parent.isValid())
+        return;
+    beginRecord(RowsInsertedRecord);
+    m_stream << first << rows(first, last, m_roles);
+}
+
+void WorkloadRecorder::onRowsRemoved(const QModelIndex& parent, int first, int last)
+{
+    if (parent.isValid())
+        return;
+    beginRecord(RowsRemovedRecord);
+    m_stream << first << last;
+}
+
+void WorkloadRecorder::onRowsMoved(const QModelIndex& parent, int first, int last, const QModelIndex& destination, int row)
+{
+    if (parent.isValid() || destination.isValid())
+        return;
+    beginRecord(RowsMovedRecord);
+    m_stream << first << last << row;
+}
+
+void WorkloadRecorder::onDataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight, const QVector<int>& roles)
+{
+    if (topLeft.parent().isValid())
+        return;
+
+    QVector<int> changedRoles;
+    for (int role : m_roles) {
+        if (roles.isEmpty() || roles.contains(role))
+            changedRoles.append(role);
+    }
+    if (changedRoles.isEmpty())
+        return;
+
+    const QHash<int, QByteArray> roleNames = m_model->sourceModel()->roleNames();
+    QStringList changedRoleNames;
+    for (int role : changedRoles)
+        changedRoleNames.append(QString::fromUtf8(roleNames.value(role)));
+    beginRecord(DataChangedRecord);
+    m_stream << topLeft.row() << changedRoleNames << rows(topLeft.row(), bottomRight.row(), changedRoles);
+}
+
+void WorkloadRecorder::onLayoutAboutToBeChanged()
+{
+    QAbstractItemModel* sourceModel = m_model->sourceModel();
+    const int rowCount = sourceModel->rowCount();
+    m_layoutRows.clear();
+    m_layoutRows.reserve(rowCount);
+    for (int row = 0; row < rowCount; ++row)
+        m_layoutRows.append(sourceModel->index(row, 0));
+}
+
+/*
+    Records the permutation of the rows, found with the persistent indexes of the rows before the change.
+    A layout change that doesn't only move the rows, removing some or changing their number, is recorded as a snapshot.
+*/
+void WorkloadRecorder::onLayoutChanged()
+{
+    QVector<QPersistentModelIndex> layoutRows;
+    layoutRows.swap(m_layoutRows);
+    const int rowCount = m_model->sourceModel()->rowCount();
+    if (layoutRows.size() != rowCount) {
+        writeSnapshot();
+        return;
+    }
+
+    QVector<int> previousRows(rowCount, -1);
+    bool moved = false;
+    for (int row = 0; row < rowCount; ++row) {
+        const QPersistentModelIndex& index = layoutRows.at(row);
+        if (!index.isValid() || index.parent().isValid() || previousRows.at(index.row()) != -1) {
+            writeSnapshot();
+            return;
+        }
+        previousRows[index.row()] = row;
+        moved = moved || index.row() != row;
+    }
+    if (!moved)
+        return;
+    beginRecord(LayoutChangedRecord);
+    m_stream << previousRows;
+}
+
+void WorkloadRecorder::onModelReset()
+{
+    writeSnapshot();
+}
+
+bool WorkloadRecorder::start()
+{
+    if (!m_model || m_fileName.isEmpty())
+        return false;
+
+    m_file.setFileName(m_fileName);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning("WorkloadRecorder: could not open %s: %s", qPrintable(m_fileName), qPrintable(m_file.errorString()));
+        return false;
+    }
+    m_stream.setDevice(&m_file);
+    m_stream.setVersion(StreamVersion);
+    m_stream.writeRawData(Magic.constData(), Magic.size());
+    m_timer.start();
+
+    beginRecord(ConfigurationRecord);
+    m_stream << configuration(m_model, QString());
+
+    m_connections << connect(m_model, &QAbstractProxyModel::sourceModelChanged, this, &WorkloadRecorder::onSourceModelChanged);
+    onSourceModelChanged();
+    return true;
+}
+
+void WorkloadRecorder::stop()
+{
+    for (const auto& connection : m_connections)
+        disconnect(connection);
+    m_connections.clear();
+    for (const auto& connection : m_sourceConnections)
+        disconnect(connection);
+    m_sourceConnections.clear();
+    m_watchedObjects.clear();
+    m_roles.clear();
+    m_layoutRows.clear();
+    m_stream.setDevice(nullptr);
+    m_file.close();
+}
+
+void WorkloadRecorder::beginRecord(RecordType type)
+{
+    m_stream << static_cast<quint8>(type) << static_cast<qint64>(m_timer.nsecsElapsed());
+}
+
+/*
+    Describes an object and its filters, sorters and proxy roles, with a map holding its QML type name,
+    its recordable properties and a list for each of its filters, sorters and proxyRoles list properties.
+    The notifiable properties are watched as well.
+*/
+QVariantMap WorkloadRecorder::configuration(QObject* object, const QString& path)
+{
+    WatchedObject& watchedObject = m_watchedObjects[object];
+    watchedObject.path = path;
+    const int slotIndex = metaObject()->indexOfSlot("onPropertyChanged()");
+
+    QVariantMap properties;
+    const QMetaObject* metaObject = object->metaObject();
+    for (int i = 0; i < metaObject->propertyCount(); ++i) {
+        QMetaProperty property = metaObject->property(i);
+        if (!isRecordable(property))
+            continue;
+        QVariant value = property.read(object);
+        properties.insert(QString::fromLatin1(property.name()), property.isEnumType() ? QVariant(value.toInt()) : recordableValue(value));
+        if (property.hasNotifySignal()) {
+            const int signalIndex = property.notifySignalIndex();
+            if (!watchedObject.properties.contains(signalIndex))
+                m_connections << QMetaObject::connect(object, signalIndex, this, slotIndex);
+            watchedObject.properties.insert(signalIndex, i);
+        }
+    }
+    m_connections << connect(object, &QObject::destroyed, this, [this, object] {
+        m_watchedObjects.remove(object);
+    });
+
+    QVariantMap node {
+        {QStringLiteral("type"), Plan::qmlTypeName(object)},
+        {QStringLiteral("properties"), properties}
+    };
+    for (const auto& child : children(object)) {
+        const QString listName = child.first.section(QLatin1Char('/'), 0, 0);
+        QVariantList list = node.value(listName).toList();
+        list.append(configuration(child.second, childPath(path, child.first)));
+        node.insert(listName, list);
+    }
+    return node;
+}
+
+void WorkloadRecorder::writeSnapshot()
+{
+    m_roles.clear();
+    QStringList roleNames;
+    QVariantList allRows;
+    if (QAbstractItemModel* sourceModel = m_model->sourceModel()) {
+        const QHash<int, QByteArray> sourceRoleNames = sourceModel->roleNames();
+        m_roles = sourceRoleNames.keys().toVector();
+        std::sort(m_roles.begin(), m_roles.end());
+        for (int role : m_roles)
+            roleNames.append(QString::fromUtf8(sourceRoleNames.value(role)));
+        allRows = rows(0, sourceModel->rowCount() - 1, m_roles);
+    }
+    beginRecord(SnapshotRecord);
+    m_stream << roleNames << allRows;
+}
+
+QVariantList WorkloadRecorder::rows(int first, int last, const QVector<int>& roles) const
+{
+    QAbstractItemModel* sourceModel = m_model->sourceModel();
+    QVariantList recordedRows;
+    recordedRows.reserve(last - first + 1);
+    for (int row = first; row <= last; ++row) {
+        const QModelIndex index = sourceModel->index(row, 0);
+        QVariantList values;
+        values.reserve(roles.size());
+        for (int role : roles)
+            values.append(recordableValue(sourceModel->data(index, role)));
+        recordedRows.append(QVariant(values));
+    }
+    return recordedRows;
+}
+
+// converts the values that QDataStream can't write, like JavaScript values, or drops them
+QVariant WorkloadRecorder::recordableValue(const QVariant& value)
+{
+    const int type = value.userType();
+    if (type == qMetaTypeId<QJSValue>())
+        return recordableValue(value.value<QJSValue>().toVariant());
+    if (type == QMetaType::QVariantList) {
+        QVariantList list;
+        for (const QVariant& item : value.toList())
+            list.append(recordableValue(item));
+        return list;
+    }
+    if (type == QMetaType::QVariantMap) {
+        QVariantMap map = value.toMap();
+        for (auto it = map.begin(); it != map.end(); ++it)
+            it.value() = recordableValue(it.value());
+        return map;
+    }
+    if (type < QMetaType::User && type != QMetaType::QObjectStar && type != QMetaType::VoidStar)
+        return value;
+    if (value.canConvert<QString>())
+        return value.toString();
+    return QVariant();
+}
+
+}
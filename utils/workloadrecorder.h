@@ -0,0 +1,108 @@
+#ifndef WORKLOADRECORDER_H
+#define WORKLOADRECORDER_H
+
+#include <QObject>
+#include <QQmlParserStatus>
+#include <QPointer>
+#include <QFile>
+#include <QDataStream>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QVariant>
+#include <QPersistentModelIndex>
+
+namespace qqsfpm {
+
+class QQmlSortFilterProxyModel;
+
+class WorkloadRecorder : public QObject, public QQmlParserStatus
+{
+    Q_OBJECT
+    Q_INTERFACES(QQmlParserStatus)
+    Q_PROPERTY(qqsfpm::QQmlSortFilterProxyModel* model READ model WRITE setModel NOTIFY modelChanged)
+    Q_PROPERTY(QString fileName READ fileName WRITE setFileName NOTIFY fileNameChanged)
+    Q_PROPERTY(bool recording READ recording WRITE setRecording NOTIFY recordingChanged)
+
+public:
+    // the records of a workload file, each one starts with its type and its timestamp in nanoseconds
+    enum RecordType : quint8 {
+        ConfigurationRecord,  // QVariantMap: the tree of the proxy model, its filters, sorters and proxy roles
+        SnapshotRecord,       // QStringList role names, QVariantList rows: the whole source model, at the start, on resets and unknown layout changes
+        PropertyRecord,       // QString object path, QString property name, QVariant value
+        RowsInsertedRecord,   // int first row, QVariantList rows
+        RowsRemovedRecord,    // int first row, int last row
+        RowsMovedRecord,      // int first row, int last row, int destination row
+        DataChangedRecord,    // int first row, QStringList role names, QVariantList rows
+        LayoutChangedRecord   // QVector<int> the previous row of each row, after the rows were rearranged
+    };
+
+    static const QByteArray Magic;
+    static const int StreamVersion = QDataStream::Qt_5_6;
+
+    explicit WorkloadRecorder(QObject* parent = nullptr);
+    ~WorkloadRecorder();
+
+    QQmlSortFilterProxyModel* model() const;
+    void setModel(QQmlSortFilterProxyModel* model);
+
+    const QString& fileName() const;
+    void setFileName(const QString& fileName);
+
+    bool recording() const;
+    void setRecording(bool recording);
+
+    void classBegin() override;
+    void componentComplete() override;
+
+    static QList<QPair<QString, QObject*>> children(QObject* object);
+    static QObject* objectAt(QObject* root, const QString& path);
+
+Q_SIGNALS:
+    void modelChanged();
+    void fileNameChanged();
+    void recordingChanged();
+
+private Q_SLOTS:
+    void onPropertyChanged();
+    void onSourceModelChanged();
+    void onRowsInserted(const QModelIndex& parent, int first, int last);
+    void onRowsRemoved(const QModelIndex& parent, int first, int last);
+    void onRowsMoved(const QModelIndex& parent, int first, int last, const QModelIndex& destination, int row);
+    void onDataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight, const QVector<int>& roles);
+    void onLayoutAboutToBeChanged();
+    void onLayoutChanged();
+    void onModelReset();
+
+private:
+    struct WatchedObject {
+        QString path;
+        QMultiHash<int, int> properties; // notify signal index -> property index
+    };
+
+    bool start();
+    void stop();
+    void beginRecord(RecordType type);
+    QVariantMap configuration(QObject* object, const QString& path);
+    void writeSnapshot();
+    QVariantList rows(int first, int last, const QVector<int>& roles) const;
+    static QVariant recordableValue(const QVariant& value);
+
+    QPointer<QQmlSortFilterProxyModel> m_model;
+    QString m_fileName;
+    bool m_recording = false;
+    bool m_completed = true;
+
+    QFile m_file;
+    QDataStream m_stream;
+    QElapsedTimer m_timer;
+    QHash<QObject*, WatchedObject> m_watchedObjects;
+    QList<QMetaObject::Connection> m_connections;
+    QList<QMetaObject::Connection> m_sourceConnections;
+    QVector<int> m_roles;
+    // the rows before a layout change, to record where they moved
+    QVector<QPersistentModelIndex> m_layoutRows;
+};
+
+}
+
+#endif // WORKLOADRECORDER_H